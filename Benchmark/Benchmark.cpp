@@ -0,0 +1,210 @@
+/**
+ * \file Benchmark.cpp
+ *
+ * \author Morgan Mundell
+ */
+
+#include "pch.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include "Benchmark.h"
+
+using namespace std;
+
+/// Most iterations a run will be grown to
+const long long MaxIterations = 1LL << 30;
+
+/**
+ * Start counting time
+ */
+void CBenchmarkRun::StartTiming()
+{
+    mTime = 0;
+    ResumeTiming();
+}
+
+/**
+ * Stop counting time until ResumeTiming
+ */
+void CBenchmarkRun::PauseTiming()
+{
+    if (mRunning)
+    {
+        mTime += chrono::duration<double>(chrono::steady_clock::now() - mStart).count();
+        mRunning = false;
+    }
+}
+
+/**
+ * Count time again after PauseTiming
+ */
+void CBenchmarkRun::ResumeTiming()
+{
+    if (!mRunning)
+    {
+        mStart = chrono::steady_clock::now();
+        mRunning = true;
+    }
+}
+
+/**
+ * Add a case
+ * @param name Name of the case, with any parameters after a slash
+ * @param benchmark The work the case does
+ */
+void CBenchmark::Add(const string& name, Case benchmark)
+{
+    mCases.push_back(make_pair(name, benchmark));
+}
+
+/**
+ * Time every case that matches the filter, printing progress as it goes
+ * @returns The results
+ */
+const vector<CBenchmark::Result>& CBenchmark::Run()
+{
+    mResults.clear();
+    for (auto& benchmark : mCases)
+    {
+        if (benchmark.first.find(mFilter) == string::npos)
+        {
+            continue;
+        }
+
+        auto result = Time(benchmark.first, benchmark.second);
+        fprintf(stderr, "%-44s %14.1f ns %12lld iterations\n",
+            result.mName.c_str(), result.mTime, result.mIterations);
+        mResults.push_back(result);
+    }
+
+    return mResults;
+}
+
+/**
+ * Time one case
+ * @param name Name of the case
+ * @param benchmark The work the case does
+ * @returns Result
+ */
+CBenchmark::Result CBenchmark::Time(const string& name, Case& benchmark)
+{
+    // Grow the iterations until a run is long enough to time reliably
+    long long iterations = 1;
+    for (;;)
+    {
+        CBenchmarkRun run(iterations);
+        run.StartTiming();
+        benchmark(run);
+        run.PauseTiming();
+
+        if (run.GetTime() >= mMinTime || iterations >= MaxIterations)
+        {
+            break;
+        }
+
+        // Aim a little past the minimum so the next run is likely enough
+        double scale = run.GetTime() > 0 ? mMinTime * 1.4 / run.GetTime() : 10;
+        iterations = min(MaxIterations, max(iterations + 1, (long long)(iterations * min(scale, 10.0))));
+    }
+
+    vector<double> times;
+    for (int i = 0; i < Repetitions; i++)
+    {
+        CBenchmarkRun run(iterations);
+        run.StartTiming();
+        benchmark(run);
+        run.PauseTiming();
+        times.push_back(run.GetTime() * 1e9 / iterations);
+    }
+
+    sort(times.begin(), times.end());
+
+    Result result;
+    result.mName = name;
+    result.mTime = times[times.size() / 2];
+    result.mMinTime = times.front();
+    result.mMaxTime = times.back();
+    result.mIterations = iterations;
+    return result;
+}
+
+/**
+ * The results of the last Run as JSON
+ * @returns JSON text
+ */
+string CBenchmark::ToJson() const
+{
+    string json = "{\"benchmarks\":[\n";
+    char line[512];
+    for (size_t i = 0; i < mResults.size(); i++)
+    {
+        auto& result = mResults[i];
+        snprintf(line, sizeof(line),
+            "{\"name\":\"%s\",\"ns_per_op\":%.3f,\"min_ns\":%.3f,\"max_ns\":%.3f,\"iterations\":%lld}%s\n",
+            result.mName.c_str(), result.mTime, result.mMinTime, result.mMaxTime, result.mIterations,
+            i + 1 < mResults.size() ? "," : "");
+        json += line;
+    }
+    json += "]}\n";
+    return json;
+}
+
+/**
+ * Read the times out of JSON written by ToJson
+ * @param json JSON text
+ * @param times Receives the time per iteration in nanoseconds of each case by name
+ * @returns False if no results were found
+ */
+bool CBenchmark::ReadJson(const string& json, map<string, double>& times)
+{
+    const string nameKey = "\"name\":\"";
+    const string timeKey = "\"ns_per_op\":";
+
+    size_t pos = 0;
+    while ((pos = json.find(nameKey, pos)) != string::npos)
+    {
+        size_t start = pos + nameKey.size();
+        size_t end = json.find('"', start);
+        size_t time = json.find(timeKey, start);
+        if (end == string::npos || time == string::npos)
+        {
+            break;
+        }
+
+        times[json.substr(start, end - start)] = atof(json.c_str() + time + timeKey.size());
+        pos = time;
+    }
+
+    return !times.empty();
+}
+
+/**
+ * Print the last results next to a baseline
+ * @param baseline Time per iteration in nanoseconds of each case by name
+ * @param threshold Fraction slower than the baseline that counts as a regression
+ * @returns True if no case got slower by more than the threshold
+ */
+bool CBenchmark::Compare(const map<string, double>& baseline, double threshold) const
+{
+    bool ok = true;
+    printf("%-44s %14s %14s %9s\n", "case", "baseline ns", "current ns", "change");
+    for (auto& result : mResults)
+    {
+        auto found = baseline.find(result.mName);
+        if (found == baseline.end() || found->second <= 0)
+        {
+            printf("%-44s %14s %14.1f %9s\n", result.mName.c_str(), "-", result.mTime, "new");
+            continue;
+        }
+
+        double change = result.mTime / found->second - 1;
+        bool regressed = change > threshold;
+        ok = ok && !regressed;
+
+        printf("%-44s %14.1f %14.1f %+8.1f%%%s\n", result.mName.c_str(), found->second, result.mTime,
+            change * 100, regressed ? "  SLOWER" : (change < -threshold ? "  faster" : ""));
+    }
+
+    return ok;
+}
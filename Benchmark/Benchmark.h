@@ -0,0 +1,138 @@
+/**
+ * \file Benchmark.h
+ *
+ * \author Morgan Mundell
+ *
+ *  Small harness for timing the game's hot paths
+ */
+
+#pragma once
+
+#include <chrono>
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+/**
+ * One timed run of a benchmark case.
+ *
+ * The case runs its operation GetIterations() times. Work that
+ * should not be counted, like undoing what the operation changed,
+ * goes between PauseTiming and ResumeTiming.
+ */
+class CBenchmarkRun
+{
+public:
+    /**
+     * Constructor
+     * @param iterations Number of times to run the operation
+     */
+    CBenchmarkRun(long long iterations) : mIterations(iterations) {}
+
+    /**
+     * Number of times the case should run its operation
+     * @returns Iteration count
+     */
+    long long GetIterations() const { return mIterations; }
+
+    void StartTiming();
+
+    void PauseTiming();
+
+    void ResumeTiming();
+
+    /**
+     * Time counted so far
+     * @returns Time in seconds
+     */
+    double GetTime() const { return mTime; }
+
+private:
+    /// Number of times to run the operation
+    long long mIterations;
+
+    /// Time counted so far in seconds
+    double mTime = 0;
+
+    /// True while time is being counted
+    bool mRunning = false;
+
+    /// When counting last started
+    std::chrono::steady_clock::time_point mStart;
+};
+
+/**
+ * Runs benchmark cases and reports their times.
+ *
+ * Each case is run with more and more iterations until one run
+ * takes at least the minimum time, then timed several more times
+ * with that count. The median time per iteration is reported.
+ * Results are written as JSON with one case per line, which is
+ * also the format Compare reads back as a baseline.
+ */
+class CBenchmark
+{
+public:
+    /// The work a case does for one run
+    typedef std::function<void(CBenchmarkRun& run)> Case;
+
+    /// Result of timing one case
+    struct Result
+    {
+        /// Name of the case, including its parameters
+        std::string mName;
+
+        /// Median time of one iteration in nanoseconds
+        double mTime = 0;
+
+        /// Fastest run's time of one iteration in nanoseconds
+        double mMinTime = 0;
+
+        /// Slowest run's time of one iteration in nanoseconds
+        double mMaxTime = 0;
+
+        /// Iterations in each run
+        long long mIterations = 0;
+    };
+
+    /// Runs timed for each case once the iteration count is found
+    static const int Repetitions = 5;
+
+    void Add(const std::string& name, Case benchmark);
+
+    /**
+     * Only run cases whose name contains this text
+     * @param filter Text to look for, empty to run everything
+     */
+    void SetFilter(const std::string& filter) { mFilter = filter; }
+
+    /**
+     * Set the shortest time a timed run may take
+     * @param seconds Minimum time in seconds
+     */
+    void SetMinTime(double seconds) { mMinTime = seconds; }
+
+    const std::vector<Result>& Run();
+
+    std::string ToJson() const;
+
+    static bool ReadJson(const std::string& json, std::map<std::string, double>& times);
+
+    bool Compare(const std::map<std::string, double>& baseline, double threshold) const;
+
+private:
+    Result Time(const std::string& name, Case& benchmark);
+
+    /// The cases in the order they were added
+    std::vector<std::pair<std::string, Case>> mCases;
+
+    /// Results of the last Run
+    std::vector<Result> mResults;
+
+    /// Only run cases containing this text
+    std::string mFilter;
+
+    /// Shortest time a timed run may take in seconds
+    double mMinTime = 0.1;
+};
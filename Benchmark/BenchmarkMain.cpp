@@ -0,0 +1,511 @@
+/**
+ * \file BenchmarkMain.cpp
+ *
+ * \author Morgan Mundell
+ *
+ *  Benchmark cases for the game's hot paths
+ *
+ *  Usage: TowersBenchmark [--filter text] [--min-time seconds]
+ *                         [--out results.json] [--compare baseline.json]
+ *                         [--threshold fraction] [--root directory]
+ *
+ *  Results go to standard output as JSON unless --out or --compare is given.
+ *  With --compare the results are shown next to a saved run and the
+ *  exit code is 1 if any case got slower than the threshold allows.
+ */
+
+#include "pch.h"
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <random>
+#include <set>
+#include <sstream>
+#include <unistd.h>
+#include "Benchmark.h"
+#include "TowersGame.h"
+#include "TileRoad.h"
+#include "Balloon.h"
+#include "Item.h"
+#include "FileUtils.h"
+#include "Simd.h"
+
+using namespace std;
+
+/// Seed for the random numbers every case uses, so runs are comparable
+const unsigned int BenchmarkSeed = 2020;
+
+/// Default fraction slower than the baseline that fails a comparison
+const double DefaultThreshold = 0.05;
+
+/**
+ * Write a square level of grass with a straight road across the middle
+ * @param size Tiles along each side
+ * @returns Name of the file written
+ */
+static wstring WriteGridLevel(int size)
+{
+    wstring filename = L"/tmp/towers-benchmark-grid" + to_wstring(size) + L".xml";
+
+    // Each size is only written once per run of the benchmarks
+    static set<int> written;
+    if (!written.insert(size).second)
+    {
+        return filename;
+    }
+
+    stringstream xml;
+    xml << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n";
+    xml << "<level width=\"" << size << "\" height=\"" << size << "\">\n";
+    xml << "  <declarations>\n";
+    xml << "    <road id=\"i001\" image=\"roadEW.png\" type=\"EW\"/>\n";
+    xml << "    <open id=\"i007\" image=\"grass1.png\"/>\n";
+    xml << "  </declarations>\n  <items>\n";
+    for (int y = 0; y < size; y++)
+    {
+        for (int x = 0; x < size; x++)
+        {
+            if (y == size / 2)
+            {
+                xml << "    <road id=\"i001\" x=\"" << x << "\" y=\"" << y << "\""
+                    << (x == 0 ? " start=\"false\"" : "") << "/>\n";
+            }
+            else
+            {
+                xml << "    <open id=\"i007\" x=\"" << x << "\" y=\"" << y << "\"/>\n";
+            }
+        }
+    }
+    xml << "  </items>\n</level>\n";
+
+    WriteFileContents(filename, xml.str());
+    return filename;
+}
+
+/**
+ * Load a generated grid level and start it
+ * @param game Game to load into
+ * @param size Tiles along each side
+ */
+static void StartGridLevel(CTowersGame& game, int size)
+{
+    game.SetSeed(BenchmarkSeed);
+    game.Load(WriteGridLevel(size));
+    game.StartLevel(0);
+}
+
+/**
+ * Put balloons spread evenly at random along the level's road
+ * @param game Started game
+ * @param count Number of balloons to add
+ */
+static void AddBalloons(CTowersGame& game, int count)
+{
+    auto road = game.GetStartRoad();
+    double length = game.GetRoadPath().GetLength();
+    for (int i = 0; i < count; i++)
+    {
+        road->GenerateBalloon(-64, -64);
+        auto& balloon = road->GetBalloons().back();
+        balloon->SetDistance(game.Random() * length);
+        road->PlaceBalloon(balloon.get());
+    }
+}
+
+/**
+ * Collision checks from random points along the road
+ * @param benchmark Harness to add the cases to
+ */
+static void AddCollisionCases(CBenchmark& benchmark)
+{
+    for (int size : { 16, 64, 256 })
+    {
+        for (int balloons : { 30, 1000, 10000 })
+        {
+            string name = "CollisionCheck/tiles:" + to_string(size * size) + "/balloons:" + to_string(balloons);
+            benchmark.Add(name, [size, balloons](CBenchmarkRun& run) {
+                run.PauseTiming();
+                CTowersGame game;
+                StartGridLevel(game, size);
+                AddBalloons(game, balloons);
+
+                // An update with no time passing builds the balloon hash
+                game.Update(0);
+
+                auto& path = game.GetRoadPath();
+                auto& all = game.GetStartRoad()->GetBalloons();
+                mt19937 random(BenchmarkSeed);
+                uniform_real_distribution<double> along(0, path.GetLength());
+                run.ResumeTiming();
+
+                for (long long i = 0; i < run.GetIterations(); i++)
+                {
+                    double x, y;
+                    path.Locate(along(random), x, y);
+                    game.CollisionCheck((int)x, (int)y, 100, false);
+
+                    // Put the popped balloons back now and then so there is always something to hit
+                    if ((i & 255) == 255)
+                    {
+                        run.PauseTiming();
+                        for (auto& balloon : all)
+                        {
+                            balloon->SetRendering(true);
+                        }
+                        run.ResumeTiming();
+                    }
+                }
+
+                // Destroying the game is not part of the time
+                run.PauseTiming();
+            });
+        }
+    }
+}
+
+/**
+ * Dart tower collision checks on a small crowded level, so each check
+ * has many candidates, once with the scalar kernel and once with the
+ * best the processor has
+ * @param benchmark Harness to add the cases to
+ */
+static void AddCollisionKernelCases(CBenchmark& benchmark)
+{
+    for (SimdLevel level : { SimdLevel::Scalar, GetSimdLevel() })
+    {
+        string kernels = WideToUtf8(SimdLevelName(level));
+        for (int balloons : { 1000, 10000, 100000 })
+        {
+            string name = "CollisionCheck/" + kernels + "/tiles:256/balloons:" + to_string(balloons);
+            benchmark.Add(name, [level, balloons](CBenchmarkRun& run) {
+                run.PauseTiming();
+                CTowersGame game;
+                StartGridLevel(game, 16);
+                AddBalloons(game, balloons);
+
+                auto road = game.GetStartRoad();
+                road->GetBalloonStore().SetSimdLevel(level);
+
+                // An update with no time passing builds the balloon hash
+                game.Update(0);
+
+                auto& path = game.GetRoadPath();
+                auto& all = road->GetBalloons();
+                mt19937 random(BenchmarkSeed);
+                uniform_real_distribution<double> along(0, path.GetLength());
+                run.ResumeTiming();
+
+                for (long long i = 0; i < run.GetIterations(); i++)
+                {
+                    double x, y;
+                    path.Locate(along(random), x, y);
+                    game.CollisionCheck((int)x, (int)y, 100, true);
+
+                    // Put the popped balloons back now and then so there is always something to hit
+                    if ((i & 255) == 255)
+                    {
+                        run.PauseTiming();
+                        for (auto& balloon : all)
+                        {
+                            balloon->SetRendering(true);
+                        }
+                        run.ResumeTiming();
+                    }
+                }
+
+                // Destroying the game is not part of the time
+                run.PauseTiming();
+            });
+        }
+    }
+}
+
+/**
+ * Adjacent tile lookups from random tiles
+ * @param benchmark Harness to add the cases to
+ */
+static void AddAdjacentCases(CBenchmark& benchmark)
+{
+    for (int size : { 16, 64, 256 })
+    {
+        benchmark.Add("GetAdjacent/tiles:" + to_string(size * size), [size](CBenchmarkRun& run) {
+            run.PauseTiming();
+            CTowersGame game;
+            StartGridLevel(game, size);
+
+            vector<CItem*> items;
+            for (auto item : game)
+            {
+                items.push_back(item.get());
+            }
+
+            mt19937 random(BenchmarkSeed);
+            uniform_int_distribution<size_t> pick(0, items.size() - 1);
+            uniform_int_distribution<int> step(-1, 1);
+            size_t found = 0;
+            run.ResumeTiming();
+
+            for (long long i = 0; i < run.GetIterations(); i++)
+            {
+                found += game.GetAdjacent(items[pick(random)], step(random), step(random)) != nullptr;
+            }
+
+            run.PauseTiming();
+            if (found == 0)
+            {
+                fprintf(stderr, "GetAdjacent found nothing\n");
+            }
+        });
+    }
+}
+
+/**
+ * Hit tests at random points in the game area
+ * @param benchmark Harness to add the cases to
+ */
+static void AddHitTestCases(CBenchmark& benchmark)
+{
+    for (int size : { 16, 64, 256 })
+    {
+        benchmark.Add("HitTest/tiles:" + to_string(size * size), [size](CBenchmarkRun& run) {
+            run.PauseTiming();
+            CTowersGame game;
+            StartGridLevel(game, size);
+
+            mt19937 random(BenchmarkSeed);
+            uniform_real_distribution<double> where(0, size * CTowersGame::GridSpacing);
+            size_t found = 0;
+            run.ResumeTiming();
+
+            for (long long i = 0; i < run.GetIterations(); i++)
+            {
+                found += game.HitTest(where(random), where(random)) != nullptr;
+            }
+
+            // Destroying the game is not part of the time
+            run.PauseTiming();
+        });
+    }
+}
+
+/**
+ * Updates of the start road while it carries many balloons.
+ *
+ * No time passes in the updates so the balloons stay put and
+ * every run does the same work. The leaving cases add balloons
+ * at the end of the road before each update for it to remove.
+ * @param benchmark Harness to add the cases to
+ */
+static void AddRoadUpdateCases(CBenchmark& benchmark)
+{
+    for (int balloons : { 1000, 10000, 100000 })
+    {
+        benchmark.Add("TileRoadUpdate/balloons:" + to_string(balloons), [balloons](CBenchmarkRun& run) {
+            run.PauseTiming();
+            CTowersGame game;
+            StartGridLevel(game, 16);
+            AddBalloons(game, balloons);
+            auto road = game.GetStartRoad();
+            run.ResumeTiming();
+
+            for (long long i = 0; i < run.GetIterations(); i++)
+            {
+                road->Update(0);
+            }
+
+            // Destroying the game is not part of the time
+            run.PauseTiming();
+        });
+    }
+
+    // One balloon in a hundred reaches the end of a long straight road each update
+    for (int balloons : { 1000, 10000, 100000 })
+    {
+        benchmark.Add("TileRoadUpdate/leaving/balloons:" + to_string(balloons), [balloons](CBenchmarkRun& run) {
+            run.PauseTiming();
+            CTowersGame game;
+            StartGridLevel(game, 256);
+            AddBalloons(game, balloons);
+            auto road = game.GetStartRoad();
+            double length = game.GetRoadPath().GetLength();
+            int leaving = balloons / 100;
+            run.ResumeTiming();
+
+            for (long long i = 0; i < run.GetIterations(); i++)
+            {
+                run.PauseTiming();
+                for (int j = 0; j < leaving; j++)
+                {
+                    road->GetBalloon(road->GenerateBalloon(-64, -64))->SetDistance(length);
+                }
+                run.ResumeTiming();
+
+                road->Update(0);
+            }
+
+            // Destroying the game is not part of the time
+            run.PauseTiming();
+        });
+    }
+}
+
+/**
+ * Sorting the items and building the adjacency grid
+ * @param benchmark Harness to add the cases to
+ */
+static void AddSortCases(CBenchmark& benchmark)
+{
+    for (int size : { 16, 64, 256 })
+    {
+        benchmark.Add("SortTiles/tiles:" + to_string(size * size), [size](CBenchmarkRun& run) {
+            run.PauseTiming();
+            CTowersGame game;
+            StartGridLevel(game, size);
+            run.ResumeTiming();
+
+            for (long long i = 0; i < run.GetIterations(); i++)
+            {
+                game.SortTiles();
+            }
+
+            // Destroying the game is not part of the time
+            run.PauseTiming();
+        });
+    }
+}
+
+/**
+ * Loading each of the shipped levels
+ * @param benchmark Harness to add the cases to
+ */
+static void AddLoadCases(CBenchmark& benchmark)
+{
+    vector<string> files;
+    for (auto& entry : filesystem::directory_iterator("levels"))
+    {
+        if (entry.path().extension() == ".xml")
+        {
+            files.push_back(entry.path().filename().string());
+        }
+    }
+    sort(files.begin(), files.end());
+
+    for (auto& file : files)
+    {
+        wstring filename = L"levels/" + Utf8ToWide(file);
+        benchmark.Add("Load/" + file, [filename](CBenchmarkRun& run) {
+            CTowersGame game;
+            for (long long i = 0; i < run.GetIterations(); i++)
+            {
+                game.Load(filename);
+            }
+        });
+    }
+}
+
+/**
+ * Run the benchmarks
+ * @param argc Number of arguments
+ * @param argv Arguments
+ * @returns 0 on success, 1 if a comparison found a regression, 2 on bad arguments
+ */
+int main(int argc, char* argv[])
+{
+    CBenchmark benchmark;
+    string out;
+    string compare;
+    string root = TOWERS_SOURCE_DIR;
+    double threshold = DefaultThreshold;
+
+    for (int i = 1; i < argc; i++)
+    {
+        string arg = argv[i];
+        if (i + 1 >= argc)
+        {
+            fprintf(stderr, "Missing value for %s\n", arg.c_str());
+            return 2;
+        }
+
+        string value = argv[++i];
+        if (arg == "--filter")
+        {
+            benchmark.SetFilter(value);
+        }
+        else if (arg == "--min-time")
+        {
+            benchmark.SetMinTime(atof(value.c_str()));
+        }
+        else if (arg == "--out")
+        {
+            out = value;
+        }
+        else if (arg == "--compare")
+        {
+            compare = value;
+        }
+        else if (arg == "--threshold")
+        {
+            threshold = atof(value.c_str());
+        }
+        else if (arg == "--root")
+        {
+            root = value;
+        }
+        else
+        {
+            fprintf(stderr, "Unknown option %s\n", arg.c_str());
+            return 2;
+        }
+    }
+
+    map<string, double> baseline;
+    if (!compare.empty())
+    {
+        string json;
+        if (!ReadFileContents(Utf8ToWide(compare), json) || !CBenchmark::ReadJson(json, baseline))
+        {
+            fprintf(stderr, "Unable to read baseline %s\n", compare.c_str());
+            return 2;
+        }
+    }
+
+    if (!out.empty())
+    {
+        out = filesystem::absolute(out).string();
+    }
+
+    // The levels and images are found relative to the source tree
+    if (chdir(root.c_str()) != 0)
+    {
+        fprintf(stderr, "Unable to change to %s\n", root.c_str());
+        return 2;
+    }
+
+    AddCollisionCases(benchmark);
+    AddCollisionKernelCases(benchmark);
+    AddAdjacentCases(benchmark);
+    AddHitTestCases(benchmark);
+    AddRoadUpdateCases(benchmark);
+    AddSortCases(benchmark);
+    AddLoadCases(benchmark);
+
+    benchmark.Run();
+
+    string json = benchmark.ToJson();
+    if (out.empty() && compare.empty())
+    {
+        fputs(json.c_str(), stdout);
+    }
+    else if (!out.empty() && !WriteFileContents(Utf8ToWide(out), json))
+    {
+        fprintf(stderr, "Unable to write %s\n", out.c_str());
+        return 2;
+    }
+
+    if (!compare.empty())
+    {
+        return benchmark.Compare(baseline, threshold) ? 0 : 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,248 @@
+/**
+ * \file StressMain.cpp
+ *
+ * \author Morgan Mundell
+ *
+ *  Runs generated levels far larger than the shipped ones headless
+ *
+ *  Usage: TowersStress [--sizes 16,64,256] [--balloons 30,1000]
+ *                      [--towers count] [--ticks count] [--interval seconds]
+ *                      [--seed seed] [--root directory]
+ *         TowersStress --write level.xml [--sizes size] [--balloons count] ...
+ *
+ *  Every combination of size and balloon count is generated, loaded
+ *  and run for the given number of ticks. For each one the load time,
+ *  simulation ticks per second and memory the game added are reported.
+ *  With --write only the first level is generated and saved.
+ */
+
+#include "pch.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <filesystem>
+#include <sstream>
+#include <unistd.h>
+#include "LevelGenerator.h"
+#include "TowersGame.h"
+#include "TileRoad.h"
+#include "GoButton.h"
+#include "Simd.h"
+#include "FileUtils.h"
+
+using namespace std;
+
+/// Simulated seconds in each tick, the same as the game's clock
+const double TickStep = 0.025;
+
+/**
+ * Read a memory figure of this process from /proc/self/status
+ * @param key Name of the figure, like VmRSS
+ * @returns Size in megabytes, 0 if unknown
+ */
+static double ReadMemory(const string& key)
+{
+    ifstream status("/proc/self/status");
+    string line;
+    while (getline(status, line))
+    {
+        if (line.compare(0, key.size() + 1, key + ":") == 0)
+        {
+            return atof(line.c_str() + key.size() + 1) / 1024;
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * Split a comma separated list of numbers
+ * @param text The list
+ * @returns The numbers
+ */
+static vector<int> ReadList(const string& text)
+{
+    vector<int> numbers;
+    stringstream list(text);
+    string number;
+    while (getline(list, number, ','))
+    {
+        numbers.push_back(atoi(number.c_str()));
+    }
+
+    return numbers;
+}
+
+/// Most ticks to wait for the go button, it comes up after the level label
+const int GoButtonTicks = 200;
+
+/**
+ * Wait for the go button and press it so balloons start coming
+ * @param game Loaded game
+ * @returns False if the go button never came up
+ */
+static bool PressGo(CTowersGame& game)
+{
+    for (int tick = 0; tick < GoButtonTicks; tick++)
+    {
+        game.Update(TickStep);
+        auto& buttons = game.GetRegistry().GetGoButtons();
+        if (!buttons.empty())
+        {
+            game.PressGoButton(buttons.front());
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * Run the stress scenarios
+ * @param argc Number of arguments
+ * @param argv Arguments
+ * @returns 0 on success, 2 on bad arguments
+ */
+int main(int argc, char* argv[])
+{
+    vector<int> sizes = { 16, 64, 256 };
+    vector<int> balloonCounts = { 30, 1000 };
+    int towers = 25;
+    long long ticks = 2000;
+    double interval = TickStep;
+    unsigned int seed = 1;
+    string root = TOWERS_SOURCE_DIR;
+    string write;
+
+    for (int i = 1; i < argc; i++)
+    {
+        string arg = argv[i];
+        if (i + 1 >= argc)
+        {
+            fprintf(stderr, "Missing value for %s\n", arg.c_str());
+            return 2;
+        }
+
+        string value = argv[++i];
+        if (arg == "--sizes")
+        {
+            sizes = ReadList(value);
+        }
+        else if (arg == "--balloons")
+        {
+            balloonCounts = ReadList(value);
+        }
+        else if (arg == "--towers")
+        {
+            towers = atoi(value.c_str());
+        }
+        else if (arg == "--ticks")
+        {
+            ticks = atoll(value.c_str());
+        }
+        else if (arg == "--interval")
+        {
+            interval = atof(value.c_str());
+        }
+        else if (arg == "--seed")
+        {
+            seed = (unsigned int)strtoul(value.c_str(), nullptr, 10);
+        }
+        else if (arg == "--root")
+        {
+            root = value;
+        }
+        else if (arg == "--write")
+        {
+            write = value;
+        }
+        else
+        {
+            fprintf(stderr, "Unknown option %s\n", arg.c_str());
+            return 2;
+        }
+    }
+
+    if (sizes.empty() || balloonCounts.empty())
+    {
+        fprintf(stderr, "Nothing to run\n");
+        return 2;
+    }
+
+    CLevelGenerator generator;
+    generator.SetSeed(seed);
+    generator.SetBalloonInterval(interval);
+    for (int type = 0; type < CLevelGenerator::NumTowerTypes; type++)
+    {
+        generator.SetTowers(CLevelGenerator::TowerType(type), towers);
+    }
+
+    if (!write.empty())
+    {
+        generator.SetSize(sizes[0], sizes[0]);
+        generator.SetBalloons(balloonCounts[0]);
+        return generator.Write(Utf8ToWide(write)) ? 0 : 2;
+    }
+
+    // The images are found relative to the source tree
+    if (chdir(root.c_str()) != 0)
+    {
+        fprintf(stderr, "Unable to change to %s\n", root.c_str());
+        return 2;
+    }
+
+    wstring filename = Utf8ToWide((filesystem::temp_directory_path() / "towers-stress.xml").string());
+
+    printf("balloon kernels %ls\n", SimdLevelName(GetSimdLevel()));
+    printf("%6s %8s %8s %7s %9s %8s %12s %10s %10s %10s\n",
+        "size", "balloons", "road", "towers", "load s", "ticks", "ticks/s", "alive", "darts made", "mem MB");
+
+    for (int size : sizes)
+    {
+        for (int balloons : balloonCounts)
+        {
+            generator.SetSize(size, size);
+            generator.SetBalloons(balloons);
+            generator.Write(filename);
+
+            double before = ReadMemory("VmRSS");
+
+            CTowersGame game;
+            game.SetSeed(seed);
+
+            auto start = chrono::steady_clock::now();
+            game.Load(filename);
+            double load = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+            if (!PressGo(game))
+            {
+                fprintf(stderr, "No go button in the %d level\n", size);
+                continue;
+            }
+
+            start = chrono::steady_clock::now();
+            long long ran = 0;
+            while (ran < ticks && !game.IsLevelComplete())
+            {
+                game.Update(TickStep);
+                ran++;
+            }
+            double run = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+            size_t alive = 0;
+            if (game.GetStartRoad() != nullptr)
+            {
+                alive = game.GetStartRoad()->GetBalloons().size();
+            }
+
+            printf("%6d %8d %8d %7d %9.3f %8lld %12.0f %10zu %10lld %10.1f\n",
+                size, balloons, generator.GetRoadTiles(), generator.GetPlacedTowers(), load, ran,
+                run > 0 ? ran / run : 0, alive, game.GetDartPool().GetCreated(), ReadMemory("VmRSS") - before);
+            fflush(stdout);
+        }
+    }
+
+    printf("peak rss %.1f MB\n", ReadMemory("VmHWM"));
+    return 0;
+}
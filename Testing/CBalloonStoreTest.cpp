@@ -0,0 +1,176 @@
+#include "pch.h"
+#include "CppUnitTest.h"
+
+#include <random>
+#include "BalloonStore.h"
+#include "RoadPath.h"
+#include "TowersGame.h"
+#include "Balloon.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace std;
+
+namespace Testing
+{
+	/**
+	 * Make a path that winds down and across with a turn every tile
+	 * @param path Path to add the segments to
+	 */
+	static void MakeWindingPath(CRoadPath& path)
+	{
+		double x = 32, y = 0;
+		for (int i = 0; i < 20; i++)
+		{
+			double nextX = i % 2 == 0 ? x : x + 64;
+			double nextY = i % 2 == 0 ? y + 64 : y;
+			path.AddSegment(x, y, nextX, nextY);
+			x = nextX;
+			y = nextY;
+		}
+	}
+
+	/**
+	 * Fill a store with the same balloons spread along a path
+	 * @param store Store to fill
+	 * @param length Length of the path
+	 */
+	static void FillStore(CBalloonStore& store, double length)
+	{
+		mt19937 random(1);
+		uniform_real_distribution<double> along(-10, length + 10);
+		for (int i = 0; i < 103; i++)
+		{
+			store.Add(along(random), 128, -1, -1);
+		}
+	}
+
+	TEST_CLASS(CBalloonStoreTest)
+	{
+	public:
+
+		TEST_METHOD_INITIALIZE(methodName)
+		{
+			extern wchar_t g_dir[];
+			::SetCurrentDirectory(g_dir);
+		}
+
+        /** Tests that removing a balloon moves the last one into its place
+         */
+        TEST_METHOD(TestCBalloonStoreRemove)
+        {
+            CBalloonStore store;
+            store.Add(1, 128, 10, 11);
+            store.Add(2, 128, 20, 21);
+            store.Add(3, 128, 30, 31);
+            store.Set(2, CBalloonStore::Popped, true);
+
+            store.Remove(0);
+            Assert::AreEqual((size_t)2, store.GetCount());
+            Assert::AreEqual(3.0, store.GetDistance(0), 0.0);
+            Assert::AreEqual(30.0, store.GetX(0), 0.0);
+            Assert::AreEqual(31.0, store.GetY(0), 0.0);
+            Assert::IsTrue(store.Is(0, CBalloonStore::Popped));
+            Assert::IsFalse(store.Is(1, CBalloonStore::Popped));
+
+            store.Remove(1);
+            Assert::AreEqual((size_t)1, store.GetCount());
+            Assert::AreEqual(3.0, store.GetDistance(0), 0.0);
+        }
+
+        /** Tests that every set of kernels moves and places balloons exactly as the scalar ones do
+         */
+        TEST_METHOD(TestCBalloonStoreKernels)
+        {
+            CRoadPath path;
+            MakeWindingPath(path);
+
+            CBalloonStore scalar;
+            scalar.SetSimdLevel(SimdLevel::Scalar);
+            FillStore(scalar, path.GetLength());
+
+            for (SimdLevel level : { SimdLevel::Sse2, SimdLevel::Avx2 })
+            {
+                CBalloonStore vector;
+                vector.SetSimdLevel(level);
+                FillStore(vector, path.GetLength());
+
+                CBalloonStore reference;
+                reference.SetSimdLevel(SimdLevel::Scalar);
+                FillStore(reference, path.GetLength());
+
+                for (int tick = 0; tick < 40; tick++)
+                {
+                    reference.Place(path);
+                    reference.Advance(0.1);
+                    vector.Place(path);
+                    vector.Advance(0.1);
+                }
+
+                for (size_t i = 0; i < reference.GetCount(); i++)
+                {
+                    Assert::IsTrue(reference.GetDistance(i) == vector.GetDistance(i), L"Distance");
+                    Assert::IsTrue(reference.GetPrevDistance(i) == vector.GetPrevDistance(i), L"Previous distance");
+                    Assert::IsTrue(reference.GetX(i) == vector.GetX(i), L"X");
+                    Assert::IsTrue(reference.GetY(i) == vector.GetY(i), L"Y");
+                }
+            }
+
+            // The scalar kernels place balloons where the path says they are
+            scalar.Place(path);
+            for (size_t i = 0; i < scalar.GetCount(); i++)
+            {
+                double x = -1, y = -1;
+                path.Locate(scalar.GetDistance(i), x, y);
+                Assert::AreEqual(x, scalar.GetX(i), 0.0);
+                Assert::AreEqual(y, scalar.GetY(i), 0.0);
+            }
+        }
+
+        /** Tests that every set of kernels hits the same balloons as CBalloon::InTowerRange
+         */
+        TEST_METHOD(TestCBalloonStoreHitTest)
+        {
+            CTowersGame game;
+            CBalloon balloon(&game);
+
+            // Balloons on a grid around the tower, including exactly on the edges
+            CBalloonStore reference;
+            for (int row = -20; row <= 20; row++)
+            {
+                for (int column = -21; column <= 21; column++)
+                {
+                    reference.Add(0, 0, 100 + column * 6.5, 200 + row * 6);
+                }
+            }
+
+            for (bool dartTower : { false, true })
+            {
+                double radius = 90;
+                double tolerance = dartTower ? CBalloon::DartHitTolerance : CBalloon::HitTolerance;
+                double sector = dartTower ? CBalloon::DartHitTolerance : 0;
+
+                vector<uint64_t> expected;
+                CBalloonStore::HitTest(reference.GetXs(), reference.GetYs(), reference.GetCount(),
+                    100, 200, radius + tolerance, sector, SimdLevel::Scalar, expected);
+                int hit = 0;
+                for (size_t i = 0; i < reference.GetCount(); i++)
+                {
+                    balloon.SetLocation(reference.GetX(i), reference.GetY(i));
+                    bool inRange = balloon.InTowerRange(100, 200, radius, dartTower);
+                    Assert::AreEqual(inRange, ((expected[i / 64] >> (i % 64)) & 1) != 0, L"Scalar kernel");
+                    hit += inRange ? 1 : 0;
+                }
+
+                Assert::IsTrue(hit > 0 && hit < (int)reference.GetCount());
+
+                for (SimdLevel level : { SimdLevel::Sse2, SimdLevel::Avx2 })
+                {
+                    vector<uint64_t> hits;
+                    CBalloonStore::HitTest(reference.GetXs(), reference.GetYs(), reference.GetCount(),
+                        100, 200, radius + tolerance, sector, level, hits);
+                    Assert::IsTrue(expected == hits, L"Vector kernel");
+                }
+            }
+        }
+	};
+}
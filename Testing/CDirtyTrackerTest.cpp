@@ -0,0 +1,119 @@
+#include "pch.h"
+#include "CppUnitTest.h"
+
+#include "DirtyTracker.h"
+#include "TowersGame.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace std;
+
+namespace Testing
+{
+	TEST_CLASS(CDirtyTrackerTest)
+	{
+	public:
+
+		TEST_METHOD_INITIALIZE(methodName)
+		{
+			extern wchar_t g_dir[];
+			::SetCurrentDirectory(g_dir);
+		}
+
+        /** Tests that only what moved is dirty, where it was and where it is now
+         */
+        TEST_METHOD(TestCDirtyTrackerMoved)
+        {
+            CDirtyTracker tracker;
+            CRenderer::Color red(255, 0, 0);
+
+            tracker.BeginFrame();
+            tracker.SetTransform(10, 20, 2);
+            tracker.FillRectangle(0, 0, 10, 10, red);
+            tracker.FillRectangle(100, 100, 10, 10, red);
+            tracker.EndFrame();
+            Assert::IsTrue(tracker.IsAllDirty(), L"First frame");
+
+            // The same again changes nothing
+            tracker.BeginFrame();
+            tracker.SetTransform(10, 20, 2);
+            tracker.FillRectangle(100, 100, 10, 10, red);
+            tracker.FillRectangle(0, 0, 10, 10, red);
+            tracker.EndFrame();
+            Assert::IsFalse(tracker.IsAllDirty());
+            Assert::IsTrue(tracker.GetDirty().empty());
+
+            // Moving one rectangle dirties its old and new places
+            tracker.BeginFrame();
+            tracker.SetTransform(10, 20, 2);
+            tracker.FillRectangle(0, 0, 10, 10, red);
+            tracker.FillRectangle(100, 120, 10, 10, red);
+            tracker.EndFrame();
+            Assert::AreEqual((size_t)2, tracker.GetDirty().size());
+
+            auto old = tracker.GetDirty()[0];
+            Assert::IsTrue(old.mLeft <= 210 && old.mTop <= 220 && old.mRight >= 230 && old.mBottom >= 240);
+            auto now = tracker.GetDirty()[1];
+            Assert::IsTrue(now.mLeft <= 210 && now.mTop <= 260 && now.mRight >= 230 && now.mBottom >= 280);
+
+            // So does changing only the color
+            tracker.BeginFrame();
+            tracker.SetTransform(10, 20, 2);
+            tracker.FillRectangle(0, 0, 10, 10, CRenderer::Color(0, 0, 255));
+            tracker.FillRectangle(100, 120, 10, 10, red);
+            tracker.EndFrame();
+            Assert::AreEqual((size_t)2, tracker.GetDirty().size());
+
+            // A new transform makes everything dirty
+            tracker.BeginFrame();
+            tracker.SetTransform(0, 0, 1);
+            tracker.EndFrame();
+            Assert::IsTrue(tracker.IsAllDirty());
+        }
+
+        /** Tests that many changes are combined into one rectangle
+         */
+        TEST_METHOD(TestCDirtyTrackerCombined)
+        {
+            CDirtyTracker tracker;
+            CRenderer::Color red(255, 0, 0);
+
+            tracker.BeginFrame();
+            tracker.EndFrame();
+
+            tracker.BeginFrame();
+            for (int i = 0; i <= CDirtyTracker::MaxRects; i++)
+            {
+                tracker.FillEllipse(i * 20, 0, 10, 10, red);
+            }
+            tracker.EndFrame();
+
+            Assert::AreEqual((size_t)1, tracker.GetDirty().size());
+            auto all = tracker.GetDirty()[0];
+            Assert::IsTrue(all.mLeft <= 0 && all.mRight >= CDirtyTracker::MaxRects * 20 + 10);
+        }
+
+        /** Tests that a game with nothing moving leaves nothing to paint
+         */
+        TEST_METHOD(TestCDirtyTrackerGame)
+        {
+            CTowersGame game;
+            game.Load(L"levels/level1.xml");
+
+            CDirtyTracker tracker;
+            tracker.BeginFrame();
+            game.DrawDynamic(&tracker);
+            tracker.EndFrame();
+
+            tracker.BeginFrame();
+            game.DrawDynamic(&tracker);
+            tracker.EndFrame();
+            Assert::IsFalse(tracker.IsAllDirty());
+            Assert::IsTrue(tracker.GetDirty().empty());
+
+            // Loading a level changes the tiles
+            long long tiles = game.GetTileChanges();
+            game.Load(L"levels/level1.xml");
+            Assert::IsTrue(tiles != game.GetTileChanges());
+        }
+	};
+}
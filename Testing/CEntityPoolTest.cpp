@@ -0,0 +1,199 @@
+#include "pch.h"
+#include "CppUnitTest.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include "EntityPool.h"
+#include "TowersGame.h"
+#include "Tower8.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace std;
+
+/// Heap allocations made by the tests, counted so a test can check a span made none
+static atomic<long long> g_allocations(0);
+
+/**
+ * Allocate memory, counting the allocation
+ * @param size Bytes needed
+ * @returns The memory
+ */
+void* operator new(size_t size)
+{
+    g_allocations++;
+    void* memory = malloc(size > 0 ? size : 1);
+    if (memory == nullptr)
+    {
+        throw bad_alloc();
+    }
+
+    return memory;
+}
+
+/**
+ * Free memory from operator new
+ * @param memory The memory
+ */
+void operator delete(void* memory) noexcept
+{
+    free(memory);
+}
+
+/**
+ * Free memory from operator new whose size is known
+ * @param memory The memory
+ * @param size Bytes asked for
+ */
+void operator delete(void* memory, size_t size) noexcept
+{
+    free(memory);
+}
+
+namespace Testing
+{
+	TEST_CLASS(CEntityPoolTest)
+	{
+	public:
+
+		TEST_METHOD_INITIALIZE(methodName)
+		{
+			extern wchar_t g_dir[];
+			::SetCurrentDirectory(g_dir);
+		}
+
+        /** Tests that released entities are reset and handed out again
+         */
+        TEST_METHOD(TestCEntityPoolReuse)
+        {
+            CTowersGame game;
+            CEntityPool<CDart> pool(&game);
+
+            auto first = pool.Acquire();
+            auto second = pool.Acquire();
+            Assert::IsTrue(first != second);
+            Assert::AreEqual((size_t)2, pool.GetLive());
+
+            first->SetLocation(100, 200);
+            first->setXOffset(10);
+            first->SetAngle(1);
+            pool.Release(first);
+            Assert::AreEqual((size_t)1, pool.GetLive());
+
+            auto third = pool.Acquire();
+            Assert::IsTrue(third == first, L"Released dart used again");
+            Assert::AreEqual(0.0, third->GetX());
+            Assert::AreEqual(0.0, third->GetXOffset());
+            Assert::AreEqual(0.0, third->GetAngle());
+
+            Assert::AreEqual(2ll, pool.GetCreated());
+            Assert::AreEqual(1ll, pool.GetReused());
+            Assert::AreEqual((size_t)2, pool.GetPeak());
+
+            pool.Release(second);
+            pool.Release(third);
+            Assert::AreEqual((size_t)0, pool.GetLive());
+        }
+
+        /** Tests that entities past the high-water mark are not kept
+         */
+        TEST_METHOD(TestCEntityPoolHighWater)
+        {
+            CTowersGame game;
+            CEntityPool<CDart> pool(&game);
+            pool.SetHighWater(2);
+
+            vector<CDart*> darts;
+            for (int i = 0; i < 4; i++)
+            {
+                darts.push_back(pool.Acquire());
+            }
+
+            Assert::AreEqual((size_t)2, pool.GetPooled());
+            Assert::AreEqual((size_t)4, pool.GetLive());
+
+            for (auto dart : darts)
+            {
+                pool.Release(dart);
+            }
+
+            Assert::AreEqual((size_t)0, pool.GetLive());
+            Assert::AreEqual((size_t)2, pool.GetPooled());
+
+            // Only the pooled darts come back
+            auto dart = pool.Acquire();
+            Assert::IsTrue(dart == darts[0] || dart == darts[1]);
+            pool.Release(dart);
+        }
+
+        /** Tests that a tower firing again makes no new darts
+         */
+        TEST_METHOD(TestCEntityPoolTower)
+        {
+            CTowersGame game;
+            auto& pool = game.GetDartPool();
+
+            auto tower = make_shared<CTower8>(&game);
+            tower->SetLocation(500, 500);
+
+            long long allocations = 0;
+            for (int volley = 0; volley < 3; volley++)
+            {
+                // Everything the first volley needs is made by then
+                if (volley == 1)
+                {
+                    allocations = g_allocations;
+                }
+
+                tower->GenerateAllDarts();
+                Assert::AreEqual((size_t)8, pool.GetLive());
+
+                // Darts are dropped once they fly out of range
+                for (int i = 0; i < 1000 && pool.GetLive() > 0; i++)
+                {
+                    tower->Update(0.1);
+                }
+
+                Assert::AreEqual((size_t)0, pool.GetLive());
+            }
+
+            Assert::AreEqual(0ll, g_allocations - allocations, L"Warm volleys allocate nothing");
+            Assert::AreEqual(8ll, pool.GetCreated());
+            Assert::AreEqual(16ll, pool.GetReused());
+        }
+
+        /** Tests that giving back an entity twice only frees it once
+         */
+        TEST_METHOD(TestCEntityPoolDoubleRelease)
+        {
+            CTowersGame game;
+            CEntityPool<CDart> pool(&game);
+            pool.SetHighWater(1);
+
+            auto pooled = pool.Acquire();
+            auto overflow = pool.Acquire();
+            Assert::AreEqual((size_t)2, pool.GetLive());
+
+            pool.Release(pooled);
+            pool.Release(pooled);
+            pool.Release(overflow);
+            pool.Release(overflow);
+            Assert::AreEqual((size_t)0, pool.GetLive());
+
+            // The dart is handed out once, not once per release
+            auto first = pool.Acquire();
+            auto second = pool.Acquire();
+            Assert::IsTrue(first == pooled);
+            Assert::IsTrue(second != pooled);
+            Assert::AreEqual((size_t)1, pool.GetPooled());
+
+            // Entities the pool never made are left alone
+            CDart other(&game);
+            pool.Release(&other);
+            Assert::AreEqual((size_t)2, pool.GetLive());
+
+            pool.Release(first);
+            pool.Release(second);
+        }
+	};
+}
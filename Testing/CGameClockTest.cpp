@@ -0,0 +1,77 @@
+#include "pch.h"
+#include "CppUnitTest.h"
+
+#include "GameClock.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace std;
+
+namespace Testing
+{
+	TEST_CLASS(CGameClockTest)
+	{
+	public:
+
+		TEST_METHOD_INITIALIZE(methodName)
+		{
+			extern wchar_t g_dir[];
+			::SetCurrentDirectory(g_dir);
+		}
+
+        /** Tests that the tick count only depends on the total time
+         */
+        TEST_METHOD(TestCGameClockFixedSteps)
+        {
+            CGameClock smooth(32);
+            CGameClock jittery(32);
+            jittery.SetMaxTicks(32);
+            Assert::AreEqual(0.03125, smooth.GetStep(), 0.0000001);
+
+            // One second as 32 even frames or as a few uneven ones
+            for (int i = 0; i < 32; i++)
+            {
+                smooth.Advance(0.03125);
+            }
+
+            Assert::AreEqual(0, jittery.Advance(0.0078125));
+            Assert::AreEqual(0.25, jittery.GetAlpha(), 0.0000001);
+            jittery.Advance(0.2421875);
+            jittery.Advance(0.5);
+            jittery.Advance(0.25);
+
+            Assert::AreEqual(32LL, smooth.GetTicks());
+            Assert::AreEqual(32LL, jittery.GetTicks());
+            Assert::AreEqual(0.0, jittery.GetAlpha(), 0.0000001);
+        }
+
+        /** Tests that a long stall does not have to be caught up
+         */
+        TEST_METHOD(TestCGameClockMaxTicks)
+        {
+            CGameClock clock(32);
+            clock.SetMaxTicks(4);
+
+            Assert::AreEqual(4, clock.Advance(10.015625));
+            Assert::AreEqual(0.5, clock.GetAlpha(), 0.0000001);
+            Assert::AreEqual(10.015625 - 4 * 0.03125 - 0.015625, clock.GetDroppedTime(), 0.0000001);
+
+            Assert::AreEqual(1, clock.Advance(0.015625));
+        }
+
+        /** Tests that a faster clock runs more of the same steps
+         */
+        TEST_METHOD(TestCGameClockSpeed)
+        {
+            CGameClock clock(32);
+            clock.SetSpeed(10);
+
+            // 10x is more than the normal per frame limit
+            Assert::AreEqual(40, clock.Advance(0.125));
+            Assert::AreEqual(0.03125, clock.GetStep(), 0.0000001);
+            Assert::AreEqual(0.0, clock.GetDroppedTime(), 0.0000001);
+
+            clock.SetSpeed(1);
+            Assert::AreEqual(4, clock.Advance(0.125));
+        }
+	};
+}
@@ -0,0 +1,114 @@
+#include "pch.h"
+#include "CppUnitTest.h"
+
+#include "HitMask.h"
+#include "Item.h"
+#include "TowersGame.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace std;
+
+namespace Testing
+{
+    /**
+    *  Item that only has an image, for hit testing
+    */
+    class CHitTestItem : public CItem
+    {
+    public:
+        /**  Constructor
+         * @param game TowersGame this Item is a member of */
+        CHitTestItem(CTowersGame* game) : CItem(game)
+        {
+        }
+
+        ///  Default constructor (disabled)
+        CHitTestItem() = delete;
+
+        ///  Copy constructor (disabled)
+        CHitTestItem(const CHitTestItem&) = delete;
+
+        /** Accept a visitor
+        * @param visitor The visitor we accept */
+        virtual void Accept(CItemVisitor* visitor) override { }
+
+        /** Draw no entities
+        * @param graphics The graphics */
+        virtual void RenderEntities(CRenderer* graphics) override {}
+    };
+
+	TEST_CLASS(CHitMaskTest)
+	{
+	public:
+
+		TEST_METHOD_INITIALIZE(methodName)
+		{
+			extern wchar_t g_dir[];
+			::SetCurrentDirectory(g_dir);
+		}
+
+        /** Tests a mask built from a known alpha pattern
+         */
+        TEST_METHOD(TestCHitMaskPattern)
+        {
+            // Wider than one word per row so rows span two words
+            CHitMask mask(100, 3, true);
+            Assert::IsTrue(mask.HasAlpha());
+
+            // A diagonal of opaque pixels, one of them past the first word
+            mask.Set(0, 0);
+            mask.Set(70, 1);
+            mask.Set(99, 2);
+
+            Assert::IsTrue(mask.Test(0, 0));
+            Assert::IsTrue(mask.Test(70, 1));
+            Assert::IsTrue(mask.Test(99, 2));
+
+            Assert::IsFalse(mask.Test(1, 0));
+            Assert::IsFalse(mask.Test(0, 1));
+            Assert::IsFalse(mask.Test(6, 1), L"Same bit in the first word");
+            Assert::IsFalse(mask.Test(70, 0), L"Same column on another row");
+            Assert::IsFalse(mask.Test(98, 2));
+
+            Assert::IsTrue(mask.Contains(0, 0));
+            Assert::IsTrue(mask.Contains(99, 2));
+            Assert::IsFalse(mask.Contains(-1, 0));
+            Assert::IsFalse(mask.Contains(0, -1));
+            Assert::IsFalse(mask.Contains(100, 0));
+            Assert::IsFalse(mask.Contains(0, 3));
+        }
+
+        /** Tests that a mask for an image without alpha is visible everywhere
+         */
+        TEST_METHOD(TestCHitMaskNoAlpha)
+        {
+            CHitMask mask(10, 10, false);
+            Assert::IsFalse(mask.HasAlpha());
+            Assert::IsTrue(mask.Test(0, 0));
+            Assert::IsTrue(mask.Test(9, 9));
+            Assert::IsFalse(mask.Contains(10, 10));
+        }
+
+        /** Tests item hit testing through the mask of an image without alpha
+         */
+        TEST_METHOD(TestCHitMaskItem)
+        {
+            CTowersGame game;
+            CHitTestItem item(&game);
+            item.SetLocation(100, 200);
+
+            // No image, nothing to hit
+            Assert::IsFalse(item.HitTest(100, 200));
+
+            // grass1.png is 64 by 64 with no alpha channel
+            item.SetImage(L"grass1.png");
+            Assert::IsTrue(item.HitTest(100, 200), L"Center");
+            Assert::IsTrue(item.HitTest(69, 169), L"Near a corner");
+            Assert::IsTrue(item.HitTest(131, 231), L"Near the other corner");
+
+            Assert::IsFalse(item.HitTest(133, 200), L"Right of the image");
+            Assert::IsFalse(item.HitTest(100, 167), L"Above the image");
+            Assert::IsFalse(item.HitTest(-100, 200));
+        }
+	};
+}
@@ -0,0 +1,111 @@
+#include "pch.h"
+#include "CppUnitTest.h"
+
+#include "Item.h"
+#include "ImageCache.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace std;
+
+namespace Testing
+{
+	TEST_CLASS(CImageCacheTest)
+	{
+	public:
+
+		TEST_METHOD_INITIALIZE(methodName)
+		{
+			extern wchar_t g_dir[];
+			::SetCurrentDirectory(g_dir);
+		}
+
+        /** Tests that a file is only decoded once
+         */
+        TEST_METHOD(TestCImageCacheSharing)
+        {
+            auto& cache = CImageCache::Instance();
+            wstring filename = CItem::ImagesDirectory + L"dart.png";
+
+            auto first = cache.Get(filename);
+            Assert::IsTrue(first != nullptr, L"Image decoded");
+
+            int hits = cache.GetHits();
+            int misses = cache.GetMisses();
+
+            auto second = cache.Get(filename);
+            Assert::IsTrue(first == second, L"Same bitmap shared");
+            Assert::AreEqual(hits + 1, cache.GetHits());
+            Assert::AreEqual(misses, cache.GetMisses());
+        }
+
+        /** Tests that a missing file is reported and not cached
+         */
+        TEST_METHOD(TestCImageCacheMissing)
+        {
+            auto& cache = CImageCache::Instance();
+            size_t count = cache.GetCount();
+
+            Assert::IsTrue(cache.Get(L"no-such-image.png") == nullptr);
+            Assert::AreEqual(count, cache.GetCount());
+        }
+
+        /** Tests that each tint of an image is only made once
+         */
+        TEST_METHOD(TestCImageCacheTinted)
+        {
+            auto& cache = CImageCache::Instance();
+            wstring filename = CItem::ImagesDirectory + L"red-balloon.png";
+
+            auto first = cache.GetTinted(filename, 1, 0.5f, 0);
+            Assert::IsTrue(first != nullptr, L"Tinted image made");
+
+            size_t count = cache.GetCount();
+            int hits = cache.GetHits();
+
+            auto second = cache.GetTinted(filename, 1, 0.5f, 0);
+            Assert::IsTrue(first == second, L"Same tint shared");
+            Assert::AreEqual(hits + 1, cache.GetHits());
+            Assert::AreEqual(count, cache.GetCount());
+
+            cache.GetTinted(filename, 0, 0.5f, 1);
+            Assert::AreEqual(count + 1, cache.GetCount());
+
+            Assert::IsTrue(cache.GetTinted(L"no-such-image.png", 1, 1, 1) == nullptr);
+        }
+
+        /** Tests that angles are rounded to a bounded set of rotated images
+         */
+        TEST_METHOD(TestCImageCacheRotated)
+        {
+            Assert::AreEqual(0, CImageCache::RotationStep(0, 8));
+            Assert::AreEqual(1, CImageCache::RotationStep(3.141592 / 4, 8));
+            Assert::AreEqual(7, CImageCache::RotationStep(-3.141592 / 4, 8));
+            Assert::AreEqual(0, CImageCache::RotationStep(2 * 3.141592, 8));
+            Assert::AreEqual(2, CImageCache::RotationStep(3.141592 / 4 + 0.5, 8));
+
+            auto& cache = CImageCache::Instance();
+            wstring filename = CItem::ImagesDirectory + L"dart.png";
+
+            auto first = cache.GetRotated(filename, 3.141592 / 4);
+            Assert::IsTrue(first != nullptr, L"Rotated image made");
+
+            size_t count = cache.GetCount();
+            int hits = cache.GetHits();
+
+            // The firing sectors are exact steps, so nearby angles share them
+            auto second = cache.GetRotated(filename, 3.14159265 / 4);
+            Assert::IsTrue(first == second, L"Same step shared");
+            Assert::AreEqual(hits + 1, cache.GetHits());
+            Assert::AreEqual(count, cache.GetCount());
+
+            cache.GetRotated(filename, 3 * 3.141592 / 4);
+            Assert::AreEqual(count + 1, cache.GetCount());
+
+            // A new step count makes its own images
+            cache.SetRotationSteps(16);
+            cache.GetRotated(filename, 3.141592 / 4);
+            Assert::AreEqual(count + 2, cache.GetCount());
+            cache.SetRotationSteps(CImageCache::DefaultRotationSteps);
+        }
+	};
+}
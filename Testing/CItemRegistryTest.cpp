@@ -0,0 +1,71 @@
+#include "pch.h"
+#include "CppUnitTest.h"
+
+#include "TowersGame.h"
+#include "TileRoad.h"
+#include "Tower.h"
+#include "GoButton.h"
+#include "LevelGenerator.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace std;
+
+namespace Testing
+{
+	TEST_CLASS(CItemRegistryTest)
+	{
+	public:
+
+		TEST_METHOD_INITIALIZE(methodName)
+		{
+			extern wchar_t g_dir[];
+			::SetCurrentDirectory(g_dir);
+		}
+
+        /** Tests that the registry follows items as they are added, deleted and cleared
+         */
+        TEST_METHOD(TestCItemRegistryLists)
+        {
+            CLevelGenerator generator;
+            generator.SetTowers(CLevelGenerator::Bomb, 3);
+            generator.Write(L"registry-test.xml");
+
+            CTowersGame game;
+            game.Load(L"registry-test.xml");
+            remove("registry-test.xml");
+
+            auto& registry = game.GetRegistry();
+            Assert::AreEqual(generator.GetRoadTiles(), (int)registry.GetRoads().size());
+
+            // The palette has one dart tower, two bomb towers, one ring tower and one airship tower
+            Assert::AreEqual(2 + generator.GetPlacedTowers(), registry.GetTowerCount(CItemRegistry::TowerKind::Bomb));
+            Assert::AreEqual(1, registry.GetTowerCount(CItemRegistry::TowerKind::Eight));
+            Assert::AreEqual(1, registry.GetTowerCount(CItemRegistry::TowerKind::Rings));
+            Assert::AreEqual(1, registry.GetTowerCount(CItemRegistry::TowerKind::Airship));
+
+            game.StartLevel(0);
+            Assert::IsTrue(game.GetStartRoad() != nullptr, L"Start road");
+            Assert::IsTrue(registry.GetStartRoad().get() == game.GetStartRoad());
+
+            // Deleting a tower takes it out of its list
+            int bombs = registry.GetTowerCount(CItemRegistry::TowerKind::Bomb);
+            game.DeleteItem(registry.GetTowers(CItemRegistry::TowerKind::Bomb).front());
+            Assert::AreEqual(bombs - 1, registry.GetTowerCount(CItemRegistry::TowerKind::Bomb));
+
+            // The go button comes up once the level label is gone and leaves when pressed
+            for (int i = 0; i < 200 && registry.GetGoButtons().empty(); i++)
+            {
+                game.Update(0.025);
+            }
+
+            Assert::AreEqual((size_t)1, registry.GetGoButtons().size(), L"Go button");
+            game.PressGoButton(registry.GetGoButtons().front());
+            Assert::IsTrue(registry.GetGoButtons().empty());
+
+            game.Clear();
+            Assert::IsTrue(registry.GetRoads().empty());
+            Assert::AreEqual(0, registry.GetTowerCount(CItemRegistry::TowerKind::Eight));
+            Assert::IsTrue(registry.GetStartRoad() == nullptr);
+        }
+	};
+}
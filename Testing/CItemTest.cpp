@@ -36,7 +36,7 @@ namespace Testing
         * @param visitor The visitor we accept */
         virtual void Accept(CItemVisitor* visitor) override { }
 
-        virtual void RenderEntities(Gdiplus::Graphics* graphics) {};
+        virtual void RenderEntities(CRenderer* graphics) {};
         
     };
 
@@ -68,9 +68,11 @@ namespace Testing
             center->SetLocation(grid * 10, grid * 17);
             game.Add(center);
 
+            // Neighbors are one grid spacing away on the square grid
+
             // Upper left
             auto ul = make_shared<CItemMock>(&game);
-            ul->SetLocation(grid * 8, grid * 16);
+            ul->SetLocation(grid * 9, grid * 16);
             game.Add(ul);
             game.SortTiles();
 
@@ -79,17 +81,17 @@ namespace Testing
 
             // Upper right
             auto ur = make_shared<CItemMock>(&game);
-            ur->SetLocation(grid * 12, grid * 16);
+            ur->SetLocation(grid * 11, grid * 16);
             game.Add(ur);
 
             // Lower left
             auto ll = make_shared<CItemMock>(&game);
-            ll->SetLocation(grid * 8, grid * 18);
+            ll->SetLocation(grid * 9, grid * 18);
             game.Add(ll);
 
             // Lower right
             auto lr = make_shared<CItemMock>(&game);
-            lr->SetLocation(grid * 12, grid * 18);
+            lr->SetLocation(grid * 11, grid * 18);
             game.Add(lr);
 
             game.SortTiles();
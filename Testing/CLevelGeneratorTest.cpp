@@ -0,0 +1,123 @@
+#include "pch.h"
+#include "CppUnitTest.h"
+
+#include <cstdio>
+#include "LevelGenerator.h"
+#include "TowersGame.h"
+#include "TileRoad.h"
+#include "Tower.h"
+#include "GoButton.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace std;
+
+namespace Testing
+{
+	TEST_CLASS(CLevelGeneratorTest)
+	{
+	public:
+
+		TEST_METHOD_INITIALIZE(methodName)
+		{
+			extern wchar_t g_dir[];
+			::SetCurrentDirectory(g_dir);
+		}
+
+        /** Tests that the same settings give the same level
+         */
+        TEST_METHOD(TestCLevelGeneratorRepeatable)
+        {
+            CLevelGenerator generator;
+            generator.SetSize(32, 24);
+            generator.SetSeed(7);
+            string first = generator.Generate();
+            Assert::IsTrue(first == generator.Generate());
+
+            generator.SetSeed(8);
+            Assert::IsFalse(first == generator.Generate());
+
+            // Sizes are kept to what the generator supports
+            generator.SetSize(5000, 0);
+            generator.Generate();
+            Assert::IsTrue(generator.GetRoadTiles() >= CLevelGenerator::MaxSize);
+        }
+
+        /** Tests that a generated level loads with a road across it and its towers placed
+         */
+        TEST_METHOD(TestCLevelGeneratorLoad)
+        {
+            CLevelGenerator generator;
+            generator.SetSize(40, 30);
+            generator.SetSeed(2020);
+            generator.SetBalloons(50);
+            generator.SetBalloonInterval(0.02);
+            for (int type = 0; type < CLevelGenerator::NumTowerTypes; type++)
+            {
+                generator.SetTowers(CLevelGenerator::TowerType(type), 3);
+            }
+
+            Assert::IsTrue(generator.Write(L"generated-test.xml"));
+            Assert::AreEqual(12, generator.GetPlacedTowers());
+            Assert::IsTrue(generator.GetRoadTiles() >= 40);
+
+            CTowersGame game;
+            game.Load(L"generated-test.xml");
+            remove("generated-test.xml");
+
+            int placed = 0;
+            for (auto item : game)
+            {
+                auto tower = dynamic_pointer_cast<CTower>(item);
+                if (tower != nullptr && tower->GetIsPlaced())
+                {
+                    placed++;
+                }
+            }
+            Assert::AreEqual(12, placed);
+
+            // Every road tile is part of one path from the west edge to the east edge
+            game.StartLevel(0);
+            Assert::IsTrue(game.GetStartRoad() != nullptr, L"Start road");
+            Assert::AreEqual(generator.GetRoadTiles() * 64.0, game.GetRoadPath().GetLength(), 0.001);
+
+            double x, y;
+            Assert::IsTrue(game.GetRoadPath().Locate(0, x, y));
+            Assert::AreEqual(-16.0, x, 0.001);
+            Assert::IsTrue(game.GetRoadPath().Locate(game.GetRoadPath().GetLength() - 0.001, x, y));
+            Assert::AreEqual(40 * 64.0 - 16, x, 0.01);
+
+            // The level sends the number of balloons it asks for,
+            // the go button comes up once the level label is gone
+            shared_ptr<CItem> go;
+            for (int i = 0; i < 200 && go == nullptr; i++)
+            {
+                game.Update(0.025);
+                for (auto item : game)
+                {
+                    if (dynamic_pointer_cast<CGoButton>(item) != nullptr)
+                    {
+                        go = item;
+                    }
+                }
+            }
+            Assert::IsTrue(go != nullptr, L"Go button");
+            game.PressGoButton(go);
+
+            for (int i = 0; i < 150; i++)
+            {
+                game.Update(0.025);
+            }
+            Assert::AreEqual((size_t)50, game.GetStartRoad()->GetBalloons().size());
+
+            // Once every balloon is gone the count starts over at the level's number
+            Assert::AreEqual(50, game.GetBalloonCount());
+            for (int i = 0; i < 50; i++)
+            {
+                game.DecrementBalloonCount();
+            }
+
+            game.Update(0);
+            Assert::AreEqual(50, game.GetBalloonCount());
+        }
+	};
+}
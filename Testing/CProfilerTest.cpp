@@ -0,0 +1,132 @@
+#include "pch.h"
+#include "CppUnitTest.h"
+
+#include "Profiler.h"
+#include "DirtyTracker.h"
+#include "TowersGame.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace std;
+
+namespace Testing
+{
+	TEST_CLASS(CProfilerTest)
+	{
+	public:
+
+		TEST_METHOD_INITIALIZE(methodName)
+		{
+			extern wchar_t g_dir[];
+			::SetCurrentDirectory(g_dir);
+
+			// Each test starts with a fresh history
+			CProfiler::Instance().SetEnabled(false);
+			CProfiler::Instance().SetEnabled(true);
+		}
+
+        /** Tests the frame times and their percentiles
+         */
+        TEST_METHOD(TestCProfilerPercentiles)
+        {
+            auto& profiler = CProfiler::Instance();
+            Assert::AreEqual(0, profiler.GetFrameCount());
+
+            // Frames of 1 to 100 milliseconds
+            for (int i = 1; i <= 100; i++)
+            {
+                profiler.Add(CProfiler::Frame, i * 1000000LL);
+                profiler.Add(CProfiler::Update, 500000LL);
+                profiler.EndFrame();
+            }
+
+            Assert::AreEqual(100, profiler.GetFrameCount());
+            Assert::AreEqual(100.0, profiler.GetTime(CProfiler::Frame, 0), 0.0001);
+            Assert::AreEqual(99.0, profiler.GetTime(CProfiler::Frame, 1), 0.0001);
+            Assert::AreEqual(50.0, profiler.GetPercentile(CProfiler::Frame, 50), 0.0001);
+            Assert::AreEqual(95.0, profiler.GetPercentile(CProfiler::Frame, 95), 0.0001);
+            Assert::AreEqual(99.0, profiler.GetPercentile(CProfiler::Frame, 99), 0.0001);
+            Assert::AreEqual(50.5, profiler.GetMean(CProfiler::Frame), 0.0001);
+            Assert::AreEqual(0.5, profiler.GetMean(CProfiler::Update), 0.0001);
+            Assert::AreEqual(0.0, profiler.GetMean(CProfiler::Blit), 0.0001);
+
+            // 10 ms buckets, anything over 50 ms lands in the last one
+            int buckets[6];
+            profiler.GetHistogram(CProfiler::Frame, 10, buckets, 6);
+            Assert::AreEqual(9, buckets[0]);
+            Assert::AreEqual(10, buckets[1]);
+            Assert::AreEqual(51, buckets[5]);
+        }
+
+        /** Tests that only the most recent frames are kept
+         */
+        TEST_METHOD(TestCProfilerHistoryWraps)
+        {
+            auto& profiler = CProfiler::Instance();
+
+            int history = CProfiler::HistoryFrames;
+            int frames = history + 10;
+            for (int i = 0; i < frames; i++)
+            {
+                profiler.Add(CProfiler::Draw, i * 1000000LL);
+                profiler.EndFrame();
+            }
+
+            Assert::AreEqual(history, profiler.GetFrameCount());
+            Assert::AreEqual(double(frames - 1), profiler.GetTime(CProfiler::Draw, 0), 0.0001);
+            Assert::AreEqual(10.0, profiler.GetTime(CProfiler::Draw, history - 1), 0.0001);
+            Assert::AreEqual(0.0, profiler.GetTime(CProfiler::Draw, history), 0.0001);
+        }
+
+        /** Tests that nothing is timed while profiling is off
+         */
+        TEST_METHOD(TestCProfilerDisabled)
+        {
+            auto& profiler = CProfiler::Instance();
+            profiler.SetEnabled(false);
+
+            {
+                CProfileFrame frame;
+                CProfileScope scope(CProfiler::Frame);
+            }
+
+            profiler.SetEnabled(true);
+            Assert::AreEqual(0, profiler.GetFrameCount());
+
+            {
+                CProfileFrame frame;
+                CProfileScope scope(CProfiler::Frame);
+            }
+
+            Assert::AreEqual(1, profiler.GetFrameCount());
+            Assert::IsTrue(profiler.GetTime(CProfiler::Frame, 0) >= 0);
+        }
+
+        /** Tests that finding what changed on screen is not timed as drawing
+         */
+        TEST_METHOD(TestCProfilerTrackingPass)
+        {
+            auto& profiler = CProfiler::Instance();
+
+            {
+                CProfileFrame frame;
+                CProfileScope scope(CProfiler::Draw, false);
+            }
+
+            Assert::AreEqual(0.0, profiler.GetTime(CProfiler::Draw, 0), 0.0);
+
+            // The dirty tracking pass draws the entities without timing them
+            CTowersGame game;
+            game.Load(L"level1.xml");
+            CDirtyTracker tracker;
+            {
+                CProfileFrame frame;
+                tracker.BeginFrame();
+                game.DrawDynamic(&tracker, 0);
+                tracker.EndFrame();
+            }
+
+            Assert::AreEqual(2, profiler.GetFrameCount());
+            Assert::AreEqual(0.0, profiler.GetTime(CProfiler::RenderEntities, 0), 0.0);
+        }
+	};
+}
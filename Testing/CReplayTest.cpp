@@ -0,0 +1,99 @@
+#include "pch.h"
+#include "CppUnitTest.h"
+
+#include <cstdio>
+#include "Replay.h"
+#include "ReplayPlayer.h"
+#include "TowersGame.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace std;
+
+namespace Testing
+{
+	TEST_CLASS(CReplayTest)
+	{
+	public:
+
+		TEST_METHOD_INITIALIZE(methodName)
+		{
+			extern wchar_t g_dir[];
+			::SetCurrentDirectory(g_dir);
+		}
+
+        /** Tests that a replay file reads back what was written
+         */
+        TEST_METHOD(TestCReplaySaveLoad)
+        {
+            CReplay replay;
+            replay.SetSeed(1234567);
+            replay.SetStep(0.025);
+            replay.Add(0, CReplay::Type::Load, 0, 0, L"levels/level1.xml");
+            replay.Add(100, CReplay::Type::Grab, 1150.25, 180.125);
+            replay.Add(100000, CReplay::Type::Drop, 1.0 / 3, -7);
+            replay.Add(100001, CReplay::Type::Answer, 1);
+            replay.SetEndTick(200000);
+
+            Assert::IsTrue(replay.Save(L"test.replay"));
+
+            CReplay loaded;
+            Assert::IsTrue(loaded.Load(L"test.replay"));
+            remove("test.replay");
+
+            Assert::AreEqual(1234567u, loaded.GetSeed());
+            Assert::AreEqual(0.025, loaded.GetStep(), 0);
+            Assert::AreEqual(200000LL, loaded.GetEndTick());
+
+            auto& events = loaded.GetEvents();
+            Assert::AreEqual(4, (int)events.size());
+            Assert::IsTrue(events[0].mType == CReplay::Type::Load);
+            Assert::IsTrue(events[0].mText == L"levels/level1.xml");
+            Assert::AreEqual(100000LL, events[2].mTick);
+            Assert::IsTrue(events[2].mX == 1.0 / 3, L"Locations are exact");
+            Assert::AreEqual(-7.0, events[2].mY, 0);
+            Assert::IsTrue(events[3].mType == CReplay::Type::Answer);
+            Assert::AreEqual(1.0, events[3].mX, 0);
+
+            Assert::IsFalse(loaded.Load(L"no-such.replay"));
+        }
+
+        /** Tests that playing a recording gives the same game
+         */
+        TEST_METHOD(TestCReplayDeterministic)
+        {
+            const double step = 0.025;
+
+            CReplay replay;
+            CTowersGame recorded;
+            recorded.SetSeed(42);
+            recorded.StartRecording(&replay);
+            replay.SetStep(step);
+
+            // Load, wait for the go button and start the balloons
+            recorded.Load(L"levels/level1.xml");
+            for (int i = 0; i < 100; i++)
+            {
+                recorded.Update(step);
+            }
+
+            recorded.Grab(1150, 923);
+            Assert::IsTrue(recorded.GetGoButtonPressed(), L"Go pressed");
+
+            for (int i = 0; i < 1000; i++)
+            {
+                recorded.Update(step);
+            }
+            replay.SetEndTick(recorded.GetTick());
+
+            CTowersGame played;
+            CReplayPlayer player(replay);
+            player.Start(&played);
+            Assert::AreEqual(1100LL, player.Run());
+
+            Assert::IsTrue(played.GetGoButtonPressed());
+            Assert::AreEqual(recorded.GetTick(), played.GetTick());
+            Assert::AreEqual(recorded.GetGameScore(), played.GetGameScore());
+            Assert::IsTrue(recorded.Random() == played.Random(), L"Same random numbers used");
+        }
+	};
+}
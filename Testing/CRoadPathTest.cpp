@@ -0,0 +1,53 @@
+#include "pch.h"
+#include "CppUnitTest.h"
+
+#include "RoadPath.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace std;
+
+namespace Testing
+{
+	TEST_CLASS(CRoadPathTest)
+	{
+	public:
+
+		TEST_METHOD_INITIALIZE(methodName)
+		{
+			extern wchar_t g_dir[];
+			::SetCurrentDirectory(g_dir);
+		}
+
+        /** Tests locating points along a path with a turn
+         */
+        TEST_METHOD(TestCRoadPathLocate)
+        {
+            CRoadPath path;
+            Assert::IsTrue(path.IsEmpty());
+
+            double x = 0, y = 0;
+            Assert::IsFalse(path.Locate(0, x, y), L"Empty path");
+
+            // Down the middle of a tile and then off to the right
+            path.AddSegment(32, 0, 32, 32);
+            path.AddSegment(32, 32, 32, 32);
+            path.AddSegment(32, 32, 64, 32);
+            Assert::AreEqual(2, (int)path.GetSegments().size(), L"Zero length skipped");
+            Assert::AreEqual(64.0, path.GetLength(), 0.0001);
+
+            Assert::IsTrue(path.Locate(0, x, y));
+            Assert::AreEqual(32.0, x, 0.0001);
+            Assert::AreEqual(0.0, y, 0.0001);
+
+            Assert::IsTrue(path.Locate(16, x, y));
+            Assert::AreEqual(32.0, x, 0.0001);
+            Assert::AreEqual(16.0, y, 0.0001);
+
+            Assert::IsTrue(path.Locate(48, x, y));
+            Assert::AreEqual(48.0, x, 0.0001);
+            Assert::AreEqual(32.0, y, 0.0001);
+
+            Assert::IsFalse(path.Locate(64, x, y), L"End of the path");
+        }
+	};
+}
@@ -0,0 +1,132 @@
+#include "pch.h"
+#include "CppUnitTest.h"
+
+#include <algorithm>
+#include "TowersGame.h"
+#include "Balloon.h"
+#include "SpatialHash.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace std;
+
+namespace Testing
+{
+	TEST_CLASS(CSpatialHashTest)
+	{
+	public:
+
+		TEST_METHOD_INITIALIZE(methodName)
+		{
+			extern wchar_t g_dir[];
+			::SetCurrentDirectory(g_dir);
+		}
+
+        /** Tests radius queries only find balloons inside the circle
+         */
+        TEST_METHOD(TestCSpatialHashQuery)
+        {
+            CTowersGame game;
+            CSpatialHash hash(64);
+
+            auto near1 = make_shared<CBalloon>(&game);
+            near1->SetLocation(100, 100);
+            auto near2 = make_shared<CBalloon>(&game);
+            near2->SetLocation(-20, 130);
+            auto far = make_shared<CBalloon>(&game);
+            far->SetLocation(500, 100);
+
+            hash.Insert(near1.get());
+            hash.Insert(near2.get());
+            hash.Insert(far.get());
+            Assert::AreEqual(3, hash.GetCount());
+
+            vector<CSpatialHash::Entry> found;
+            hash.Query(50, 100, 80, found);
+            Assert::AreEqual(2, (int)found.size());
+            Assert::IsTrue(find_if(found.begin(), found.end(),
+                [&far](const CSpatialHash::Entry& entry) { return entry.mBalloon == far.get(); }) == found.end());
+
+            // Edge of the circle is inside
+            found.clear();
+            hash.Query(400, 100, 100, found);
+            Assert::AreEqual(1, (int)found.size());
+            Assert::IsTrue(found[0].mBalloon == far.get());
+            Assert::AreEqual(500.0, found[0].mX, 0.0);
+            Assert::AreEqual(100.0, found[0].mY, 0.0);
+
+            hash.Clear();
+            found.clear();
+            hash.Query(50, 100, 1000, found);
+            Assert::AreEqual(0, hash.GetCount());
+            Assert::AreEqual(0, (int)found.size());
+        }
+
+        /** Tests that queries use where balloons were when they were added
+         */
+        TEST_METHOD(TestCSpatialHashMoved)
+        {
+            CTowersGame game;
+            CSpatialHash hash(64);
+
+            auto balloon = make_shared<CBalloon>(&game);
+            balloon->SetLocation(100, 100);
+            hash.Insert(balloon.get());
+
+            // Moving the balloon to another cell after it was added
+            balloon->SetLocation(300, 100);
+
+            vector<CSpatialHash::Entry> found;
+            hash.Query(100, 100, 10, found);
+            Assert::AreEqual(1, (int)found.size(), L"Found where it was added");
+            Assert::AreEqual(100.0, found[0].mX, 0.0);
+            Assert::AreEqual(100.0, found[0].mY, 0.0);
+
+            found.clear();
+            hash.Query(300, 100, 10, found);
+            Assert::AreEqual(0, (int)found.size(), L"Not found where it moved to");
+
+            // Large circles visit the occupied cells instead, with the same result
+            found.clear();
+            hash.Query(300, 100, 150, found);
+            Assert::AreEqual(0, (int)found.size());
+        }
+
+        /** Tests gathering the balloons in the cells near a point, with their locations side by side
+         */
+        TEST_METHOD(TestCSpatialHashGather)
+        {
+            CTowersGame game;
+            CSpatialHash hash(64);
+
+            auto a = make_shared<CBalloon>(&game);
+            a->SetLocation(10, 10);
+            auto b = make_shared<CBalloon>(&game);
+            b->SetLocation(20, 30);
+            auto c = make_shared<CBalloon>(&game);
+            c->SetLocation(-300, 10);
+            hash.Insert(a.get());
+            hash.Insert(b.get());
+            hash.Insert(c.get());
+
+            // Room for every balloon in the hash
+            vector<CBalloon*> balloons(3);
+            vector<double> xs(3), ys(3);
+            Assert::AreEqual((size_t)2, hash.Gather(0, 0, 20, balloons.data(), xs.data(), ys.data()));
+            Assert::IsTrue(balloons[0] == a.get());
+            Assert::IsTrue(balloons[1] == b.get());
+            Assert::AreEqual(10.0, xs[0], 0.0);
+            Assert::AreEqual(20.0, xs[1], 0.0);
+            Assert::AreEqual(30.0, ys[1], 0.0);
+
+            Assert::AreEqual((size_t)1, hash.Gather(-300, 10, 1, balloons.data(), xs.data(), ys.data()));
+            Assert::IsTrue(balloons[0] == c.get());
+            Assert::AreEqual(-300.0, xs[0], 0.0);
+            Assert::AreEqual(10.0, ys[0], 0.0);
+
+            // Emptied cells add nothing
+            hash.Clear();
+            hash.Insert(c.get());
+            Assert::AreEqual((size_t)0, hash.Gather(0, 0, 20, balloons.data(), xs.data(), ys.data()));
+        }
+	};
+}
@@ -0,0 +1,108 @@
+#include "pch.h"
+#include "CppUnitTest.h"
+
+#include "TileGrid.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace std;
+
+namespace Testing
+{
+	TEST_CLASS(CTileGridTest)
+	{
+	public:
+
+		TEST_METHOD_INITIALIZE(methodName)
+		{
+			extern wchar_t g_dir[];
+			::SetCurrentDirectory(g_dir);
+		}
+
+        /** Tests lookups of cells inside the grid
+         */
+        TEST_METHOD(TestCTileGridFind)
+        {
+            CTileGrid grid;
+            Assert::AreEqual(0, grid.GetColumns());
+            Assert::AreEqual(0, grid.GetRows());
+            Assert::AreEqual(CTileGrid::NoTile, grid.Find(0, 0));
+
+            // Grid starting left of and above the origin
+            grid.Resize(-2, -1, 5, 3);
+            Assert::AreEqual(5, grid.GetColumns());
+            Assert::AreEqual(3, grid.GetRows());
+            Assert::AreEqual(CTileGrid::NoTile, grid.Find(0, 0), L"Empty cell");
+
+            Assert::IsTrue(grid.Set(-2, -1, 7));
+            Assert::IsTrue(grid.Set(2, 1, 8));
+            Assert::IsTrue(grid.Set(0, 0, 9));
+
+            Assert::AreEqual(7, grid.Find(-2, -1), L"First cell");
+            Assert::AreEqual(8, grid.Find(2, 1), L"Last cell");
+            Assert::AreEqual(9, grid.Find(0, 0));
+            Assert::AreEqual(CTileGrid::NoTile, grid.Find(1, 0), L"Neighbor");
+
+            // Setting a cell again replaces its tile
+            Assert::IsTrue(grid.Set(0, 0, 10));
+            Assert::AreEqual(10, grid.Find(0, 0));
+        }
+
+        /** Tests locations outside the grid, including negative ones
+         */
+        TEST_METHOD(TestCTileGridOutside)
+        {
+            CTileGrid grid;
+            grid.Resize(0, 0, 4, 2);
+            grid.Set(3, 1, 5);
+
+            Assert::AreEqual(CTileGrid::NoTile, grid.Find(-1, 0));
+            Assert::AreEqual(CTileGrid::NoTile, grid.Find(0, -1));
+            Assert::AreEqual(CTileGrid::NoTile, grid.Find(4, 1), L"Past the last column");
+            Assert::AreEqual(CTileGrid::NoTile, grid.Find(3, 2), L"Past the last row");
+            Assert::AreEqual(CTileGrid::NoTile, grid.Find(-1, 2), L"Would wrap onto the next row");
+
+            Assert::IsFalse(grid.Set(-1, 0, 1));
+            Assert::IsFalse(grid.Set(0, -1, 1));
+            Assert::IsFalse(grid.Set(4, 0, 1));
+            Assert::IsFalse(grid.Set(0, 2, 1));
+
+            // Nothing outside the grid changed what is inside it
+            Assert::AreEqual(5, grid.Find(3, 1));
+            Assert::AreEqual(CTileGrid::NoTile, grid.Find(0, 1));
+            Assert::AreEqual(CTileGrid::NoTile, grid.Find(0, 0));
+        }
+
+        /** Tests clearing and resizing the grid
+         */
+        TEST_METHOD(TestCTileGridClear)
+        {
+            CTileGrid grid;
+            grid.Resize(0, 0, 3, 3);
+            grid.Set(1, 1, 4);
+
+            grid.Clear();
+            Assert::AreEqual(0, grid.GetColumns());
+            Assert::AreEqual(0, grid.GetRows());
+            Assert::AreEqual(CTileGrid::NoTile, grid.Find(1, 1));
+            Assert::IsFalse(grid.Set(0, 0, 1));
+
+            // Resizing empties every cell
+            grid.Resize(0, 0, 3, 3);
+            grid.Set(1, 1, 4);
+            grid.Resize(1, 1, 2, 2);
+            Assert::AreEqual(CTileGrid::NoTile, grid.Find(1, 1));
+            Assert::AreEqual(CTileGrid::NoTile, grid.Find(0, 0));
+
+            // Negative sizes give an empty grid
+            grid.Resize(0, 0, -3, 2);
+            Assert::AreEqual(0, grid.GetColumns());
+            Assert::AreEqual(2, grid.GetRows());
+            Assert::AreEqual(CTileGrid::NoTile, grid.Find(0, 0));
+            Assert::IsFalse(grid.Set(0, 0, 1));
+
+            grid.Resize(0, 0, 2, -1);
+            Assert::AreEqual(0, grid.GetRows());
+            Assert::IsFalse(grid.Set(0, 0, 1));
+        }
+	};
+}
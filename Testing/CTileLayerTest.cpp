@@ -0,0 +1,144 @@
+#include "pch.h"
+#include "CppUnitTest.h"
+
+#include "TowersGame.h"
+#include "Renderer.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace std;
+
+namespace Testing
+{
+    class CCountingLayer;
+
+    /**
+     * Renderer that counts the images drawn with it and,
+     * if asked to, offers layers that count their own
+     */
+    class CCountingRenderer : public CRenderer
+    {
+    public:
+        CCountingRenderer(bool layers = false) : mLayers(layers) {}
+
+        virtual unique_ptr<CLayer> CreateLayer(int width, int height) override;
+
+        virtual void DrawLayer(CLayer* layer) override { mLayersDrawn++; }
+        virtual void SetTransform(double x, double y, double scale) override {}
+        virtual void DrawImage(const CGameImage* image, double x, double y, double width, double height) override { mImages++; }
+        virtual void FillRectangle(double x, double y, double width, double height, Color color) override {}
+        virtual void FillEllipse(double x, double y, double width, double height, Color color) override {}
+        virtual void DrawEllipse(double x, double y, double width, double height, Color color, double penWidth) override {}
+        virtual void DrawString(const wstring& text, double x, double y, double size, Color color) override {}
+
+        /// Does this renderer offer layers?
+        bool mLayers;
+
+        /// Images drawn directly with this renderer
+        int mImages = 0;
+
+        /// Layers created
+        int mLayersCreated = 0;
+
+        /// Times a layer was copied to this renderer
+        int mLayersDrawn = 0;
+
+        /// The last layer created, owned by whoever asked for it
+        CCountingLayer* mLastLayer = nullptr;
+    };
+
+    /// Layer holding a counting renderer
+    class CCountingLayer : public CRenderer::CLayer
+    {
+    public:
+        virtual CRenderer* GetRenderer() override { return &mRenderer; }
+
+        /// Renderer drawing into the layer
+        CCountingRenderer mRenderer;
+    };
+
+    unique_ptr<CRenderer::CLayer> CCountingRenderer::CreateLayer(int width, int height)
+    {
+        if (!mLayers)
+        {
+            return nullptr;
+        }
+
+        mLayersCreated++;
+        auto layer = make_unique<CCountingLayer>();
+        mLastLayer = layer.get();
+        return layer;
+    }
+
+	TEST_CLASS(CTileLayerTest)
+	{
+	public:
+
+		TEST_METHOD_INITIALIZE(methodName)
+		{
+			extern wchar_t g_dir[];
+			::SetCurrentDirectory(g_dir);
+		}
+
+        /** Tests that tiles are drawn into the layer once and not again each frame
+         */
+        TEST_METHOD(TestCTileLayerCached)
+        {
+            CTowersGame game;
+            game.Load(L"levels/level1.xml");
+
+            int tiles = 0, others = 0;
+            for (auto item : game)
+            {
+                (item->IsStatic() ? tiles : others)++;
+            }
+            Assert::IsTrue(tiles > 0);
+
+            // The first update sets the scale from the first frame's size
+            CCountingRenderer renderer(true);
+            game.OnDraw(&renderer, 1024, 768);
+            game.Update(0);
+            game.OnDraw(&renderer, 1024, 768);
+            Assert::AreEqual(2, renderer.mLayersCreated);
+            Assert::AreEqual(tiles, renderer.mLastLayer->mRenderer.mImages);
+
+            renderer.mImages = 0;
+            for (int frame = 0; frame < 10; frame++)
+            {
+                game.Update(0);
+                game.OnDraw(&renderer, 1024, 768);
+            }
+            Assert::AreEqual(2, renderer.mLayersCreated, L"Layer reused");
+            Assert::AreEqual(12, renderer.mLayersDrawn);
+            Assert::AreEqual(others * 10, renderer.mImages, L"Only items that move drawn directly");
+
+            // A new window size draws the layer again
+            game.OnDraw(&renderer, 800, 600);
+            Assert::AreEqual(3, renderer.mLayersCreated);
+
+            // So does a new level
+            game.Load(L"levels/level1.xml");
+            game.OnDraw(&renderer, 800, 600);
+            Assert::AreEqual(4, renderer.mLayersCreated);
+        }
+
+        /** Tests that everything is drawn directly when the renderer has no layers
+         */
+        TEST_METHOD(TestCTileLayerUnsupported)
+        {
+            CTowersGame game;
+            game.Load(L"levels/level1.xml");
+
+            int items = 0;
+            for (auto item : game)
+            {
+                items++;
+            }
+
+            CCountingRenderer renderer;
+            game.OnDraw(&renderer, 1024, 768);
+            game.OnDraw(&renderer, 1024, 768);
+            Assert::AreEqual(0, renderer.mLayersDrawn);
+            Assert::AreEqual(items * 2, renderer.mImages);
+        }
+	};
+}
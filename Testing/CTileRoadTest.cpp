@@ -0,0 +1,148 @@
+#include "pch.h"
+#include "CppUnitTest.h"
+
+#include "TowersGame.h"
+#include "TileRoad.h"
+#include "LevelGenerator.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace std;
+
+namespace Testing
+{
+	/**
+	 * Load a generated level with no towers and start it
+	 * @param game Game to load the level into
+	 */
+	static void StartGeneratedLevel(CTowersGame& game)
+	{
+		CLevelGenerator generator;
+		generator.Write(L"road-test.xml");
+		game.Load(L"road-test.xml");
+		remove("road-test.xml");
+		game.StartLevel(0);
+	}
+
+	TEST_CLASS(CTileRoadTest)
+	{
+	public:
+
+		TEST_METHOD_INITIALIZE(methodName)
+		{
+			extern wchar_t g_dir[];
+			::SetCurrentDirectory(g_dir);
+		}
+
+        /** Tests that retired balloons leave the road and their handles stop matching
+         */
+        TEST_METHOD(TestCTileRoadRetire)
+        {
+            CTowersGame game;
+            StartGeneratedLevel(game);
+
+            auto road = game.GetStartRoad();
+            Assert::IsTrue(road != nullptr, L"Start road");
+
+            auto first = road->GenerateBalloon(-64, -64);
+            auto second = road->GenerateBalloon(-64, -64);
+            auto third = road->GenerateBalloon(-64, -64);
+            Assert::AreEqual((size_t)3, road->GetBalloons().size());
+
+            auto popped = road->GetBalloon(second);
+            Assert::IsTrue(popped != nullptr);
+            road->PopBalloon(popped);
+
+            // Popped balloons stay until they are retired
+            Assert::IsTrue(road->GetBalloon(second) == popped);
+
+            auto last = road->GetBalloon(third);
+            road->RetireBalloons();
+            Assert::AreEqual((size_t)2, road->GetBalloons().size());
+            Assert::IsTrue(road->GetBalloon(second) == nullptr, L"Stale handle");
+            Assert::IsTrue(road->GetBalloon(first) != nullptr);
+            Assert::IsTrue(road->GetBalloon(third) == last, L"Moved balloon still found");
+            Assert::IsTrue(road->GetBalloons()[1].get() == last, L"Last balloon swapped in");
+
+            // A new balloon may reuse the slot, but not the old handle
+            auto fourth = road->GenerateBalloon(-64, -64);
+            Assert::IsTrue(road->GetBalloon(second) == nullptr);
+            Assert::IsTrue(road->GetBalloon(fourth) != nullptr);
+            Assert::IsTrue(road->GetBalloon(CBalloon::Handle()) == nullptr);
+        }
+
+        /** Tests that a balloon popped by a tower is gone by the end of the update
+         */
+        TEST_METHOD(TestCTileRoadSameTick)
+        {
+            CTowersGame game;
+            StartGeneratedLevel(game);
+
+            auto road = game.GetStartRoad();
+            auto handle = road->GenerateBalloon(-64, -64);
+            auto balloon = road->GetBalloon(handle);
+
+            // Towers check against the hash built at the start of an update
+            game.Update(0);
+            Assert::AreEqual(1, game.CollisionCheck((int)balloon->GetX(), (int)balloon->GetY(), 10, false));
+            game.Update(0);
+
+            Assert::IsTrue(road->GetBalloon(handle) == nullptr);
+            Assert::IsTrue(road->GetBalloons().empty());
+        }
+
+        /** Tests that a balloon leaving the end of the road is not hit later in the same update
+         */
+        TEST_METHOD(TestCTileRoadLeakSameTick)
+        {
+            CTowersGame game;
+            StartGeneratedLevel(game);
+
+            auto road = game.GetStartRoad();
+            auto balloon = road->GetBalloon(road->GenerateBalloon(-64, -64));
+            game.Update(0);
+
+            // Where the hash will have it when it leaks
+            int x = (int)balloon->GetX();
+            int y = (int)balloon->GetY();
+            balloon->SetDistance(game.GetRoadPath().GetLength());
+
+            int count = game.GetBalloonCount();
+            game.Update(0);
+            Assert::IsTrue(road->GetBalloons().empty(), L"Leaked");
+
+            // A tower updating after the road still finds it in the hash
+            Assert::AreEqual(0, game.CollisionCheck(x, y, 10, false));
+            Assert::AreEqual(count - 1, game.GetBalloonCount());
+        }
+
+        /** Tests that a dart tower pops each balloon in reach once, for every set of kernels
+         */
+        TEST_METHOD(TestCTileRoadCollisionKernels)
+        {
+            for (SimdLevel level : { SimdLevel::Scalar, SimdLevel::Sse2, SimdLevel::Avx2 })
+            {
+                CTowersGame game;
+                StartGeneratedLevel(game);
+
+                auto road = game.GetStartRoad();
+                road->GetBalloonStore().SetSimdLevel(level);
+                auto near = road->GetBalloon(road->GenerateBalloon(-64, -64));
+                auto far = road->GetBalloon(road->GenerateBalloon(-64, -64));
+                far->SetDistance(game.GetRoadPath().GetLength() / 2);
+
+                // The first update places the balloons, the second hashes them there
+                game.Update(0);
+                game.Update(0);
+
+                int x = (int)near->GetX();
+                int y = (int)near->GetY();
+                Assert::AreEqual(1, game.CollisionCheck(x, y, 10, true));
+                Assert::IsFalse(near->GetRendering());
+                Assert::IsTrue(far->GetRendering());
+
+                // Popped balloons are not hit again
+                Assert::AreEqual(0, game.CollisionCheck(x, y, 10, false));
+            }
+        }
+	};
+}
@@ -42,9 +42,11 @@ namespace Testing
             center->SetLocation(grid * 10, grid * 17);
             city.Add(center);
 
+            // Neighbors are one grid spacing away on the square grid
+
             // Upper left
             auto ul = make_shared<CTileHouse>(&city);
-            ul->SetLocation(grid * 8, grid * 16);
+            ul->SetLocation(grid * 9, grid * 16);
             city.Add(ul);
             city.SortTiles();
 
@@ -53,17 +55,17 @@ namespace Testing
 
             // Upper right
             auto ur = make_shared<CTileHouse>(&city);
-            ur->SetLocation(grid * 12, grid * 16);
+            ur->SetLocation(grid * 11, grid * 16);
             city.Add(ur);
 
             // Lower left
             auto ll = make_shared<CTileHouse>(&city);
-            ll->SetLocation(grid * 8, grid * 18);
+            ll->SetLocation(grid * 9, grid * 18);
             city.Add(ll);
 
             // Lower right
             auto lr = make_shared<CTileHouse>(&city);
-            lr->SetLocation(grid * 12, grid * 18);
+            lr->SetLocation(grid * 11, grid * 18);
             city.Add(lr);
 
             city.SortTiles();
@@ -82,16 +84,18 @@ namespace Testing
 
             shared_ptr<CTileHouse> item1 = make_shared<CTileHouse>(&game);
             item1->SetLocation(100, 200);
+            item1->SetImage(L"grass1.png");
             game.Add(item1);
 
             Assert::IsTrue(game.HitTest(100, 200) == item1,
                 L"Testing item at 100, 200");
 
             Assert::IsTrue(game.HitTest(10, 10) == nullptr,
-                L"Testing no image");
+                L"Testing away from the image");
 
             shared_ptr<CTileHouse> item2 = make_shared<CTileHouse>(&game);
             item2->SetLocation(100, 200);
+            item2->SetImage(L"grass1.png");
             game.Add(item2);
 
             Assert::IsTrue(game.HitTest(100, 200) == item2,
@@ -0,0 +1,78 @@
+#include "pch.h"
+#include "CppUnitTest.h"
+
+#include <cstdio>
+#include "Trace.h"
+#include "FileUtils.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace std;
+
+namespace Testing
+{
+	TEST_CLASS(CTraceTest)
+	{
+	public:
+
+		TEST_METHOD_INITIALIZE(methodName)
+		{
+			extern wchar_t g_dir[];
+			::SetCurrentDirectory(g_dir);
+		}
+
+        /** Tests that recorded events end up in a complete trace file
+         */
+        TEST_METHOD(TestCTraceWrite)
+        {
+            auto& trace = CTrace::Instance();
+            Assert::IsFalse(trace.IsRecording());
+            Assert::IsTrue(trace.Start(L"test-trace.json"));
+            Assert::IsTrue(trace.IsRecording());
+
+            {
+                CTraceSpan span("Outer");
+                CTraceSpan inner("Inner");
+                trace.Instant("Something");
+            }
+
+            trace.Stop();
+            Assert::IsFalse(trace.IsRecording());
+
+            // Not recording, so this is not in the file
+            trace.Instant("Late");
+
+            string json;
+            Assert::IsTrue(ReadFileContents(L"test-trace.json", json));
+            remove("test-trace.json");
+
+            Assert::IsTrue(json.find("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[") == 0);
+            Assert::IsTrue(json.find("\"name\":\"Outer\",\"ph\":\"X\"") != string::npos);
+            Assert::IsTrue(json.find("\"name\":\"Inner\",\"ph\":\"X\"") != string::npos);
+            Assert::IsTrue(json.find("\"name\":\"Something\",\"ph\":\"i\"") != string::npos);
+            Assert::IsTrue(json.find("Late") == string::npos);
+            Assert::IsTrue(json.find("]}") == json.size() - 3);
+
+            // Inner ends first so is recorded before Outer
+            Assert::IsTrue(json.find("Inner") < json.find("Outer"));
+        }
+
+        /** Tests that spans are not recorded without a trace running
+         */
+        TEST_METHOD(TestCTraceNotRecording)
+        {
+            {
+                CTraceSpan span("Ignored");
+            }
+
+            Assert::IsTrue(CTrace::Instance().Start(L"test-trace.json"));
+            CTrace::Instance().Stop();
+
+            string json;
+            Assert::IsTrue(ReadFileContents(L"test-trace.json", json));
+            remove("test-trace.json");
+
+            Assert::IsTrue(json.find("Ignored") == string::npos);
+            Assert::IsTrue(json.find("\"traceEvents\":[\n\n]}") != string::npos);
+        }
+	};
+}
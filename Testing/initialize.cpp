@@ -1,6 +1,11 @@
 #include "pch.h"
 #include "CppUnitTest.h"
 
+#include "ImageCache.h"
+#ifdef _WIN32
+#include "GdiplusImage.h"
+#endif
+
 using namespace Microsoft::VisualStudio::CppUnitTestFramework;
 
 // This is a bit of a hack due to a stupid design decision
@@ -12,17 +17,28 @@ using namespace Microsoft::VisualStudio::CppUnitTestFramework;
 // to teach test, so it is where the data lives. It takes a global
 // variable to do so, which is really sad, but that avoids adding 
 // a header every test will have to include.
+#ifdef _WIN32
 wchar_t g_dir[1000]; 
+#else
+// The tests declare g_dir at block scope inside namespace Testing,
+// which the standard places in that namespace rather than globally
+namespace Testing { wchar_t g_dir[1000]; }
+#endif
 
 namespace Testing
 {		
+#ifdef _WIN32
     ULONG_PTR           gdiplusToken;
+#endif
 
     TEST_MODULE_INITIALIZE(Initialize)
     {
+#ifdef _WIN32
         Gdiplus::GdiplusStartupInput gdiplusStartupInput;
         // Initialize GDI+.
         Gdiplus::GdiplusStartup(&gdiplusToken, &gdiplusStartupInput, NULL);
+        CImageCache::Instance().SetLoader(std::make_shared<CGdiplusImageLoader>());
+#endif
 
         ::SetCurrentDirectory(L"..");
         ::GetCurrentDirectory(sizeof(g_dir) / sizeof(wchar_t), g_dir);
@@ -30,7 +46,10 @@ namespace Testing
 
     TEST_MODULE_CLEANUP(Cleanup)
     {
+        CImageCache::Instance().Clear();
+#ifdef _WIN32
         Gdiplus::GdiplusShutdown(gdiplusToken);
+#endif
     }
 
 	TEST_CLASS(UnitTest1)
@@ -0,0 +1,242 @@
+/**
+ * \file CppUnitTest.h
+ *
+ * \author Morgan Mundell
+ *
+ *  Minimal stand in for the Visual Studio unit test framework
+ *
+ * Lets the test files written for the Visual Studio test runner
+ * build and run unchanged on platforms without it. Only the parts
+ * of the framework our tests use are provided.
+ */
+
+#pragma once
+
+#include <cmath>
+#include <cstdlib>
+#include <cwchar>
+#include <functional>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <unistd.h>
+
+namespace Microsoft { namespace VisualStudio { namespace CppUnitTestFramework {
+
+    /// Thrown when an assertion fails
+    struct AssertFailure
+    {
+        /// Description of the failure
+        std::wstring mMessage;
+    };
+
+    /// A test method registered with the runner
+    struct TestMethod
+    {
+        /// Name of the test class
+        const char* mClass;
+
+        /// Name of the test method
+        const char* mMethod;
+
+        /// Runs the test
+        std::function<void()> mRun;
+    };
+
+    /**
+     * All registered test methods
+     * @returns Collection of tests in registration order
+     */
+    inline std::vector<TestMethod>& Tests()
+    {
+        static std::vector<TestMethod> tests;
+        return tests;
+    }
+
+    /**
+     * Module initialize and cleanup functions
+     * @param initialize True for initialize, false for cleanup
+     * @returns Collection of functions
+     */
+    inline std::vector<void(*)()>& ModuleHooks(bool initialize)
+    {
+        static std::vector<void(*)()> initializers;
+        static std::vector<void(*)()> cleanups;
+        return initialize ? initializers : cleanups;
+    }
+
+    /// Registers a module initialize or cleanup function
+    struct ModuleHook
+    {
+        /**
+         * Constructor
+         * @param function Function to register
+         * @param initialize True for initialize, false for cleanup
+         */
+        ModuleHook(void(*function)(), bool initialize) { ModuleHooks(initialize).push_back(function); }
+    };
+
+    /// Base class for test classes
+    template<class T>
+    class TestClass
+    {
+    public:
+        /// The derived test class
+        typedef T ThisClass;
+
+        virtual ~TestClass() {}
+
+        /// Called before every test method
+        virtual void TestShimInitialize() {}
+    };
+
+    /// Assertions used by the tests
+    class Assert
+    {
+    public:
+        /**
+         * Fail the test unless the condition is true
+         * @param condition Condition to test
+         * @param message Optional message
+         */
+        static void IsTrue(bool condition, const wchar_t* message = nullptr)
+        {
+            if (!condition)
+            {
+                Fail(L"Assert::IsTrue failed", message);
+            }
+        }
+
+        /**
+         * Fail the test unless the condition is false
+         * @param condition Condition to test
+         * @param message Optional message
+         */
+        static void IsFalse(bool condition, const wchar_t* message = nullptr)
+        {
+            if (condition)
+            {
+                Fail(L"Assert::IsFalse failed", message);
+            }
+        }
+
+        /**
+         * Fail the test unless two values are equal
+         * @param expected Expected value
+         * @param actual Actual value
+         * @param message Optional message
+         */
+        template<class T>
+        static void AreEqual(const T& expected, const T& actual, const wchar_t* message = nullptr)
+        {
+            if (!(expected == actual))
+            {
+                std::wstringstream str;
+                str << L"Assert::AreEqual failed. Expected <" << expected << L"> Actual <" << actual << L">";
+                Fail(str.str(), message);
+            }
+        }
+
+        /**
+         * Fail the test unless two doubles are within a tolerance
+         * @param expected Expected value
+         * @param actual Actual value
+         * @param tolerance Largest allowed difference
+         * @param message Optional message
+         */
+        static void AreEqual(double expected, double actual, double tolerance, const wchar_t* message = nullptr)
+        {
+            if (std::fabs(expected - actual) > tolerance)
+            {
+                std::wstringstream str;
+                str << L"Assert::AreEqual failed. Expected <" << expected << L"> Actual <" << actual << L">";
+                Fail(str.str(), message);
+            }
+        }
+
+    private:
+        /**
+         * Throw an assertion failure
+         * @param what Description of the assertion
+         * @param message Optional message from the test
+         */
+        static void Fail(const std::wstring& what, const wchar_t* message)
+        {
+            AssertFailure failure;
+            failure.mMessage = what;
+            if (message != nullptr)
+            {
+                failure.mMessage += std::wstring(L" - ") + message;
+            }
+            throw failure;
+        }
+    };
+
+}}}
+
+/// Declare a test class
+#define TEST_CLASS(className) \
+    class className; \
+    inline const char* TestShimClassName(className*) { return #className; } \
+    class className : public ::Microsoft::VisualStudio::CppUnitTestFramework::TestClass<className>
+
+/// Declare a test method
+#define TEST_METHOD(methodName) \
+    struct methodName##_Registrar \
+    { \
+        methodName##_Registrar() \
+        { \
+            ::Microsoft::VisualStudio::CppUnitTestFramework::Tests().push_back({ \
+                TestShimClassName((ThisClass*)nullptr), #methodName, \
+                []() { ThisClass test; test.TestShimInitialize(); test.methodName(); } }); \
+        } \
+    }; \
+    inline static methodName##_Registrar methodName##_registrar; \
+    void methodName()
+
+/// Declare a function called before every test method in a class
+#define TEST_METHOD_INITIALIZE(methodName) \
+    void TestShimInitialize() override { methodName(); } \
+    void methodName()
+
+/// Declare a function called before any test runs
+#define TEST_MODULE_INITIALIZE(functionName) \
+    static void functionName(); \
+    static ::Microsoft::VisualStudio::CppUnitTestFramework::ModuleHook functionName##_hook(&functionName, true); \
+    static void functionName()
+
+/// Declare a function called after all tests have run
+#define TEST_MODULE_CLEANUP(functionName) \
+    static void functionName(); \
+    static ::Microsoft::VisualStudio::CppUnitTestFramework::ModuleHook functionName##_hook(&functionName, false); \
+    static void functionName()
+
+/**
+ * Change the current directory
+ * @param path New directory
+ * @returns Nonzero on success
+ */
+inline int SetCurrentDirectory(const wchar_t* path)
+{
+    std::string narrow(std::wcslen(path) * 4 + 1, '\0');
+    narrow.resize(std::wcstombs(&narrow[0], path, narrow.size()));
+    return chdir(narrow.c_str()) == 0;
+}
+
+/**
+ * Get the current directory
+ * @param size Size of the buffer in characters
+ * @param path Buffer that receives the directory
+ * @returns Length of the directory name or zero on failure
+ */
+inline unsigned long GetCurrentDirectory(unsigned long size, wchar_t* path)
+{
+    char narrow[4096];
+    if (getcwd(narrow, sizeof(narrow)) == nullptr)
+    {
+        return 0;
+    }
+
+    size_t len = std::mbstowcs(path, narrow, size);
+    return len == (size_t)-1 ? 0 : (unsigned long)len;
+}
@@ -0,0 +1,72 @@
+/**
+ * \file TestMain.cpp
+ *
+ * \author Morgan Mundell
+ *
+ *  Runs the tests registered through the CppUnitTest.h stand in
+ *
+ * With no arguments every test runs. Otherwise only the tests in
+ * the named test classes run, so each class can be its own test.
+ */
+
+#include <cstring>
+#include <iostream>
+#include "CppUnitTest.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace std;
+
+/**
+ * Run the registered tests
+ * @param argc Number of arguments
+ * @param argv Names of the test classes to run
+ * @returns Number of failed tests
+ */
+int main(int argc, char* argv[])
+{
+    for (auto hook : ModuleHooks(true))
+    {
+        hook();
+    }
+
+    int run = 0;
+    int failed = 0;
+    for (auto& test : Tests())
+    {
+        bool selected = argc < 2;
+        for (int i = 1; i < argc; i++)
+        {
+            selected = selected || strcmp(argv[i], test.mClass) == 0;
+        }
+
+        if (!selected)
+        {
+            continue;
+        }
+
+        run++;
+        try
+        {
+            test.mRun();
+            wcout << L"Passed " << test.mClass << L"::" << test.mMethod << endl;
+        }
+        catch (const AssertFailure& failure)
+        {
+            failed++;
+            wcout << L"FAILED " << test.mClass << L"::" << test.mMethod << L": " << failure.mMessage << endl;
+        }
+        catch (const exception& ex)
+        {
+            failed++;
+            wcout << L"FAILED " << test.mClass << L"::" << test.mMethod << L": " << ex.what() << endl;
+        }
+    }
+
+    for (auto hook : ModuleHooks(false))
+    {
+        hook();
+    }
+
+    wcout << run - failed << L" of " << run << L" tests passed" << endl;
+    return run == 0 ? 1 : failed;
+}
@@ -28,7 +28,7 @@ public:
 	CAirship(const CAirship&) = delete;
 
 
-	void Draw(Gdiplus::Graphics* graphics, int offsetX, int offsetY);
+	void Draw(CRenderer* graphics, int offsetX, int offsetY);
 
 
 	virtual void Update(double elapsed) override;
@@ -43,17 +43,24 @@ public:
 	 * Method Disabled (no entities are drawn on/in balloon entities)
 	 * @param graphics The graphics 
 	 */
-	virtual void RenderEntities(Gdiplus::Graphics* graphics) {};
+	virtual void RenderEntities(CRenderer* graphics) {};
 
-	/** 
-	 * Sets the angular offset to determine rotation of dart
-	 * @param newAngle The new angular offset 
-	 */
-	void SetAngle(double newAngle) { mAngle = newAngle; }
+	/// Compass directions towers fire in, each with an image turned to it
+	static const int Sectors = 8;
+
+	void SetAngle(double newAngle);
+
+	virtual void Reset() override;
 
 private:
-	/// The image of this ship
-	std::unique_ptr<Gdiplus::Bitmap> mItemImage; 
+	/// The image of this ship, shared through the image cache
+	std::shared_ptr<CGameImage> mItemImage; 
+
+	/// The image turned to mAngle, shared through the image cache
+	std::shared_ptr<CGameImage> mRotatedImage;
+
+	/// The image turned to each firing direction, found when the ship is made
+	std::shared_ptr<CGameImage> mSectorImages[Sectors];
 
 	/// The angle of this dart
 	double mAngle = 0; 
@@ -0,0 +1,86 @@
+/**
+ * \file BackBuffer.cpp
+ *
+ * \author Morgan Mundell
+ */
+
+#include "pch.h"
+#include "BackBuffer.h"
+#include "Profiler.h"
+
+using namespace std;
+using namespace Gdiplus;
+
+/**
+ * Destructor
+ */
+CBackBuffer::~CBackBuffer()
+{
+    Release();
+}
+
+/**
+ * Get the back buffer ready to draw a frame.
+ *
+ * The bitmap is made again only if the size has changed.
+ * @param dc Device context of the window being painted
+ * @param width Width of the window's client area
+ * @param height Height of the window's client area
+ * @returns GDI+ graphics to draw the frame with
+ */
+Graphics* CBackBuffer::Begin(CDC* dc, int width, int height)
+{
+    mNew = mGraphics == nullptr || width != mWidth || height != mHeight;
+    if (mNew)
+    {
+        Release();
+
+        mWidth = width;
+        mHeight = height;
+
+        mDC.CreateCompatibleDC(dc);
+        mBitmap.CreateCompatibleBitmap(dc, max(width, 1), max(height, 1));
+        mOldBitmap = mDC.SelectObject(&mBitmap);
+        mGraphics = make_unique<Graphics>(mDC.m_hDC);
+    }
+
+    return mGraphics.get();
+}
+
+/**
+ * Copy part of the frame in the back buffer to the window
+ * @param dc Device context of the window being painted
+ * @param rect Part of the window to copy
+ */
+void CBackBuffer::Present(CDC* dc, const CRect& rect)
+{
+    CProfileScope profile(CProfiler::Blit);
+
+    if (mGraphics != nullptr)
+    {
+        mGraphics->Flush(FlushIntentionSync);
+        dc->BitBlt(rect.left, rect.top, rect.Width(), rect.Height(), &mDC, rect.left, rect.top, SRCCOPY);
+    }
+}
+
+/**
+ * Free the bitmap and everything on it.
+ *
+ * Must be called before GDI+ is shut down if the buffer
+ * would otherwise outlive it.
+ */
+void CBackBuffer::Release()
+{
+    mGraphics = nullptr;
+
+    if (mDC.m_hDC != nullptr)
+    {
+        mDC.SelectObject(mOldBitmap);
+        mDC.DeleteDC();
+    }
+
+    mBitmap.DeleteObject();
+    mOldBitmap = nullptr;
+    mWidth = 0;
+    mHeight = 0;
+}
@@ -0,0 +1,64 @@
+/**
+ * \file BackBuffer.h
+ *
+ * \author Morgan Mundell
+ *
+ *  Offscreen bitmap the window is painted into before it is shown
+ */
+
+#pragma once
+
+#include <memory>
+
+/**
+ * Back buffer for flicker free painting that lasts as long as the window.
+ *
+ * Each frame is drawn into a memory bitmap and then copied to the
+ * screen in one go. The bitmap, its device context and the GDI+
+ * graphics on it are only created again when the window changes
+ * size, not on every paint.
+ */
+class CBackBuffer
+{
+public:
+    CBackBuffer() {}
+
+    ///  Copy constructor (disabled)
+    CBackBuffer(const CBackBuffer&) = delete;
+
+    ~CBackBuffer();
+
+    Gdiplus::Graphics* Begin(CDC* dc, int width, int height);
+
+    void Present(CDC* dc, const CRect& rect);
+
+    void Release();
+
+    /**
+     * Did the last Begin make a new bitmap?
+     * @returns True if nothing from earlier frames is in the buffer
+     */
+    bool IsNew() const { return mNew; }
+
+private:
+    /// Memory device context the bitmap is selected into
+    CDC mDC;
+
+    /// The offscreen bitmap
+    CBitmap mBitmap;
+
+    /// Bitmap the memory device context had before ours
+    CBitmap* mOldBitmap = nullptr;
+
+    /// GDI+ graphics on the memory device context
+    std::unique_ptr<Gdiplus::Graphics> mGraphics;
+
+    /// Width of the bitmap in pixels
+    int mWidth = 0;
+
+    /// Height of the bitmap in pixels
+    int mHeight = 0;
+
+    /// True if the last Begin made a new bitmap
+    bool mNew = false;
+};
@@ -9,14 +9,19 @@
  */
 
 #include "pch.h"
+#include <cmath>
 #include "Balloon.h"
+#include "ImageCache.h"
+#include "TowersGame.h"
 
 using namespace std;
-using namespace Gdiplus;
 
 /// Default image
 const wstring EmptyImage = L"red-balloon.png";
 
+/// Speed of a balloon along the road in virtual pixels per second (two tiles a second)
+const double BalloonSpeed = 128;
+
 
 /**
  * Constructor. Sets the balloon image.
@@ -26,53 +31,51 @@ CBalloon::CBalloon(CTowersGame* item) : CEntity(item)
 {
     // Set an image
     wstring filename = ImagesDirectory + EmptyImage;
-    mItemImage = std::unique_ptr<Gdiplus::Bitmap>(Gdiplus::Bitmap::FromFile(filename.c_str()));
-    Status sh = mItemImage->GetLastStatus();
-    if (mItemImage->GetLastStatus() != Ok)
+    mItemImage = CImageCache::Instance().Get(filename);
+    if (mItemImage == nullptr)
     {
         wstring msg(L"Failed to open ");
         msg += EmptyImage;
-        AfxMessageBox(msg.c_str());
+        GetGame()->ShowMessage(msg);
         return;
     }
 
-    // Set a random color for the image
-
-    // Random seed
-    srand(time(NULL));
+    // Set a random color for the image, from the game's
+    // random numbers so a seeded game always looks the same
+    CTowersGame* game = GetGame();
 
-    for (size_t i = 0; i < 5; i++) 
+    float tint[3];
+    for (size_t i = 0; i < 3; i++)
     {
-        for (size_t u = 0; u < 5; u++)
-        {
-            if (i == 4 && u == 4 || i == 3 && u == 3)
-            {
-                mColorMatrix.m[i][u] = 1;
-            } 
-            else if (i == u)
-            {
-                mColorMatrix.m[i][u] = (float)rand() / RAND_MAX;
-            } 
-            else
-            {
-                mColorMatrix.m[i][u] = 0.0f;
-            }
-        }
+        tint[i] = (float)game->Random();
     }
 
-    float primaryColor = (float)rand() / RAND_MAX;
+    float primaryColor = (float)game->Random();
 
     if (primaryColor < 0.33)
     {
-        mColorMatrix.m[0][0] = 1; // Primarily-red balloon.
+        tint[0] = 1; // Primarily-red balloon.
     }
     else if (primaryColor < 0.66)
     {
-        mColorMatrix.m[1][1] = 1; // Primarily-green balloon.
+        tint[1] = 1; // Primarily-green balloon.
     }
     else
     {
-        mColorMatrix.m[2][2] = 1; // Primarily-blue balloon.
+        tint[2] = 1; // Primarily-blue balloon.
+    }
+
+    // Round to a few levels per channel so balloons share a
+    // small set of tinted images made once by the cache
+    for (size_t i = 0; i < 3; i++)
+    {
+        tint[i] = (float)(round(tint[i] * (TintLevels - 1)) / (TintLevels - 1));
+    }
+
+    auto tinted = CImageCache::Instance().GetTinted(filename, tint[0], tint[1], tint[2]);
+    if (tinted != nullptr)
+    {
+        mItemImage = tinted;
     }
 }
 
@@ -82,22 +85,29 @@ CBalloon::CBalloon(CTowersGame* item) : CEntity(item)
  * @param offsetX The X offset
  * @param offsetY The Y offset
  */
-void CBalloon::Draw(Gdiplus::Graphics* graphics, int offsetX, int offsetY)
+void CBalloon::Draw(CRenderer* graphics, int offsetX, int offsetY)
 {
-    int wid = mItemImage->GetWidth();
-    int hit = mItemImage->GetHeight();
-
-    mImageAttributes.SetColorMatrix(
-        &mColorMatrix, 
-        ColorMatrixFlagsDefault,
-        ColorAdjustTypeBitmap);
-
     if (mItemImage != nullptr) 
     {
-        graphics->DrawImage(
-            mItemImage.get(), 
-            Rect(GetX() + offsetX, GetY() + offsetY, wid, hit),
-            0, 0, wid, hit, UnitPixel, &mImageAttributes);
+        int wid = mItemImage->GetWidth();
+        int hit = mItemImage->GetHeight();
+
+        // Draw part way along the last step when the frame falls between updates
+        double x = GetX();
+        double y = GetY();
+        double alpha = GetGame()->GetDrawAlpha();
+        if (alpha > 0)
+        {
+            double prev = mStore != nullptr ? mStore->GetPrevDistance(mIndex) : mPrevDistance;
+            double distance = prev + (GetDistance() - prev) * alpha;
+            if (!GetGame()->GetRoadPath().Locate(distance, x, y))
+            {
+                x = GetX();
+                y = GetY();
+            }
+        }
+
+        graphics->DrawImage(mItemImage.get(), x + offsetX, y + offsetY, wid, hit);
     }
 }
 
@@ -107,10 +117,104 @@ CBalloon::~CBalloon()
 }
 
 /** 
- * Handle updates for animation. Overrides the CItem method
+ * Handle updates for animation. Overrides the CItem method.
+ *
+ * Balloons in a store are moved by the store with all the others.
  * @param elapsed The time since last update 
  */
 void CBalloon::Update(double elapsed)
 {
-    mT += 2 * elapsed; // change back to 2.0 pls
+    if (mStore == nullptr)
+    {
+        mPrevDistance = mDistance;
+        mDistance += BalloonSpeed * elapsed;
+    }
+}
+
+/**
+ * Move this balloon's moving state into a store.
+ *
+ * The balloon is added at the end of the store and
+ * reads and changes its state there from now on.
+ * @param store Store of the road the balloon is on
+ */
+void CBalloon::Attach(CBalloonStore* store)
+{
+    Detach();
+
+    mIndex = store->Add(mDistance, BalloonSpeed, CItem::GetX(), CItem::GetY());
+    store->Set(mIndex, CBalloonStore::Popped, !mRendered);
+    store->Set(mIndex, CBalloonStore::Deleted, mIsPopped);
+    mStore = store;
+}
+
+/**
+ * Copy this balloon's moving state back out of its store.
+ *
+ * Called before the balloon is removed from the store, so anything
+ * still holding the balloon sees it where it was last.
+ */
+void CBalloon::Detach()
+{
+    if (mStore == nullptr)
+    {
+        return;
+    }
+
+    mDistance = mStore->GetDistance(mIndex);
+    mPrevDistance = mStore->GetPrevDistance(mIndex);
+    mRendered = !mStore->Is(mIndex, CBalloonStore::Popped);
+    mIsPopped = mStore->Is(mIndex, CBalloonStore::Deleted);
+    CItem::SetLocation(mStore->GetX(mIndex), mStore->GetY(mIndex));
+    mStore = nullptr;
+}
+
+/**
+ * Test if this balloon is hit by a tower.
+ * @param x X location of the tower
+ * @param y Y location of the tower
+ * @param towerRadius The radius the tower reaches
+ * @param dartTower True if the tower fires darts
+ * @returns True if the tower hits this balloon
+ */
+bool CBalloon::InTowerRange(double x, double y, double towerRadius, bool dartTower) const
+{
+    return InTowerRange(GetX(), GetY(), x, y, towerRadius, dartTower);
+}
+
+/**
+ * Test if a balloon at a location is hit by a tower.
+ *
+ * Dart towers fire along the eight compass directions, so a balloon
+ * in range is only hit if it is near one of those lines.
+ * @param balloonX X location of the balloon
+ * @param balloonY Y location of the balloon
+ * @param x X location of the tower
+ * @param y Y location of the tower
+ * @param towerRadius The radius the tower reaches
+ * @param dartTower True if the tower fires darts
+ * @returns True if the tower hits the balloon
+ */
+bool CBalloon::InTowerRange(double balloonX, double balloonY, double x, double y, double towerRadius, bool dartTower)
+{
+    double dX = x - balloonX;
+    double dY = y - balloonY;
+    double distance2 = dX * dX + dY * dY;
+
+    if (!dartTower)
+    {
+        double reach = towerRadius + HitTolerance;
+        return distance2 <= reach * reach;
+    }
+
+    double reach = towerRadius + DartHitTolerance;
+    if (distance2 > reach * reach)
+    {
+        return false;
+    }
+
+    dX = abs(dX);   // the X in the first quadrant
+    dY = abs(dY);   // the Y in the first quadrant
+
+    return dX < DartHitTolerance || dY < DartHitTolerance || abs(dX - dY) < DartHitTolerance;
 }
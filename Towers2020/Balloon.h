@@ -9,13 +9,36 @@
 
 #pragma once
 #include "Entity.h"
+#include "BalloonStore.h"
 
  /**
   *  Implements a simple balloon with tiles we can manipulate
+  *
+  *  While on a road the balloon's location, distance and state live in
+  *  the road's CBalloonStore and the accessors here read them from there.
   */
 class CBalloon : public CEntity
 {
 public:
+	/**
+	 * Reference to a balloon on a road that can tell when the balloon is gone.
+	 *
+	 * The road reuses a slot for later balloons and moves on its
+	 * generation each time, so an old handle no longer matches.
+	 * Generations start at 1, so a default handle matches nothing.
+	 */
+	struct Handle
+	{
+		unsigned int mSlot = 0;         ///< Slot in the road's slot table
+		unsigned int mGeneration = 0;   ///< Generation of the slot when the balloon was added
+
+		/**
+		 * Do two handles refer to the same balloon?
+		 * @param other Handle to compare with
+		 * @returns True if the same
+		 */
+		bool operator==(const Handle& other) const { return mSlot == other.mSlot && mGeneration == other.mGeneration; }
+	};
 
 	CBalloon(CTowersGame* game);
 
@@ -34,102 +57,171 @@ public:
 	virtual void Accept(CItemVisitor* visitor) override { visitor->VisitBalloon(this); }
 
 	/** 
-	 * Used for getting the scalar T
-	 * \return A double scalar 
+	 * Get how far the balloon has travelled along the level's road
+	 * \return Distance in virtual pixels
 	 */
-	double GetT() const { return mT; }
+	double GetDistance() const { return mStore != nullptr ? mStore->GetDistance(mIndex) : mDistance; }
 
 	/** 
-	 * Used for setting the scalar T
-	 * @param t A double scalar 
+	 * Set how far the balloon has travelled along the level's road
+	 * @param distance Distance in virtual pixels
 	 */
-	void SetT(double t) { mT = t; }
+	void SetDistance(double distance)
+	{
+		if (mStore != nullptr)
+		{
+			mStore->SetDistance(mIndex, distance);
+		}
+		else
+		{
+			mDistance = distance;
+			mPrevDistance = distance;
+		}
+	}
 
-	/** Used to indicate if balloon is reverse
-	 * \return mReverse
+	/**
+	 * The X location of the balloon
+	 * @returns X location in virtual pixels
 	 */
-	bool IsReverse() { return mReverse; }
+	double GetX() const { return mStore != nullptr ? mStore->GetX(mIndex) : CItem::GetX(); }
 
-	/// Indicate the balloon is going forwards
-	void Forwards() { mReverse = false; }
+	/**
+	 * The Y location of the balloon
+	 * @returns Y location in virtual pixels
+	 */
+	double GetY() const { return mStore != nullptr ? mStore->GetY(mIndex) : CItem::GetY(); }
 
-	/// Indicate the balloon is going backwards
-	void Backwards() { mReverse = true; }
+	/**
+	 * Set the location of the balloon
+	 * @param x X location in virtual pixels
+	 * @param y Y location in virtual pixels
+	 */
+	void SetLocation(double x, double y)
+	{
+		if (mStore != nullptr)
+		{
+			mStore->SetLocation(mIndex, x, y);
+		}
+		else
+		{
+			CItem::SetLocation(x, y);
+		}
+	}
 
 	/**
 	 * Indicates if the balloon is popped.
 	 * @returns If the balloon has been popped by a tower
 	 */
-	bool IsBeingDeleted() { return mIsPopped;  }
+	bool IsBeingDeleted() const { return mStore != nullptr ? mStore->Is(mIndex, CBalloonStore::Deleted) : mIsPopped; }
 
 	/**
 	* Set the pop status of the balloon. Does not delete the balloon.
 	* @param popped True if the balloon is already popped (queued for deletion)
 	*/
-	void SetIsDeleted(bool popped) { mIsPopped = popped;  }
+	void SetIsDeleted(bool popped)
+	{
+		if (mStore != nullptr)
+		{
+			mStore->Set(mIndex, CBalloonStore::Deleted, popped);
+		}
+		else
+		{
+			mIsPopped = popped;
+		}
+	}
 
 	/**
-	 * Sets when the balloon has been transferred / processed
-	 * @param hasTransferred True if not processed, false if the balloon has been.
+	 * Sets when the balloon has been hit
+	 * @param rendering False if balloon has been hit
 	 */
-	void SetHasTransferred(bool hasTransferred) { mHasTransferred = hasTransferred; }
+	void SetRendering(bool rendering)
+	{
+		if (mStore != nullptr)
+		{
+			mStore->Set(mIndex, CBalloonStore::Popped, !rendering);
+		}
+		else
+		{
+			mRendered = rendering;
+		}
+	}
 
 	/**
-	 * Indicates if the balloon has been transferred / processed
-	 * @returns True if not processed, false if the balloon has been.
+	 * Indicates if the balloon should be rendered
+	 * @returns True if balloon should be rendered
 	 */
-	bool HasTransferred() { return mHasTransferred; }
+	bool GetRendering() const { return mStore != nullptr ? !mStore->Is(mIndex, CBalloonStore::Popped) : mRendered; }
+
+	void Attach(CBalloonStore* store);
+
+	void Detach();
 
 	/**
-	 * Sets when the balloon has been hit
-	 * @param rendering False if balloon has been hit
+	 * Tell the balloon where it moved to in its store
+	 * @param index New index in the store
 	 */
-	void SetRendering(bool rendering) { mRendered = rendering; }
+	void SetStoreIndex(size_t index) { mIndex = index; }
 
 	/**
-	 * Indicates if the balloon should be rendered
-	 * @returns True if balloon should be rendered
+	 * Get the handle the road refers to this balloon by
+	 * @returns Handle, a default handle if not on a road
+	 */
+	Handle GetHandle() const { return mHandle; }
+
+	/**
+	 * Set the handle the road refers to this balloon by
+	 * @param handle The new handle
 	 */
-	bool GetRendering() { return mRendered; }
+	void SetHandle(Handle handle) { mHandle = handle; }
 
 	virtual void Update(double elapsed) override;
+
+	bool InTowerRange(double x, double y, double towerRadius, bool dartTower) const;
+
+	static bool InTowerRange(double balloonX, double balloonY, double x, double y, double towerRadius, bool dartTower);
 	
-	void Draw(Gdiplus::Graphics* graphics, int offsetX, int offsetY);
+	void Draw(CRenderer* graphics, int offsetX, int offsetY);
 
 	/**
 	 * Method Disabled (no entities are drawn on/in balloon entities)
 	 * @param graphics The graphics 
 	 */
-	virtual void RenderEntities(Gdiplus::Graphics* graphics) {};
+	virtual void RenderEntities(CRenderer* graphics) {};
 
-private:
+	/// Distance beyond a tower's radius at which a balloon is still hit
+	static const int HitTolerance = 24;
 
-	/// Image of Item
-	std::shared_ptr<Gdiplus::Bitmap> mItemImage;
+	/// Distance beyond a dart tower's radius at which a balloon is still hit
+	static const int DartHitTolerance = 30;
 
-	/// The scalar T used for keeping track of the position of a balloon on a road tile
-	double mT = 0.00;
+	/// Levels each color channel of a balloon's tint is rounded to
+	static const int TintLevels = 8;
 
-	/// Indicates if the balloon has moved from one tile to another
-	bool mHasTransferred = false;
+private:
+
+	/// Image of Item, shared through the image cache
+	std::shared_ptr<CGameImage> mItemImage;
 
-	/// True if a balloon must path in the opposite direction. Ex: WN on a Northwest tile
-	bool mReverse = false;
+	/// Distance the balloon has travelled along the level's road
+	double mDistance = 0.00;
 
-	/// The file for this item
-	std::wstring mFile;
+	/// Distance along the road before the last update, for interpolation
+	double mPrevDistance = 0.00;
 
 	/// Is the Ballon popped or not
 	bool mIsPopped = false;  
 
-	/// Used for color transformation of defualt balloon image
-	Gdiplus::ColorMatrix mColorMatrix;
-
-	/// Used for setting the colors of different balloon images
-	Gdiplus::ImageAttributes mImageAttributes;
-
 	/// Used to determine if a balloon should render
 	bool mRendered = true;
 
+	/// Handle the road refers to this balloon by
+	Handle mHandle;
+
+	/// Store holding this balloon's moving state while it is on a road
+	CBalloonStore* mStore = nullptr;
+
+	/// Index of this balloon in mStore
+	size_t mIndex = 0;
+
 };
 
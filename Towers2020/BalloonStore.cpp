@@ -0,0 +1,391 @@
+/**
+ * \file BalloonStore.cpp
+ *
+ * \author Morgan Mundell
+ */
+
+#include "pch.h"
+#include <algorithm>
+#include <cmath>
+#include "BalloonStore.h"
+
+#ifdef TOWERS_SIMD_X86
+#include <emmintrin.h>
+#endif
+
+using namespace std;
+
+/**
+ * Add a balloon at the end of the store
+ * @param distance Distance along the road
+ * @param speed Speed along the road in virtual pixels per second
+ * @param x X location
+ * @param y Y location
+ * @returns Index of the new balloon
+ */
+size_t CBalloonStore::Add(double distance, double speed, double x, double y)
+{
+    mDistance.push_back(distance);
+    mPrevDistance.push_back(distance);
+    mSpeed.push_back(speed);
+    mX.push_back(x);
+    mY.push_back(y);
+    mSegment.push_back(0);
+    mState.push_back(0);
+    return mDistance.size() - 1;
+}
+
+/**
+ * Remove a balloon by moving the last balloon into its place
+ * @param index Index of the balloon to remove
+ */
+void CBalloonStore::Remove(size_t index)
+{
+    size_t last = mDistance.size() - 1;
+    if (index != last)
+    {
+        mDistance[index] = mDistance[last];
+        mPrevDistance[index] = mPrevDistance[last];
+        mSpeed[index] = mSpeed[last];
+        mX[index] = mX[last];
+        mY[index] = mY[last];
+        mSegment[index] = mSegment[last];
+        mState[index] = mState[last];
+    }
+
+    mDistance.pop_back();
+    mPrevDistance.pop_back();
+    mSpeed.pop_back();
+    mX.pop_back();
+    mY.pop_back();
+    mSegment.pop_back();
+    mState.pop_back();
+}
+
+/**
+ * Remove all balloons, keeping the storage
+ */
+void CBalloonStore::Clear()
+{
+    mDistance.clear();
+    mPrevDistance.clear();
+    mSpeed.clear();
+    mX.clear();
+    mY.clear();
+    mSegment.clear();
+    mState.clear();
+}
+
+/**
+ * Move every balloon along the road at its speed
+ * @param elapsed Time to move for in seconds
+ */
+void CBalloonStore::Advance(double elapsed)
+{
+    switch (mSimdLevel)
+    {
+    case SimdLevel::Avx2:
+        AdvanceAvx2(mDistance.data(), mPrevDistance.data(), mSpeed.data(), mDistance.size(), elapsed);
+        break;
+
+    case SimdLevel::Sse2:
+        AdvanceSse2(mDistance.data(), mPrevDistance.data(), mSpeed.data(), mDistance.size(), elapsed);
+        break;
+
+    default:
+        AdvanceScalar(mDistance.data(), mPrevDistance.data(), mSpeed.data(), mDistance.size(), elapsed);
+        break;
+    }
+}
+
+/**
+ * Put every balloon at its distance along a path.
+ *
+ * Balloons at or past the end of the path are left where they
+ * are, the same as CRoadPath::Locate does.
+ * @param path The road compiled into a path
+ */
+void CBalloonStore::Place(const CRoadPath& path)
+{
+    auto& segments = path.GetSegments();
+    if (segments.empty())
+    {
+        return;
+    }
+
+    // Balloons only move forward, so each looks for its segment
+    // from the one it was on and only searches if it went back
+    int last = (int)segments.size() - 1;
+    for (size_t i = 0; i < mDistance.size(); i++)
+    {
+        double distance = mDistance[i];
+        int segment = mSegment[i];
+        if (segment > last || distance < segments[segment].mStart)
+        {
+            auto after = upper_bound(segments.begin(), segments.end(), distance,
+                [](double d, const CRoadPath::Segment& s) { return d < s.mStart; });
+            segment = after == segments.begin() ? 0 : (int)(after - segments.begin()) - 1;
+        }
+
+        while (segment < last && distance >= segments[segment + 1].mStart)
+        {
+            segment++;
+        }
+
+        mSegment[i] = segment;
+    }
+
+    switch (mSimdLevel)
+    {
+    case SimdLevel::Avx2:
+        PlaceAvx2(mDistance.data(), mSegment.data(), segments.data(), path.GetLength(),
+            mX.data(), mY.data(), mDistance.size());
+        break;
+
+    case SimdLevel::Sse2:
+        PlaceSse2(mDistance.data(), mSegment.data(), segments.data(), path.GetLength(),
+            mX.data(), mY.data(), mDistance.size());
+        break;
+
+    default:
+        PlaceScalar(mDistance.data(), mSegment.data(), segments.data(), path.GetLength(),
+            mX.data(), mY.data(), mDistance.size());
+        break;
+    }
+}
+
+/**
+ * Test balloon locations against a tower.
+ *
+ * A balloon is hit if it is within reach of the tower. A dart tower
+ * fires along the eight compass directions, so with a sector given a
+ * balloon must also be closer than that to one of those lines. The
+ * locations need not be a store's own, the game tests the balloons
+ * near a tower where its spatial hash has them.
+ * @param x X locations of the balloons
+ * @param y Y locations of the balloons
+ * @param count Number of balloons
+ * @param towerX X location of the tower
+ * @param towerY Y location of the tower
+ * @param reach Distance from the tower a balloon is hit at
+ * @param sector Distance from a firing line a balloon is hit at, 0 for any direction
+ * @param level Set of kernels to use, lowered to what the processor has
+ * @param hits Set to a bit for each balloon, set if hit, balloon i in bit i % 64 of word i / 64
+ */
+void CBalloonStore::HitTest(const double* x, const double* y, size_t count, double towerX, double towerY,
+    double reach, double sector, SimdLevel level, vector<uint64_t>& hits)
+{
+    hits.assign((count + 63) / 64, 0);
+
+    switch (level <= GetSimdLevel() ? level : GetSimdLevel())
+    {
+    case SimdLevel::Avx2:
+        HitTestAvx2(x, y, 0, count, towerX, towerY, reach, sector, hits.data());
+        break;
+
+    case SimdLevel::Sse2:
+        HitTestSse2(x, y, 0, count, towerX, towerY, reach, sector, hits.data());
+        break;
+
+    default:
+        HitTestScalar(x, y, 0, count, towerX, towerY, reach, sector, hits.data());
+        break;
+    }
+}
+
+/**
+ * Move balloons along the road one at a time.
+ *
+ * The reference the vector kernels must match exactly.
+ * @param distance Distances, moved on
+ * @param prevDistance Set to the distances before moving
+ * @param speed Speeds in virtual pixels per second
+ * @param count Number of balloons
+ * @param elapsed Time to move for in seconds
+ */
+void CBalloonStore::AdvanceScalar(double* distance, double* prevDistance, const double* speed,
+    size_t count, double elapsed)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        prevDistance[i] = distance[i];
+        distance[i] = distance[i] + speed[i] * elapsed;
+    }
+}
+
+/**
+ * Move balloons along the road two at a time with SSE2
+ * @param distance Distances, moved on
+ * @param prevDistance Set to the distances before moving
+ * @param speed Speeds in virtual pixels per second
+ * @param count Number of balloons
+ * @param elapsed Time to move for in seconds
+ */
+void CBalloonStore::AdvanceSse2(double* distance, double* prevDistance, const double* speed,
+    size_t count, double elapsed)
+{
+    size_t i = 0;
+#ifdef TOWERS_SIMD_X86
+    __m128d step = _mm_set1_pd(elapsed);
+    for (; i + 2 <= count; i += 2)
+    {
+        __m128d d = _mm_loadu_pd(distance + i);
+        _mm_storeu_pd(prevDistance + i, d);
+        _mm_storeu_pd(distance + i, _mm_add_pd(d, _mm_mul_pd(_mm_loadu_pd(speed + i), step)));
+    }
+#endif
+
+    AdvanceScalar(distance + i, prevDistance + i, speed + i, count - i, elapsed);
+}
+
+/**
+ * Place balloons on the path one at a time.
+ *
+ * The reference the vector kernels must match exactly.
+ * @param distance Distances along the path
+ * @param segment Index of the segment each balloon is on
+ * @param segments Segments of the path
+ * @param length Length of the path, balloons this far or more are not moved
+ * @param x X locations, set for each balloon placed
+ * @param y Y locations, set for each balloon placed
+ * @param count Number of balloons
+ */
+void CBalloonStore::PlaceScalar(const double* distance, const int* segment, const CRoadPath::Segment* segments,
+    double length, double* x, double* y, size_t count)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        if (distance[i] < length)
+        {
+            const CRoadPath::Segment& s = segments[segment[i]];
+            double along = max(0.0, distance[i] - s.mStart);
+            x[i] = s.mX + s.mDirX * along;
+            y[i] = s.mY + s.mDirY * along;
+        }
+    }
+}
+
+/**
+ * Place balloons on the path two at a time with SSE2
+ * @param distance Distances along the path
+ * @param segment Index of the segment each balloon is on
+ * @param segments Segments of the path
+ * @param length Length of the path, balloons this far or more are not moved
+ * @param x X locations, set for each balloon placed
+ * @param y Y locations, set for each balloon placed
+ * @param count Number of balloons
+ */
+void CBalloonStore::PlaceSse2(const double* distance, const int* segment, const CRoadPath::Segment* segments,
+    double length, double* x, double* y, size_t count)
+{
+    size_t i = 0;
+#ifdef TOWERS_SIMD_X86
+    __m128d zero = _mm_setzero_pd();
+    __m128d end = _mm_set1_pd(length);
+    for (; i + 2 <= count; i += 2)
+    {
+        const CRoadPath::Segment& s0 = segments[segment[i]];
+        const CRoadPath::Segment& s1 = segments[segment[i + 1]];
+
+        __m128d d = _mm_loadu_pd(distance + i);
+        __m128d along = _mm_max_pd(_mm_sub_pd(d, _mm_set_pd(s1.mStart, s0.mStart)), zero);
+        __m128d newX = _mm_add_pd(_mm_set_pd(s1.mX, s0.mX), _mm_mul_pd(_mm_set_pd(s1.mDirX, s0.mDirX), along));
+        __m128d newY = _mm_add_pd(_mm_set_pd(s1.mY, s0.mY), _mm_mul_pd(_mm_set_pd(s1.mDirY, s0.mDirY), along));
+
+        // Balloons past the end keep their old location
+        __m128d on = _mm_cmplt_pd(d, end);
+        _mm_storeu_pd(x + i, _mm_or_pd(_mm_and_pd(on, newX), _mm_andnot_pd(on, _mm_loadu_pd(x + i))));
+        _mm_storeu_pd(y + i, _mm_or_pd(_mm_and_pd(on, newY), _mm_andnot_pd(on, _mm_loadu_pd(y + i))));
+    }
+#endif
+
+    PlaceScalar(distance + i, segment + i, segments, length, x + i, y + i, count - i);
+}
+
+/**
+ * Test balloons against a tower one at a time.
+ *
+ * The reference the vector kernels must match exactly, and
+ * the same test as CBalloon::InTowerRange.
+ * @param x X locations of the balloons
+ * @param y Y locations of the balloons
+ * @param first Index of the first balloon to test
+ * @param count Index one past the last balloon to test
+ * @param towerX X location of the tower
+ * @param towerY Y location of the tower
+ * @param reach Distance from the tower a balloon is hit at
+ * @param sector Distance from a firing line a balloon is hit at, 0 for any direction
+ * @param hits Bits set for the balloons hit, cleared before the first call
+ */
+void CBalloonStore::HitTestScalar(const double* x, const double* y, size_t first, size_t count,
+    double towerX, double towerY, double reach, double sector, uint64_t* hits)
+{
+    double reach2 = reach * reach;
+    for (size_t i = first; i < count; i++)
+    {
+        double dX = towerX - x[i];
+        double dY = towerY - y[i];
+        bool hit = dX * dX + dY * dY <= reach2;
+        if (sector > 0)
+        {
+            dX = abs(dX);
+            dY = abs(dY);
+            hit = hit && (dX < sector || dY < sector || abs(dX - dY) < sector);
+        }
+
+        hits[i / 64] |= (uint64_t)hit << (i % 64);
+    }
+}
+
+/**
+ * Test balloons against a tower two at a time with SSE2
+ * @param x X locations of the balloons
+ * @param y Y locations of the balloons
+ * @param first Index of the first balloon to test
+ * @param count Index one past the last balloon to test
+ * @param towerX X location of the tower
+ * @param towerY Y location of the tower
+ * @param reach Distance from the tower a balloon is hit at
+ * @param sector Distance from a firing line a balloon is hit at, 0 for any direction
+ * @param hits Bits set for the balloons hit, cleared before the first call
+ */
+void CBalloonStore::HitTestSse2(const double* x, const double* y, size_t first, size_t count,
+    double towerX, double towerY, double reach, double sector, uint64_t* hits)
+{
+    size_t i = first;
+#ifdef TOWERS_SIMD_X86
+    __m128d centerX = _mm_set1_pd(towerX);
+    __m128d centerY = _mm_set1_pd(towerY);
+    __m128d reach2 = _mm_set1_pd(reach * reach);
+    __m128d width = _mm_set1_pd(sector);
+    __m128d sign = _mm_set1_pd(-0.0);
+    bool sectors = sector > 0;
+
+    // Start on a pair so the bits of a pair never straddle two words
+    if (i % 2 != 0 && i < count)
+    {
+        HitTestScalar(x, y, i, i + 1, towerX, towerY, reach, sector, hits);
+        i++;
+    }
+
+    for (; i + 2 <= count; i += 2)
+    {
+        __m128d dX = _mm_sub_pd(centerX, _mm_loadu_pd(x + i));
+        __m128d dY = _mm_sub_pd(centerY, _mm_loadu_pd(y + i));
+        __m128d hit = _mm_cmple_pd(_mm_add_pd(_mm_mul_pd(dX, dX), _mm_mul_pd(dY, dY)), reach2);
+        if (sectors)
+        {
+            dX = _mm_andnot_pd(sign, dX);
+            dY = _mm_andnot_pd(sign, dY);
+            __m128d diagonal = _mm_andnot_pd(sign, _mm_sub_pd(dX, dY));
+            __m128d line = _mm_or_pd(_mm_or_pd(_mm_cmplt_pd(dX, width), _mm_cmplt_pd(dY, width)),
+                _mm_cmplt_pd(diagonal, width));
+            hit = _mm_and_pd(hit, line);
+        }
+
+        hits[i / 64] |= (uint64_t)_mm_movemask_pd(hit) << (i % 64);
+    }
+#endif
+
+    HitTestScalar(x, y, i, count, towerX, towerY, reach, sector, hits);
+}
@@ -0,0 +1,201 @@
+/**
+ * \file BalloonStore.h
+ *
+ * \author Morgan Mundell
+ *
+ *  The moving state of every balloon on a road, kept in parallel arrays
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "RoadPath.h"
+#include "Simd.h"
+
+/**
+ * The state the simulation touches for every balloon on a road.
+ *
+ * Each kind of value is kept in its own contiguous array, indexed the
+ * same as the road's balloons, so a tick streams through only the
+ * values it needs. Moving the balloons along and placing them on the
+ * road's path are done for all balloons at once by kernels written for
+ * the best vector instructions the processor has. A scalar kernel does
+ * the same and gives exactly the same results. The same kinds of kernel
+ * test arrays of balloon locations against a tower.
+ *
+ * Balloons are removed by moving the last balloon into their place,
+ * the same as the road's own collection.
+ */
+class CBalloonStore
+{
+public:
+    /// Bits of a balloon's state
+    enum State : unsigned char
+    {
+        Popped = 1,     ///< Hit by a tower, no longer drawn or hit
+        Deleted = 2     ///< Scheduled to leave the road
+    };
+
+    CBalloonStore() {}
+
+    ///  Copy constructor (disabled)
+    CBalloonStore(const CBalloonStore&) = delete;
+
+    size_t Add(double distance, double speed, double x, double y);
+
+    void Remove(size_t index);
+
+    void Clear();
+
+    void Advance(double elapsed);
+
+    void Place(const CRoadPath& path);
+
+    static void HitTest(const double* x, const double* y, size_t count, double towerX, double towerY,
+        double reach, double sector, SimdLevel level, std::vector<uint64_t>& hits);
+
+    /**
+     * Use a different set of kernels, for testing and measuring
+     * @param level Level to use, lowered to what the processor has
+     */
+    void SetSimdLevel(SimdLevel level) { mSimdLevel = level <= GetSimdLevel() ? level : GetSimdLevel(); }
+
+    /**
+     * The set of kernels in use
+     * @returns Level of vector instructions
+     */
+    SimdLevel GetSimdLevelInUse() const { return mSimdLevel; }
+
+    /**
+     * Number of balloons in the store
+     * @returns Balloon count
+     */
+    size_t GetCount() const { return mDistance.size(); }
+
+    /**
+     * Distance a balloon has travelled along the road
+     * @param index Index of the balloon
+     * @returns Distance in virtual pixels
+     */
+    double GetDistance(size_t index) const { return mDistance[index]; }
+
+    /**
+     * Distance a balloon had travelled before the last advance
+     * @param index Index of the balloon
+     * @returns Distance in virtual pixels
+     */
+    double GetPrevDistance(size_t index) const { return mPrevDistance[index]; }
+
+    /**
+     * Move a balloon to a distance along the road, with no step to interpolate
+     * @param index Index of the balloon
+     * @param distance Distance in virtual pixels
+     */
+    void SetDistance(size_t index, double distance) { mDistance[index] = distance; mPrevDistance[index] = distance; }
+
+    /**
+     * X location of a balloon
+     * @param index Index of the balloon
+     * @returns X in virtual pixels
+     */
+    double GetX(size_t index) const { return mX[index]; }
+
+    /**
+     * Y location of a balloon
+     * @param index Index of the balloon
+     * @returns Y in virtual pixels
+     */
+    double GetY(size_t index) const { return mY[index]; }
+
+    /**
+     * Set the location of a balloon
+     * @param index Index of the balloon
+     * @param x X in virtual pixels
+     * @param y Y in virtual pixels
+     */
+    void SetLocation(size_t index, double x, double y) { mX[index] = x; mY[index] = y; }
+
+    /**
+     * Test a bit of a balloon's state
+     * @param index Index of the balloon
+     * @param bit State bit to test
+     * @returns True if set
+     */
+    bool Is(size_t index, State bit) const { return (mState[index] & bit) != 0; }
+
+    /**
+     * Set or clear a bit of a balloon's state
+     * @param index Index of the balloon
+     * @param bit State bit to change
+     * @param set True to set the bit
+     */
+    void Set(size_t index, State bit, bool set)
+    {
+        mState[index] = set ? (unsigned char)(mState[index] | bit) : (unsigned char)(mState[index] & ~bit);
+    }
+
+    /**
+     * Distances of all balloons
+     * @returns Array of GetCount distances
+     */
+    const double* GetDistances() const { return mDistance.data(); }
+
+    /**
+     * X locations of all balloons
+     * @returns Array of GetCount X locations
+     */
+    const double* GetXs() const { return mX.data(); }
+
+    /**
+     * Y locations of all balloons
+     * @returns Array of GetCount Y locations
+     */
+    const double* GetYs() const { return mY.data(); }
+
+private:
+    static void AdvanceScalar(double* distance, double* prevDistance, const double* speed,
+        size_t count, double elapsed);
+    static void AdvanceSse2(double* distance, double* prevDistance, const double* speed,
+        size_t count, double elapsed);
+    static void AdvanceAvx2(double* distance, double* prevDistance, const double* speed,
+        size_t count, double elapsed);
+
+    static void PlaceScalar(const double* distance, const int* segment, const CRoadPath::Segment* segments,
+        double length, double* x, double* y, size_t count);
+    static void PlaceSse2(const double* distance, const int* segment, const CRoadPath::Segment* segments,
+        double length, double* x, double* y, size_t count);
+    static void PlaceAvx2(const double* distance, const int* segment, const CRoadPath::Segment* segments,
+        double length, double* x, double* y, size_t count);
+
+    static void HitTestScalar(const double* x, const double* y, size_t first, size_t count,
+        double towerX, double towerY, double reach, double sector, uint64_t* hits);
+    static void HitTestSse2(const double* x, const double* y, size_t first, size_t count,
+        double towerX, double towerY, double reach, double sector, uint64_t* hits);
+    static void HitTestAvx2(const double* x, const double* y, size_t first, size_t count,
+        double towerX, double towerY, double reach, double sector, uint64_t* hits);
+
+    /// Distance along the road
+    std::vector<double> mDistance;
+
+    /// Distance along the road before the last advance, for interpolation
+    std::vector<double> mPrevDistance;
+
+    /// Speed along the road in virtual pixels per second
+    std::vector<double> mSpeed;
+
+    /// X location on the road
+    std::vector<double> mX;
+
+    /// Y location on the road
+    std::vector<double> mY;
+
+    /// Index of the path segment each balloon was last placed on
+    std::vector<int> mSegment;
+
+    /// State bits
+    std::vector<unsigned char> mState;
+
+    /// Set of kernels in use
+    SimdLevel mSimdLevel = GetSimdLevel();
+};
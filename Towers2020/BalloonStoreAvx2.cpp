@@ -0,0 +1,160 @@
+/**
+ * \file BalloonStoreAvx2.cpp
+ *
+ * \author Morgan Mundell
+ *
+ *  The balloon store kernels written with AVX2.
+ *
+ *  This file is built allowing AVX2 instructions, which the rest of
+ *  the game is not, so it only runs when GetSimdLevel says the processor
+ *  has them. It uses only raw arrays and intrinsics so no inline library
+ *  code is built here with AVX2 and then shared with the rest of the game.
+ */
+
+#include "pch.h"
+#include "BalloonStore.h"
+
+#ifdef TOWERS_SIMD_X86
+#include <immintrin.h>
+#endif
+
+/**
+ * Move balloons along the road four at a time with AVX2
+ * @param distance Distances, moved on
+ * @param prevDistance Set to the distances before moving
+ * @param speed Speeds in virtual pixels per second
+ * @param count Number of balloons
+ * @param elapsed Time to move for in seconds
+ */
+void CBalloonStore::AdvanceAvx2(double* distance, double* prevDistance, const double* speed,
+    size_t count, double elapsed)
+{
+    size_t i = 0;
+#ifdef TOWERS_SIMD_X86
+    __m256d step = _mm256_set1_pd(elapsed);
+    for (; i + 4 <= count; i += 4)
+    {
+        __m256d d = _mm256_loadu_pd(distance + i);
+        _mm256_storeu_pd(prevDistance + i, d);
+        _mm256_storeu_pd(distance + i, _mm256_add_pd(d, _mm256_mul_pd(_mm256_loadu_pd(speed + i), step)));
+    }
+#endif
+
+    AdvanceScalar(distance + i, prevDistance + i, speed + i, count - i, elapsed);
+}
+
+/**
+ * Place balloons on the path four at a time with AVX2.
+ *
+ * Each balloon's segment is gathered from the path by index. Multiply
+ * and add are kept separate so the results match the scalar kernel.
+ * @param distance Distances along the path
+ * @param segment Index of the segment each balloon is on
+ * @param segments Segments of the path
+ * @param length Length of the path, balloons this far or more are not moved
+ * @param x X locations, set for each balloon placed
+ * @param y Y locations, set for each balloon placed
+ * @param count Number of balloons
+ */
+void CBalloonStore::PlaceAvx2(const double* distance, const int* segment, const CRoadPath::Segment* segments,
+    double length, double* x, double* y, size_t count)
+{
+    size_t i = 0;
+#ifdef TOWERS_SIMD_X86
+    const double* base = &segments[0].mX;
+    const int startField = (int)(&segments[0].mStart - base);
+    const int dirXField = (int)(&segments[0].mDirX - base);
+    const int yField = (int)(&segments[0].mY - base);
+    const int dirYField = (int)(&segments[0].mDirY - base);
+    const int stride = (int)(sizeof(CRoadPath::Segment) / sizeof(double));
+
+    __m256d zero = _mm256_setzero_pd();
+    __m256d end = _mm256_set1_pd(length);
+    __m128i strides = _mm_set1_epi32(stride);
+
+    // Every lane is gathered. The masked form takes an explicit source
+    // for the lanes it skips, which the plain form leaves uninitialized.
+    __m256d all = _mm256_castsi256_pd(_mm256_set1_epi64x(-1));
+    auto gather = [zero, all](const double* field, __m128i index) {
+        return _mm256_mask_i32gather_pd(zero, field, index, all, 8);
+    };
+
+    for (; i + 4 <= count; i += 4)
+    {
+        // Index of the first value of each balloon's segment, in doubles
+        __m128i index = _mm_mullo_epi32(_mm_loadu_si128((const __m128i*)(segment + i)), strides);
+
+        __m256d d = _mm256_loadu_pd(distance + i);
+        __m256d start = gather(base + startField, index);
+        __m256d along = _mm256_max_pd(_mm256_sub_pd(d, start), zero);
+
+        __m256d newX = _mm256_add_pd(gather(base, index),
+            _mm256_mul_pd(gather(base + dirXField, index), along));
+        __m256d newY = _mm256_add_pd(gather(base + yField, index),
+            _mm256_mul_pd(gather(base + dirYField, index), along));
+
+        // Balloons past the end keep their old location
+        __m256d on = _mm256_cmp_pd(d, end, _CMP_LT_OQ);
+        _mm256_storeu_pd(x + i, _mm256_blendv_pd(_mm256_loadu_pd(x + i), newX, on));
+        _mm256_storeu_pd(y + i, _mm256_blendv_pd(_mm256_loadu_pd(y + i), newY, on));
+    }
+#endif
+
+    PlaceScalar(distance + i, segment + i, segments, length, x + i, y + i, count - i);
+}
+
+/**
+ * Test balloons against a tower four at a time with AVX2
+ * @param x X locations of the balloons
+ * @param y Y locations of the balloons
+ * @param first Index of the first balloon to test
+ * @param count Index one past the last balloon to test
+ * @param towerX X location of the tower
+ * @param towerY Y location of the tower
+ * @param reach Distance from the tower a balloon is hit at
+ * @param sector Distance from a firing line a balloon is hit at, 0 for any direction
+ * @param hits Bits set for the balloons hit, cleared before the first call
+ */
+void CBalloonStore::HitTestAvx2(const double* x, const double* y, size_t first, size_t count,
+    double towerX, double towerY, double reach, double sector, uint64_t* hits)
+{
+    size_t i = first;
+#ifdef TOWERS_SIMD_X86
+    __m256d centerX = _mm256_set1_pd(towerX);
+    __m256d centerY = _mm256_set1_pd(towerY);
+    __m256d reach2 = _mm256_set1_pd(reach * reach);
+    __m256d width = _mm256_set1_pd(sector);
+    __m256d sign = _mm256_set1_pd(-0.0);
+    bool sectors = sector > 0;
+
+    // Start on a group of four so the bits of a group never straddle two words
+    size_t aligned = (i + 3) / 4 * 4;
+    if (aligned > i)
+    {
+        size_t end = aligned < count ? aligned : count;
+        HitTestScalar(x, y, i, end, towerX, towerY, reach, sector, hits);
+        i = end;
+    }
+
+    for (; i + 4 <= count; i += 4)
+    {
+        __m256d dX = _mm256_sub_pd(centerX, _mm256_loadu_pd(x + i));
+        __m256d dY = _mm256_sub_pd(centerY, _mm256_loadu_pd(y + i));
+        __m256d hit = _mm256_cmp_pd(_mm256_add_pd(_mm256_mul_pd(dX, dX), _mm256_mul_pd(dY, dY)),
+            reach2, _CMP_LE_OQ);
+        if (sectors)
+        {
+            dX = _mm256_andnot_pd(sign, dX);
+            dY = _mm256_andnot_pd(sign, dY);
+            __m256d diagonal = _mm256_andnot_pd(sign, _mm256_sub_pd(dX, dY));
+            __m256d line = _mm256_or_pd(_mm256_or_pd(_mm256_cmp_pd(dX, width, _CMP_LT_OQ),
+                _mm256_cmp_pd(dY, width, _CMP_LT_OQ)), _mm256_cmp_pd(diagonal, width, _CMP_LT_OQ));
+            hit = _mm256_and_pd(hit, line);
+        }
+
+        hits[i / 64] |= (uint64_t)_mm256_movemask_pd(hit) << (i % 64);
+    }
+#endif
+
+    HitTestScalar(x, y, i, count, towerX, towerY, reach, sector, hits);
+}
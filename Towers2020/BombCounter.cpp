@@ -1,12 +0,0 @@
-/**
- * \file BombCounter.cpp
- *
- * \author Morgan Mundell
- * \author Jacob Frank
- * \author Dimitri Snell
- * \author Rohit Vadlamudi
- * \author Brandon Addis
- */
-
-#include "pch.h"
-#include "BombCounter.h"
@@ -23,7 +23,10 @@
 #include "Towers2020.h"
 #include "TowersGame.h"
 #include "ChildView.h"
-#include "DoubleBufferDC.h"
+#include "BackBuffer.h"
+#include "GdiplusRenderer.h"
+#include "Profiler.h"
+#include "Trace.h"
 #include "TowerRings.h"
 #include "TowerBomb.h"
 #include "Tower8.h"
@@ -45,23 +48,25 @@ using namespace std;
 /// Frame duration in ms (set to 30 for animation)
 const int FrameDuration = 30;
 
-/// X Location for every item on the Pallette apart from Diag Timer
-const static double XLocation = 1150;
+/// Real time in seconds spent simulating each frame at maximum speed
+const double MaxSpeedFrameTime = 0.025;
 
-/// X Location for the Diag Timer on the Pallette
-const static double XLocationDiagTimer = 1110;
+/// How often in seconds the simulation rate is reported
+const double RateReportInterval = 1.0;
 
-/// Y Location for the Ring Tower on the Pallete
-const static double YLocationTowerRings = 80;
+/// File the player's input is recorded to
+const wchar_t* ReplayFile = L"last.replay";
 
-/// Y Location for the Bomb Tower on the Pallette
-const static double YLocationTowerBomb = 280;
+#ifdef TOWERS_TRACING
+/// File trace events are written to when tracing is built in
+const wchar_t* TraceFile = L"trace.json";
+#endif
 
-/// Y Location for the Tower 8 on the Pallette
-const static double YLocationTower8 = 180;
+/// X Location for every item on the Pallette apart from Diag Timer
+const static double XLocation = 1150;
 
-/// Y Location for the Airship Tower on the Pallette
-const static double YLocationTowerAirship = 380;
+/// X Location for the Diag Timer on the Pallette
+const static double XLocationDiagTimer = 1110;
 
 /// Y Location for the Go Button on the Pallette
 const static double YLocationGoButton = 923;
@@ -74,10 +79,26 @@ const static double YLocationDiagTimer = 923;
 
 CChildView::CChildView()
 {
+	mTowers.SetHost(this);
+
+	// A different game every run, but recorded so it can be played again
+	mTowers.SetSeed((unsigned int)time(nullptr));
+	mTowers.StartRecording(&mRecording);
+	mRecording.SetStep(mClock.GetStep());
+
+#ifdef TOWERS_TRACING
+	CTrace::Instance().Start(TraceFile);
+#endif
 }
 
 CChildView::~CChildView()
 {
+	mRecording.SetEndTick(mTowers.GetTick());
+	mRecording.Save(ReplayFile);
+
+#ifdef TOWERS_TRACING
+	CTrace::Instance().Stop();
+#endif
 }
 
 
@@ -104,10 +125,34 @@ BEGIN_MESSAGE_MAP(CChildView, CWnd)
 	ON_COMMAND(ID_HOWTOUSETOWER_AIRSHIPTOWER, &CChildView::OnHowtousetowerAirshiptower)
 	ON_COMMAND(ID_HOWTO_HOWTOPLAY32782, &CChildView::OnHowtoHowtoplay32782)
 	ON_COMMAND(ID_HOWTOUSETOWER_TOWER9, &CChildView::OnHowtousetowerTower9)
+	ON_COMMAND_RANGE(ID_SPEED_NORMAL, ID_SPEED_MAX, &CChildView::OnSpeed)
+	ON_UPDATE_COMMAND_UI_RANGE(ID_SPEED_NORMAL, ID_SPEED_MAX, &CChildView::OnUpdateSpeed)
+	ON_COMMAND(ID_VIEW_PROFILER, &CChildView::OnViewProfiler)
+	ON_UPDATE_COMMAND_UI(ID_VIEW_PROFILER, &CChildView::OnUpdateViewProfiler)
 END_MESSAGE_MAP()
 
 // CChildView message handlers
 
+/**
+ * Show a message to the user
+ * @param message The message to show
+ */
+void CChildView::ShowMessage(const std::wstring& message)
+{
+	AfxMessageBox(message.c_str());
+}
+
+/**
+ * Ask the user a yes or no question
+ * @param question The question to ask
+ * @param title Title of the message box
+ * @returns True if the user answered yes
+ */
+bool CChildView::AskYesNo(const std::wstring& question, const std::wstring& title)
+{
+	return MessageBox(question.c_str(), title.c_str(), MB_YESNO) == IDYES;
+}
+
 BOOL CChildView::PreCreateWindow(CREATESTRUCT& cs) 
 {
 	if (!CWnd::PreCreateWindow(cs))
@@ -123,11 +168,22 @@ BOOL CChildView::PreCreateWindow(CREATESTRUCT& cs)
 
 void CChildView::OnPaint() 
 {
+	// Declared first so the frame ends after the paint is finished
+	CProfileFrame profileFrame;
+	CProfileScope profile(CProfiler::Frame);
+
 	CPaintDC paintDC(this); // device context for painting
-	CDoubleBufferDC dc(&paintDC); // device context for painting
 
-	Graphics graphics(dc.m_hDC);    // Create GDI+ graphics context
-	graphics.Clear(Color(0, 0, 0));
+	CRect rect;
+	GetClientRect(&rect);
+
+	// The frame is drawn into the back buffer and copied to the window at the end
+	Graphics* graphics = mBackBuffer.Begin(&paintDC, rect.Width(), rect.Height());
+
+	// Only what was invalidated is drawn, the rest of the
+	// back buffer still holds it from earlier frames
+	CRect paint = mBackBuffer.IsNew() ? rect : CRect(paintDC.m_ps.rcPaint);
+	graphics->SetClip(Rect(paint.left, paint.top, paint.Width(), paint.Height()));
 
 	if (mFirstDraw)
 	{
@@ -144,6 +200,26 @@ void CChildView::OnPaint()
 		mTimeFreq = double(freq.QuadPart);
 	}
 
+	CGdiplusRenderer renderer(graphics, &mTextCache);
+	mTowers.OnDraw(&renderer, rect.Width(), rect.Height(), GetDrawAlpha());
+	mTextCache.EndFrame();
+
+	mBackBuffer.Present(&paintDC, paint);
+
+	if (mTowers.GetNewLevelItems())
+	{
+		// Arcade like sound
+		PlaySound(L"AudioFile/DST-TowerDefenseTheme.wav", NULL, SND_FILENAME | SND_ASYNC);
+
+		mTowers.SetNewLevelItems(false);
+	}
+}
+
+/**
+ * Run the simulation steps due since the last frame
+ */
+void CChildView::Advance()
+{
 	LARGE_INTEGER time;
 	QueryPerformanceCounter(&time);
 	long long diff = time.QuadPart - mLastTime;
@@ -151,46 +227,180 @@ void CChildView::OnPaint()
 	mLastTime = time.QuadPart;
 
 	//
-	// Prevent tunnelling
+	// The game only ever advances in fixed steps, so it plays
+	// the same however often the window is repainted. Faster
+	// speeds run more steps for each frame that is drawn.
 	//
-	while (elapsed > MaxElapsed)
+	int ticks = 0;
+	if (mMaxSpeed)
 	{
-		mTowers.Update(MaxElapsed);
+		// As many steps as fit in a frame until the level is over
+		LARGE_INTEGER now = time;
+		while (!mTowers.IsLevelComplete() &&
+			double(now.QuadPart - time.QuadPart) / mTimeFreq < MaxSpeedFrameTime)
+		{
+			mTowers.Update(mClock.GetStep());
+			ticks++;
+			QueryPerformanceCounter(&now);
+		}
 
-		elapsed -= MaxElapsed;
+		if (mTowers.IsLevelComplete())
+		{
+			mMaxSpeed = false;
+		}
 	}
+	else
+	{
+		ticks = mClock.Advance(elapsed);
+		for (int i = 0; i < ticks; i++)
+		{
+			mTowers.Update(mClock.GetStep());
+		}
+	}
+
+	LARGE_INTEGER updated;
+	QueryPerformanceCounter(&updated);
+	ReportTickRate(ticks, elapsed, double(updated.QuadPart - time.QuadPart) / mTimeFreq);
+}
 
-	// Consume any remaining time
-	if (elapsed > 0)
+/**
+ * Invalidate only the parts of the window that changed since the last call.
+ *
+ * The moving parts of the game are drawn through the dirty tracker,
+ * which compares them with the last time. The whole window is
+ * invalidated when the tiles or the scale change.
+ */
+void CChildView::InvalidateChanges()
+{
+	mDirty.BeginFrame();
+	mTowers.DrawDynamic(&mDirty, GetDrawAlpha());
+	mDirty.EndFrame();
+
+	if (mDirty.IsAllDirty() || mTowers.GetTileChanges() != mTileChanges)
 	{
-		mTowers.Update(elapsed);
+		mTileChanges = mTowers.GetTileChanges();
+		Invalidate();
+		return;
 	}
 
-	CRect rect;
-	GetClientRect(&rect);
-	
-	mTowers.OnDraw(&graphics, rect.Width(), rect.Height());
+	for (auto& dirty : mDirty.GetDirty())
+	{
+		CRect rect(dirty.mLeft, dirty.mTop, dirty.mRight, dirty.mBottom);
+		InvalidateRect(&rect, FALSE);
+	}
+}
 
-	if (mTowers.GetNewLevelItems())
+/**
+ * Fraction of a simulation step to draw the game ahead by
+ * @returns Fraction from 0 to 1
+ */
+double CChildView::GetDrawAlpha()
+{
+	return mMaxSpeed ? 0 : mClock.GetAlpha();
+}
+
+/**
+ * Keep count of the simulation rate and show it in the status bar
+ * @param ticks Simulation steps run this frame
+ * @param elapsed Real time since the last frame in seconds
+ * @param updateTime Real time spent running the steps in seconds
+ */
+void CChildView::ReportTickRate(int ticks, double elapsed, double updateTime)
+{
+	mRateTicks += ticks;
+	mRateElapsed += elapsed;
+	mRateUpdateTime += updateTime;
+
+	if (mRateElapsed < RateReportInterval)
+	{
+		return;
+	}
+
+	// Achieved is what the game ran at, possible is what the
+	// simulation alone could sustain if it had the whole machine
+	wstringstream str;
+	str.precision(0);
+	str << fixed << L"Simulation " << mRateTicks / mRateElapsed << L" ticks/s";
+	if (mRateUpdateTime > 0)
 	{
-		// Update the entire object panel
+		str << L", " << mRateTicks / mRateUpdateTime << L" ticks/s possible";
+	}
 
-		OnAddAll(); 
+	CFrameWnd* frame = GetParentFrame();
+	if (frame != nullptr)
+	{
+		frame->SetMessageText(str.str().c_str());
+	}
 
-		// Arcade like sound
-		PlaySound(L"AudioFile/DST-TowerDefenseTheme.wav", NULL, SND_FILENAME | SND_ASYNC);
+	mRateTicks = 0;
+	mRateElapsed = 0;
+	mRateUpdateTime = 0;
+}
 
-		mTowers.SetNewLevelItems(false);
+/**
+ * Handle the speed menu
+ * @param id Menu command chosen
+ */
+void CChildView::OnSpeed(UINT id)
+{
+	mMaxSpeed = id == ID_SPEED_MAX;
+
+	switch (id)
+	{
+	case ID_SPEED_2X:
+		mClock.SetSpeed(2);
+		break;
+
+	case ID_SPEED_10X:
+		mClock.SetSpeed(10);
+		break;
+
+	default:
+		mClock.SetSpeed(1);
+		break;
 	}
 }
 
-void CChildView::OnAddAll()
+/**
+ * Check the speed the game is running at in the speed menu
+ * @param pCmdUI Menu item being updated
+ */
+void CChildView::OnUpdateSpeed(CCmdUI* pCmdUI)
 {
-	OnAddTower8();
-	OnAddTowerBomb();
-	OnAddTowerBomb();
-	OnAddTowerRings();
-	OnAddTowerAirship();
+	UINT current = ID_SPEED_NORMAL;
+	if (mMaxSpeed)
+	{
+		current = ID_SPEED_MAX;
+	}
+	else if (mClock.GetSpeed() == 10)
+	{
+		current = ID_SPEED_10X;
+	}
+	else if (mClock.GetSpeed() == 2)
+	{
+		current = ID_SPEED_2X;
+	}
+
+	pCmdUI->SetRadio(pCmdUI->m_nID == current);
+}
+
+/**
+ * Show or hide the profiler overlay, timing the game while it is shown
+ */
+void CChildView::OnViewProfiler()
+{
+	auto& profiler = CProfiler::Instance();
+	profiler.SetEnabled(!profiler.IsEnabled());
+	Invalidate();
+}
+
+/**
+ * Check the profiler menu item when the overlay is shown
+ * @param pCmdUI Menu item being updated
+ */
+void CChildView::OnUpdateViewProfiler(CCmdUI* pCmdUI)
+{
+	pCmdUI->SetCheck(CProfiler::Instance().IsEnabled());
 }
 
 /*
@@ -251,74 +461,9 @@ void CChildView::OnFileOpen()
  */
 void CChildView::OnLButtonDown(UINT nFlags, CPoint point)
 {
-	// TODO: Add your message handler code here and/or call default
-
 	double oX = (point.x - mTowers.GetmXOffset()) / mTowers.GetmScale();
 	double oY = (point.y - mTowers.GetmYOffset()) / mTowers.GetmScale();
-	mGrabbedItem = mTowers.HitTest(oX, oY);
-
-	if (mGrabbedItem != nullptr)
-	{
-		CDiagVisitor gobuttonvisitor;
-		mGrabbedItem->Accept(&gobuttonvisitor);
-
-		if (mTowers.GetLevelLabelStatus())
-		{
-			mGrabbedItem = nullptr;
-		}
-		else if (gobuttonvisitor.GetFindGoButton() && !mTowers.GetGoButtonPressed())
-		{
-			mTowers.PressGoButton(mGrabbedItem);
-			mGrabbedItem = nullptr;
-		}
-		else if (mTowers.GetGoButtonPressed())
-		{
-			mGrabbedItem = nullptr;
-		}
-		else
-		{
-			// Accept a visitor to identify what type of object we have
-			CCanMoveVisitor visitor;
-			
-			mGrabbedItem->Accept(&visitor);
-
-			// Only move if item is tower
-			if (visitor.GetIsTower() && visitor.GetIsOpen())
-			{
-				// Detects if click on panel obj. Hard coded X intercept to represent boundary of panel
-				if (oX >= 1024)
-				{
-					// If the visitor finds that we clicked out of bounds on a tower, it must be
-					// a pallete object. We need to replace this palette object with another
-					switch (visitor.GetKey())
-					{
-					case 1: // Key 1 = Tower8
-						OnAddTower8();
-						break;
-					case 2: // Key 2 = TowerBomb
-						OnAddTowerBomb();
-						break;
-					case 3: // Key 3 = TowerRings
-						OnAddTowerRings();
-						break;
-					case 4: // Key 4 = TowerAirship
-						OnAddTowerAirship();
-						break;
-					}
-				}
-
-				visitor.LiftTower(); // Lifts the tower to disable attacks
-				mTowers.MoveToFront(mGrabbedItem);
-				//mTowers.SetDrawMoreItems(true);
-			}
-			else
-			{
-				mGrabbedItem = nullptr;
-			}
-
-		}
-
-	}
+	mTowers.Grab(oX, oY);
 }
 
 /**
@@ -328,60 +473,12 @@ void CChildView::OnLButtonDown(UINT nFlags, CPoint point)
  */
 void CChildView::OnLButtonUp(UINT nFlags, CPoint point)
 {
-	// TODO: Add your message handler code here and/or call default
-	if (mGrabbedItem != nullptr)
+	if (mTowers.IsGrabbing())
 	{
 		double oX = (point.x - mTowers.GetmXOffset()) / mTowers.GetmScale();
 		double oY = (point.y - mTowers.GetmYOffset()) / mTowers.GetmScale();
-
-		// The Temporary item representing the object under the cursor (not being dragged)
-		std::shared_ptr<CItem> tempItem;
-		mGrabbedItem->SetLocation(0, 0);
-		tempItem = mTowers.HitTest(oX, oY);
-
-		CCanMoveVisitor visitor, visitorTower; // create new visitor to check if tower
-
-		if (tempItem != nullptr) 
-		{
-			tempItem->Accept(&visitor);
-			mGrabbedItem->Accept(&visitorTower);
-
-			// visitor checks if the place under the dropped location is a tower
-			
-			if (visitor.GetIsTower())
-			{
-
-				// Checks if inside palette. Someone placed a sample turret on another one
-				if (oX > 1024)
-				{
-					// Just delete the dragged tower. Do not replace a palette object
-					mTowers.DeleteItem(mGrabbedItem); 
-				}
-				else
-				{
-					mTowers.DeleteItem(tempItem); // delete the existing tower
-					mGrabbedItem->SetLocation(tempItem->GetX(), tempItem->GetY()); // add the new tower on top of it
-					visitorTower.PlaceTower(); // Lifts the tower to enable attacks
-				}
-				
-			}
-			else if (visitor.GetIsOpen())
-			{
-				mGrabbedItem->SetLocation(tempItem->GetX(), tempItem->GetY()); // place the tower on open ground
-				visitorTower.PlaceTower(); // Lifts the tower to enable attacks
-			}
-			else
-			{
-				mTowers.DeleteItem(mGrabbedItem);
-			}
-		} 
-		else 
-		{
-			mTowers.DeleteItem(mGrabbedItem);
-		}
-
-		// Update the grabbed item
-		OnMouseMove(nFlags, point);
+		mTowers.Drop(oX, oY);
+		Invalidate();
 	}
 }
 
@@ -393,7 +490,7 @@ void CChildView::OnLButtonUp(UINT nFlags, CPoint point)
 void CChildView::OnMouseMove(UINT nFlags, CPoint point)
 {
 	// See if an item is currently being moved by the mouse
-	if (mGrabbedItem != nullptr)
+	if (mTowers.IsGrabbing())
 	{
 		double oX = (point.x - mTowers.GetmXOffset()) / mTowers.GetmScale();
 		double oY = (point.y - mTowers.GetmYOffset()) / mTowers.GetmScale();
@@ -401,19 +498,16 @@ void CChildView::OnMouseMove(UINT nFlags, CPoint point)
 		// move it while the left button is down.
 		if (nFlags & MK_LBUTTON)
 		{
-
-			mGrabbedItem->SetLocation(oX, oY);
+			mTowers.Drag(oX, oY);
 		}
 		else
 		{
-			//mGrabbedItem->QuantizeLocation();
-
-			// When the left button is released, we release the
-			mGrabbedItem = nullptr;
+			// The button was released somewhere we did not see
+			mTowers.CancelGrab();
 		}
 
-		// Force the screen to redraw
-		Invalidate();
+		// Redraw where the tower was and where it is now
+		InvalidateChanges();
 	}
 }
 
@@ -423,7 +517,8 @@ void CChildView::OnMouseMove(UINT nFlags, CPoint point)
  */
 void CChildView::OnTimer(UINT_PTR nIDEvent)
 {
-	Invalidate();
+	Advance();
+	InvalidateChanges();
 	CWnd::OnTimer(nIDEvent);
 }
 
@@ -443,9 +538,7 @@ BOOL CChildView::OnEraseBkgnd(CDC* pDC)
  */
 void CChildView::OnAddTowerRings()
 {
-	auto ring = make_shared<CTowerRings>(&mTowers);
-	ring->SetLocation(XLocation, YLocationTowerRings);
-	mTowers.Add(ring);
+	mTowers.AddPaletteTower(3);
 	Invalidate();
 }
 
@@ -453,9 +546,7 @@ void CChildView::OnAddTowerRings()
  */
 void CChildView::OnAddTowerBomb()
 {
-	auto bomb = make_shared<CTowerBomb>(&mTowers);
-	bomb->SetLocation(XLocation, YLocationTowerBomb);
-	mTowers.Add(bomb);
+	mTowers.AddPaletteTower(2);
 	Invalidate();
 }
 
@@ -463,9 +554,7 @@ void CChildView::OnAddTowerBomb()
  */
 void CChildView::OnAddTower8()
 {
-	auto tower8 = make_shared<CTower8>(&mTowers);
-	tower8->SetLocation(XLocation, YLocationTower8);
-	mTowers.Add(tower8);
+	mTowers.AddPaletteTower(1);
 	Invalidate();
 }
 
@@ -473,9 +562,7 @@ void CChildView::OnAddTower8()
  */
 void CChildView::OnAddTowerAirship()
 {
-	auto airship = make_shared<CTowerAirship>(&mTowers);
-	airship->SetLocation(XLocation, YLocationTowerAirship);
-	mTowers.Add(airship);
+	mTowers.AddPaletteTower(4);
 	Invalidate();
 }
 
@@ -16,14 +16,23 @@
 
 #pragma once
 #include "TowersGame.h"
+#include "GameHost.h"
+#include "GameClock.h"
+#include "BackBuffer.h"
+#include "GdiplusTextCache.h"
+#include "DirtyTracker.h"
 
 /// CChildView window
-class CChildView : public CWnd
+class CChildView : public CWnd, public CGameHost
 {
 // Construction
 public:
 	CChildView();
 
+	virtual void ShowMessage(const std::wstring& message) override;
+
+	virtual bool AskYesNo(const std::wstring& question, const std::wstring& title) override;
+
 // Attributes
 public:
 
@@ -48,14 +57,21 @@ protected:
 
 private:
 
-	/**
-	 * @brief Adds all CItems necessary for the palette
-	*/
-	void OnAddAll();
-
 	/// The towers game
 	CTowersGame mTowers; 
 
+	/// Offscreen bitmap each frame is drawn into, kept between paints
+	CBackBuffer mBackBuffer;
+
+	/// Fonts, brushes and drawn text kept between paints
+	CGdiplusTextCache mTextCache;
+
+	/// Finds the parts of the window that changed between frames
+	CDirtyTracker mDirty;
+
+	/// The game's tile change count when the window was last all invalidated
+	long long mTileChanges = -1;
+
 	/// True until our first draw
 	bool mFirstDraw = true;	
 
@@ -68,11 +84,32 @@ private:
 	/// Rate the timer updates
 	double mTimeFreq = 0; 
 
-	/// Any item we are currently dragging
-	std::shared_ptr<CItem> mGrabbedItem; 
+	/// Turns frame times into fixed simulation steps
+	CGameClock mClock;
+
+	/// Everything the player does, saved when the window closes
+	CReplay mRecording;
+
+	/// True to simulate as fast as possible until the level is complete
+	bool mMaxSpeed = false;
+
+	/// Steps run since the simulation rate was last reported
+	long long mRateTicks = 0;
+
+	/// Real time since the simulation rate was last reported
+	double mRateElapsed = 0;
+
+	/// Real time spent simulating since the rate was last reported
+	double mRateUpdateTime = 0;
+
+	void ReportTickRate(int ticks, double elapsed, double updateTime);
+
+	void Advance();
+
+	void InvalidateChanges();
+
+	double GetDrawAlpha();
 
-	/// The max time between frames
-	double MaxElapsed = 0.025; 
 
 public:
 	
@@ -122,5 +159,13 @@ public:
 
 	/** Explains Tower8 */
 	afx_msg void OnHowtousetowerTower9();
+
+	afx_msg void OnSpeed(UINT id);
+
+	afx_msg void OnUpdateSpeed(CCmdUI* pCmdUI);
+
+	afx_msg void OnViewProfiler();
+
+	afx_msg void OnUpdateViewProfiler(CCmdUI* pCmdUI);
 };
 
@@ -43,15 +43,6 @@ public:
 
 	void VisitTileRoad(CTileRoad* road) override;
 
-	/** 
-	 * Hit tests the tile road for a balloon
-	 * @param x The x value of the balloon
-	 * @param y The y value of the balloon
-	 * @param radius The radius to check 
-	 * @param dartTower True if tower shoots darts
-	 * @returns Int of ballons hit
-	 */
-	int HitTestRoad(int x, int y, double radius, bool dartTower) { return mRoad->HitTestAllBalloons(x, y, radius, dartTower); }
 
 private:
 	/// Pointer to road
@@ -9,16 +9,17 @@
  */
 
 #include "pch.h"
+#include <cmath>
 #include "Dart.h"
+#include "ImageCache.h"
 #include"TowersGame.h"
 using namespace std;
-using namespace Gdiplus;
 
  /// Default image
 const std::wstring EmptyImage = L"dart.png";
 
-/// Constant to covert radians to degrees.
-const double RtoD = 57.2957795;
+/// Radians in a full turn
+const double FullTurn = 6.28318530717958648;
 
 /** CDart Constructor
  * @param item The Towers game 
@@ -27,14 +28,23 @@ CDart::CDart(CTowersGame* item) : CEntity(item)
 {
     // Creates a dart object
     wstring filename = ImagesDirectory + EmptyImage;
-    mItemImage = std::unique_ptr<Gdiplus::Bitmap>(Gdiplus::Bitmap::FromFile(filename.c_str()));
-    if (mItemImage->GetLastStatus() != Ok)
+    mItemImage = CImageCache::Instance().Get(filename);
+    if (mItemImage == nullptr)
     {
         wstring msg(L"Failed to open ");
         msg += EmptyImage;
-        AfxMessageBox(msg.c_str());
+        GetGame()->ShowMessage(msg);
         return;
     }
+
+    // Towers only fire along the compass directions, so the images for
+    // those are found once here and setting the angle just picks one
+    for (int sector = 0; sector < Sectors; sector++)
+    {
+        mSectorImages[sector] = CImageCache::Instance().GetRotated(mItemImage, sector * FullTurn / Sectors);
+    }
+
+    SetAngle(mAngle);
 }
 
 /// Default destructor
@@ -43,28 +53,55 @@ CDart::~CDart()
 }
 
 /**
- * Draw the rotated dart. Rotation is determined by the member
- * variable mAngle, which is the rotation in radians.
+ * Draw the rotated dart from its image turned to mAngle.
  *
  * @param graphics The graphics context to draw on.
  * @param offsetX An X offset added to the position of the dart.
  * @param offsetY A Y offset added to the position of the dart.
  */
-void CDart::Draw(Gdiplus::Graphics* graphics, int offsetX, int offsetY)
+void CDart::Draw(CRenderer* graphics, int offsetX, int offsetY)
 {
-    if (mItemImage != nullptr) {
-        int wid = mItemImage->GetWidth();
-        int hit = mItemImage->GetHeight();
-
-        auto save = graphics->Save(); // Save the image if transforming
+    if (mRotatedImage != nullptr) {
+        int wid = mRotatedImage->GetWidth();
+        int hit = mRotatedImage->GetHeight();
+        graphics->DrawImage(mRotatedImage.get(), GetX() + offsetX - wid / 2, GetY() + offsetY - hit / 2, wid, hit);
+    }
+}
 
-        graphics->TranslateTransform((REAL)(GetX() + offsetX),
-            (REAL)(GetY() + offsetY));
-        graphics->RotateTransform((REAL)(mAngle * RtoD));
-        graphics->DrawImage(mItemImage.get(), -wid / 2, -hit / 2, wid, hit);
+/**
+ * Set the angle the dart points and flies in.
+ *
+ * The image turned to this angle comes from the image cache,
+ * so drawing is a plain copy with no transform.
+ * @param newAngle Clockwise rotation in radians
+ */
+void CDart::SetAngle(double newAngle)
+{
+    mAngle = newAngle;
 
-        graphics->Restore(save); // Reload the image after transforming
+    // An angle the cache rounds to a firing direction gets that image
+    // without a lookup, any other angle is turned by the cache
+    auto& cache = CImageCache::Instance();
+    int steps = cache.GetRotationSteps();
+    int step = CImageCache::RotationStep(newAngle, steps);
+    if (step * Sectors % steps == 0)
+    {
+        mRotatedImage = mSectorImages[step * Sectors / steps];
     }
+    else
+    {
+        mRotatedImage = cache.GetRotated(mItemImage, newAngle);
+    }
+}
+
+/**
+ * Put the dart back the way the constructor left it
+ */
+void CDart::Reset()
+{
+    CEntity::Reset();
+    mAngle = 0;
+    mRotatedImage = mSectorImages[0];
 }
 
 /** Handle updates for animation. Overrides the CItem method
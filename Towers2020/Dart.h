@@ -28,7 +28,7 @@ public:
 	/// Copy Constructor Disabled
 	CDart(const CDart&) = delete;
 
-	void Draw(Gdiplus::Graphics* graphics, int offsetX, int offsetY);
+	void Draw(CRenderer* graphics, int offsetX, int offsetY);
 
 	virtual void Update(double elapsed) override;
 
@@ -37,10 +37,12 @@ public:
 	 */
 	virtual void Accept(CItemVisitor* visitor) override { }
 
-	/** Sets the angular offset to determine rotation of dart
-	 * @param newAngle The new angular offset 
-	 */
-	void SetAngle(double newAngle) { mAngle = newAngle; }
+	/// Compass directions towers fire in, each with an image turned to it
+	static const int Sectors = 8;
+
+	void SetAngle(double newAngle);
+
+	virtual void Reset() override;
 
 	/** Gets the angular offset which determine rotation of dart
 	 * @returns The angular offset 
@@ -50,12 +52,18 @@ public:
 	/** Method Disabled (no entities are drawn on ship entities)
 	 * @param graphics The graphics 
 	 */
-	virtual void RenderEntities(Gdiplus::Graphics* graphics) {};
+	virtual void RenderEntities(CRenderer* graphics) {};
 
 private:
 
-	/// The image of this dart
-	std::unique_ptr<Gdiplus::Bitmap> mItemImage;
+	/// The image of this dart, shared through the image cache
+	std::shared_ptr<CGameImage> mItemImage;
+
+	/// The image turned to mAngle, shared through the image cache
+	std::shared_ptr<CGameImage> mRotatedImage;
+
+	/// The image turned to each firing direction, found when the dart is made
+	std::shared_ptr<CGameImage> mSectorImages[Sectors];
 
 	/// The angle of this dart
 	double mAngle = 0;
@@ -12,7 +12,6 @@
 #include "DiagTimer.h"
 
 using namespace std;
-using namespace Gdiplus;
 
 /** 
  * Constructor
@@ -32,7 +31,7 @@ CDiagTimer::~CDiagTimer()
  * Draws a timer. Overrwitten fucntion.
  * @param graphics The Graphics object 
  */
-void CDiagTimer::Draw(Gdiplus::Graphics* graphics)
+void CDiagTimer::Draw(CRenderer* graphics)
 {
     
 }
@@ -28,7 +28,7 @@ public:
 
     ~CDiagTimer();
 
-    virtual void Draw(Gdiplus::Graphics* graphics) override;
+    virtual void Draw(CRenderer* graphics) override;
 
     /** 
      * Accept a visitor
@@ -41,7 +41,7 @@ public:
     /** Method Disabled (no entities are drawn on ship entities)
      * @param graphics The graphics 
      */
-    virtual void RenderEntities(Gdiplus::Graphics* graphics) {};
+    virtual void RenderEntities(CRenderer* graphics) {};
 
 private:
 
@@ -21,7 +21,7 @@ public:
     ///  Default constructor (disabled)
     CDialogue() = delete;
 
-    void CDialogue::XmlLoad(const std::shared_ptr<xmlnode::CXmlNode>& node);
+    void XmlLoad(const std::shared_ptr<xmlnode::CXmlNode>& node);
 
     ///  Copy constructor (disabled)
     CDialogue(const CDialogue&) = delete;
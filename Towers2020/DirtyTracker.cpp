@@ -0,0 +1,264 @@
+/**
+ * \file DirtyTracker.cpp
+ *
+ * \author Morgan Mundell
+ */
+
+#include "pch.h"
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <iterator>
+#include "DirtyTracker.h"
+#include "GameImage.h"
+
+using namespace std;
+
+/// Device pixels added around each call for antialiased edges
+const int EdgeMargin = 2;
+
+/**
+ * Combine a value into a hash
+ * @param hash Hash so far
+ * @param value Hash of the value to add
+ * @returns Combined hash
+ */
+static size_t Combine(size_t hash, size_t value)
+{
+    return hash ^ (value + 0x9e3779b97f4a7c15ULL + (hash << 6) + (hash >> 2));
+}
+
+/**
+ * Hash of a color
+ * @param color The color
+ * @returns Hash
+ */
+static size_t HashColor(CRenderer::Color color)
+{
+    return hash<unsigned int>()((unsigned int)color.mAlpha << 24 | (unsigned int)color.mRed << 16 |
+        (unsigned int)color.mGreen << 8 | (unsigned int)color.mBlue);
+}
+
+/**
+ * Grow this rectangle to cover another as well
+ * @param other Rectangle to cover
+ */
+void CDirtyTracker::Rect::Union(const Rect& other)
+{
+    if (other.IsEmpty())
+    {
+        return;
+    }
+
+    if (IsEmpty())
+    {
+        *this = other;
+        return;
+    }
+
+    mLeft = min(mLeft, other.mLeft);
+    mTop = min(mTop, other.mTop);
+    mRight = max(mRight, other.mRight);
+    mBottom = max(mBottom, other.mBottom);
+}
+
+/**
+ * Order calls by where they drew, then by what
+ * @param other Call to compare with
+ * @returns True if this call comes first
+ */
+bool CDirtyTracker::Drawn::operator<(const Drawn& other) const
+{
+    if (mBounds.mLeft != other.mBounds.mLeft)
+        return mBounds.mLeft < other.mBounds.mLeft;
+
+    if (mBounds.mTop != other.mBounds.mTop)
+        return mBounds.mTop < other.mBounds.mTop;
+
+    if (mBounds.mRight != other.mBounds.mRight)
+        return mBounds.mRight < other.mBounds.mRight;
+
+    if (mBounds.mBottom != other.mBounds.mBottom)
+        return mBounds.mBottom < other.mBounds.mBottom;
+
+    return mContent < other.mContent;
+}
+
+/**
+ * Start recording a frame
+ */
+void CDirtyTracker::BeginFrame()
+{
+    mCurrent.clear();
+    mTransform[0] = 0;
+    mTransform[1] = 0;
+    mTransform[2] = 1;
+    copy(mTransform, mTransform + 3, mFrameTransform);
+    mTransformSet = false;
+}
+
+/**
+ * Finish recording a frame and find what changed since the one before
+ */
+void CDirtyTracker::EndFrame()
+{
+    sort(mCurrent.begin(), mCurrent.end());
+
+    mDirty.clear();
+    mAllDirty = mFirstFrame || !equal(mFrameTransform, mFrameTransform + 3, mPreviousTransform);
+    if (!mAllDirty)
+    {
+        // Calls in only one of the frames are what moved, appeared or went away
+        vector<Drawn> changed;
+        set_symmetric_difference(mPrevious.begin(), mPrevious.end(), mCurrent.begin(), mCurrent.end(),
+            back_inserter(changed));
+
+        for (auto& drawn : changed)
+        {
+            mDirty.push_back(drawn.mBounds);
+        }
+
+        if (mDirty.size() > MaxRects)
+        {
+            Rect all;
+            for (auto& rect : mDirty)
+            {
+                all.Union(rect);
+            }
+
+            mDirty.clear();
+            mDirty.push_back(all);
+        }
+    }
+
+    mPrevious.swap(mCurrent);
+    copy(mFrameTransform, mFrameTransform + 3, mPreviousTransform);
+    mFirstFrame = false;
+}
+
+/**
+ * Forget the previous frame, so the next one is all dirty
+ */
+void CDirtyTracker::Reset()
+{
+    mPrevious.clear();
+    mFirstFrame = true;
+}
+
+/**
+ * Set the transform from virtual pixels to the device.
+ *
+ * The first transform of a frame is the one compared between frames.
+ * @param x Horizontal offset in device pixels
+ * @param y Vertical offset in device pixels
+ * @param scale Device pixels per virtual pixel
+ */
+void CDirtyTracker::SetTransform(double x, double y, double scale)
+{
+    if (!mTransformSet)
+    {
+        mTransformSet = true;
+        mFrameTransform[0] = x;
+        mFrameTransform[1] = y;
+        mFrameTransform[2] = scale;
+    }
+
+    mTransform[0] = x;
+    mTransform[1] = y;
+    mTransform[2] = scale;
+}
+
+/**
+ * Record an image
+ * @param image The image to draw
+ * @param x Left of the image
+ * @param y Top of the image
+ * @param width Width to draw the image
+ * @param height Height to draw the image
+ */
+void CDirtyTracker::DrawImage(const CGameImage* image, double x, double y, double width, double height)
+{
+    Add(x, y, width, height, hash<const void*>()(image));
+}
+
+/**
+ * Record a filled rectangle
+ * @param x Left of the rectangle
+ * @param y Top of the rectangle
+ * @param width Rectangle width
+ * @param height Rectangle height
+ * @param color Fill color
+ */
+void CDirtyTracker::FillRectangle(double x, double y, double width, double height, Color color)
+{
+    Add(x, y, width, height, Combine(1, HashColor(color)));
+}
+
+/**
+ * Record a filled ellipse
+ * @param x Left of the bounding rectangle
+ * @param y Top of the bounding rectangle
+ * @param width Width of the bounding rectangle
+ * @param height Height of the bounding rectangle
+ * @param color Fill color
+ */
+void CDirtyTracker::FillEllipse(double x, double y, double width, double height, Color color)
+{
+    Add(x, y, width, height, Combine(2, HashColor(color)));
+}
+
+/**
+ * Record an ellipse outline
+ * @param x Left of the bounding rectangle
+ * @param y Top of the bounding rectangle
+ * @param width Width of the bounding rectangle
+ * @param height Height of the bounding rectangle
+ * @param color Line color
+ * @param penWidth Width of the line
+ */
+void CDirtyTracker::DrawEllipse(double x, double y, double width, double height, Color color, double penWidth)
+{
+    double half = penWidth / 2;
+    Add(x - half, y - half, width + penWidth, height + penWidth,
+        Combine(Combine(3, HashColor(color)), hash<double>()(penWidth)));
+}
+
+/**
+ * Record text.
+ *
+ * The text is not laid out, so its bounds are a generous
+ * estimate of the space Arial takes at this size.
+ * @param text The text to draw
+ * @param x Left of the text
+ * @param y Top of the text
+ * @param size Font size in points
+ * @param color Text color
+ */
+void CDirtyTracker::DrawString(const wstring& text, double x, double y, double size, Color color)
+{
+    Add(x, y, (text.size() + 1) * size, size * 2, Combine(hash<wstring>()(text), HashColor(color)));
+}
+
+/**
+ * Record a call
+ * @param x Left of what was drawn in virtual pixels
+ * @param y Top of what was drawn in virtual pixels
+ * @param width Width of what was drawn
+ * @param height Height of what was drawn
+ * @param content Hash of what was drawn
+ */
+void CDirtyTracker::Add(double x, double y, double width, double height, size_t content)
+{
+    double left = mTransform[0] + min(x, x + width) * mTransform[2];
+    double right = mTransform[0] + max(x, x + width) * mTransform[2];
+    double top = mTransform[1] + min(y, y + height) * mTransform[2];
+    double bottom = mTransform[1] + max(y, y + height) * mTransform[2];
+
+    Drawn drawn;
+    drawn.mBounds.mLeft = (int)floor(left) - EdgeMargin;
+    drawn.mBounds.mTop = (int)floor(top) - EdgeMargin;
+    drawn.mBounds.mRight = (int)ceil(right) + EdgeMargin;
+    drawn.mBounds.mBottom = (int)ceil(bottom) + EdgeMargin;
+    drawn.mContent = content;
+    mCurrent.push_back(drawn);
+}
@@ -0,0 +1,126 @@
+/**
+ * \file DirtyTracker.h
+ *
+ * \author Morgan Mundell
+ *
+ *  Renderer that finds the parts of the window that changed between frames
+ */
+
+#pragma once
+
+#include <vector>
+#include "Renderer.h"
+
+/**
+ * Renderer that draws nothing and remembers where each call would draw.
+ *
+ * The game's moving parts are drawn through the tracker once per frame.
+ * Every call is kept with its bounds in device pixels and what it drew.
+ * A call that is not exactly repeated in the next frame marks its old
+ * and new bounds as dirty, so only those parts of the window need to be
+ * painted again. A frame drawn with a different transform than the one
+ * before makes the whole window dirty.
+ */
+class CDirtyTracker : public CRenderer
+{
+public:
+    /// A rectangle in device pixels, right and bottom exclusive
+    struct Rect
+    {
+        int mLeft = 0;      ///< Left edge
+        int mTop = 0;       ///< Top edge
+        int mRight = 0;     ///< Right edge
+        int mBottom = 0;    ///< Bottom edge
+
+        /**
+         * Does the rectangle cover no pixels?
+         * @returns True if empty
+         */
+        bool IsEmpty() const { return mRight <= mLeft || mBottom <= mTop; }
+
+        void Union(const Rect& other);
+    };
+
+    /// Most rectangles reported before they are combined into one
+    static const int MaxRects = 16;
+
+    CDirtyTracker() {}
+
+    ///  Copy constructor (disabled)
+    CDirtyTracker(const CDirtyTracker&) = delete;
+
+    void BeginFrame();
+
+    void EndFrame();
+
+    void Reset();
+
+    /**
+     * The rectangles that changed in the last frame
+     * @returns Dirty rectangles, empty if nothing changed
+     */
+    const std::vector<Rect>& GetDirty() const { return mDirty; }
+
+    /**
+     * Did the last frame change so much the whole window must be painted?
+     * @returns True if everything is dirty
+     */
+    bool IsAllDirty() const { return mAllDirty; }
+
+    /**
+     * The tracker only records bounds
+     * @returns False
+     */
+    virtual bool IsDrawing() const override { return false; }
+
+    virtual void SetTransform(double x, double y, double scale) override;
+
+    virtual void DrawImage(const CGameImage* image, double x, double y, double width, double height) override;
+
+    virtual void FillRectangle(double x, double y, double width, double height, Color color) override;
+
+    virtual void FillEllipse(double x, double y, double width, double height, Color color) override;
+
+    virtual void DrawEllipse(double x, double y, double width, double height, Color color, double penWidth) override;
+
+    virtual void DrawString(const std::wstring& text, double x, double y, double size, Color color) override;
+
+private:
+    /// One drawing call
+    struct Drawn
+    {
+        Rect mBounds;               ///< Where it drew
+        size_t mContent = 0;        ///< Hash of what it drew
+
+        bool operator<(const Drawn& other) const;
+    };
+
+    void Add(double x, double y, double width, double height, size_t content);
+
+    /// Calls made in the frame being drawn
+    std::vector<Drawn> mCurrent;
+
+    /// Calls made in the frame before, sorted
+    std::vector<Drawn> mPrevious;
+
+    /// Dirty rectangles found by the last EndFrame
+    std::vector<Rect> mDirty;
+
+    /// True if the last EndFrame found everything dirty
+    bool mAllDirty = true;
+
+    /// True until a frame has been drawn to compare against
+    bool mFirstFrame = true;
+
+    /// Transform calls are drawn with: x offset, y offset and scale
+    double mTransform[3] = { 0, 0, 1 };
+
+    /// First transform set in the frame being drawn
+    double mFrameTransform[3] = { 0, 0, 1 };
+
+    /// First transform set in the frame before
+    double mPreviousTransform[3] = { 0, 0, 1 };
+
+    /// True once the frame being drawn has set a transform
+    bool mTransformSet = false;
+};
@@ -10,9 +10,9 @@
 
 #include "pch.h"
 #include "Entity.h"
+#include "TowersGame.h"
 
 using namespace std;
-using namespace Gdiplus;
 
 /// Maximum speed in the X direction in pixels per second 
 const double MaxSpeedX = 50;
@@ -22,7 +22,7 @@ const double MaxSpeedX = 50;
  */
 CEntity::CEntity(CTowersGame* game) : CItem(game)
 {
-    mSpeedX = ((double)rand() / RAND_MAX) * MaxSpeedX;
+    mSpeedX = game->Random() * MaxSpeedX;
 }
 
 /// Default destructor
@@ -30,6 +30,18 @@ CEntity::~CEntity()
 {
 }
 
+/**
+ * Put the entity back the way the constructor left it,
+ * so an entity from a pool can be used again.
+ */
+void CEntity::Reset()
+{
+    SetLocation(0, 0);
+    mXOffset = 0;
+    mYOffset = 0;
+    mSpeedX = GetGame()->Random() * MaxSpeedX;
+}
+
 /**
 * Load function DISABLED
 */
@@ -47,5 +59,5 @@ CEntity::~CEntity()
  */
 void CEntity::SetSpeed(double minX, double maxX)
 {
-    mSpeedX = minX + ((double)rand() / RAND_MAX) * (maxX - minX);
+    mSpeedX = minX + GetGame()->Random() * (maxX - minX);
 }
\ No newline at end of file
@@ -32,6 +32,8 @@ public:
 
 	void SetSpeed(double minX, double maxX);
 
+	virtual void Reset();
+
 	/** 
 	 * Sets the X offset to determine location of the object
 	 * @param newOffsetX The new X offset 
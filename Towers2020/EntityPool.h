@@ -0,0 +1,198 @@
+/**
+ * \file EntityPool.h
+ *
+ * \author Morgan Mundell
+ *
+ *  Pool that hands out short lived entities and takes them back for reuse
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <deque>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+class CTowersGame;
+
+/**
+ * Pool of entities of one type that are made once and used again.
+ *
+ * Towers fire projectiles every few seconds and drop them a second
+ * later. Instead of a new entity each time, one is taken from the pool
+ * and given back when it is done with, then reset when it is handed
+ * out again. Entities live in a deque, so they never move and a pointer
+ * stays good until it is released.
+ *
+ * At most the high-water mark of entities are kept. Past that the pool
+ * makes entities on the heap as before and deletes them when released,
+ * so a burst of firing still works without holding its memory forever.
+ *
+ * Once the pool has grown to what the game needs, acquiring and
+ * releasing entities makes no heap allocations. Releasing an entity
+ * that is not handed out, such as one already released, is ignored.
+ * @tparam T Entity type, made from a game and with a Reset method
+ */
+template <class T>
+class CEntityPool
+{
+public:
+    /// Entities kept for reuse unless set otherwise
+    static const size_t DefaultHighWater = 4096;
+
+    /**
+     * Constructor
+     * @param game The game the entities are made for
+     */
+    CEntityPool(CTowersGame* game) : mGame(game) {}
+
+    ///  Default constructor (disabled)
+    CEntityPool() = delete;
+
+    ///  Copy constructor (disabled)
+    CEntityPool(const CEntityPool&) = delete;
+
+    /**
+     * Get an entity as if it were just made
+     * @returns The entity, good until it is released
+     */
+    T* Acquire()
+    {
+        T* entity;
+        if (!mFree.empty())
+        {
+            entity = mFree.back();
+            mFree.pop_back();
+            mInPool[entity] = false;
+            entity->Reset();
+            mReused++;
+        }
+        else if (mStorage.size() < mHighWater)
+        {
+            mStorage.emplace_back(mGame);
+            entity = &mStorage.back();
+            mInPool.emplace(entity, false);
+            mCreated++;
+        }
+        else
+        {
+            auto made = std::make_unique<T>(mGame);
+            entity = made.get();
+            mOverflow.emplace(entity, std::move(made));
+            mCreated++;
+        }
+
+        mLive++;
+        mPeak = std::max(mPeak, mLive);
+        return entity;
+    }
+
+    /**
+     * Give an entity back to the pool.
+     *
+     * The entity must not be used again by the caller.
+     * @param entity Entity from Acquire, nullptr or one not handed out is ignored
+     */
+    void Release(T* entity)
+    {
+        if (entity == nullptr)
+        {
+            return;
+        }
+
+        auto overflow = mOverflow.find(entity);
+        if (overflow != mOverflow.end())
+        {
+            mOverflow.erase(overflow);
+            mLive--;
+            return;
+        }
+
+        // Entities not from this pool, or already back in it, are left alone
+        auto pooled = mInPool.find(entity);
+        if (pooled == mInPool.end() || pooled->second)
+        {
+            return;
+        }
+
+        pooled->second = true;
+        mFree.push_back(entity);
+        mLive--;
+    }
+
+    /**
+     * Set the most entities kept for reuse.
+     *
+     * Entities already in the pool are kept if the mark is lowered.
+     * @param highWater Most entities kept
+     */
+    void SetHighWater(size_t highWater) { mHighWater = highWater; }
+
+    /**
+     * The most entities kept for reuse
+     * @returns High-water mark
+     */
+    size_t GetHighWater() const { return mHighWater; }
+
+    /**
+     * Number of entities handed out and not yet released
+     * @returns Live count
+     */
+    size_t GetLive() const { return mLive; }
+
+    /**
+     * Most entities that have been live at once
+     * @returns Peak live count
+     */
+    size_t GetPeak() const { return mPeak; }
+
+    /**
+     * Number of entities kept by the pool, live or free
+     * @returns Pooled count
+     */
+    size_t GetPooled() const { return mStorage.size(); }
+
+    /**
+     * Number of entities that had to be made
+     * @returns Created count
+     */
+    long long GetCreated() const { return mCreated; }
+
+    /**
+     * Number of times a released entity was handed out again
+     * @returns Reused count
+     */
+    long long GetReused() const { return mReused; }
+
+private:
+    /// The game entities are made for
+    CTowersGame* mGame;
+
+    /// Entities kept by the pool, which never move
+    std::deque<T> mStorage;
+
+    /// Entities in mStorage that are not handed out
+    std::vector<T*> mFree;
+
+    /// Whether each entity in mStorage is in the pool rather than handed out
+    std::unordered_map<const T*, bool> mInPool;
+
+    /// Entities made past the high-water mark, deleted when released
+    std::unordered_map<const T*, std::unique_ptr<T>> mOverflow;
+
+    /// Most entities kept in mStorage
+    size_t mHighWater = DefaultHighWater;
+
+    /// Entities handed out and not yet released
+    size_t mLive = 0;
+
+    /// Most entities live at once
+    size_t mPeak = 0;
+
+    /// Entities made
+    long long mCreated = 0;
+
+    /// Entities handed out again
+    long long mReused = 0;
+};
@@ -0,0 +1,158 @@
+/**
+ * \file FileUtils.cpp
+ *
+ * \author Morgan Mundell
+ */
+
+#include "pch.h"
+#include <fstream>
+#include <iterator>
+#include "FileUtils.h"
+
+using namespace std;
+
+/**
+ * Read the contents of a file.
+ * @param filename The path to the file
+ * @param contents Receives the bytes of the file
+ * @param limit Maximum number of bytes to read
+ * @returns False if the file could not be opened
+ */
+bool ReadFileContents(const wstring& filename, string& contents, size_t limit)
+{
+#ifdef _WIN32
+    ifstream file(filename.c_str(), ios::binary);
+#else
+    ifstream file(WideToUtf8(filename), ios::binary);
+#endif
+    if (!file)
+    {
+        return false;
+    }
+
+    if (limit == string::npos)
+    {
+        contents.assign(istreambuf_iterator<char>(file), istreambuf_iterator<char>());
+    }
+    else
+    {
+        contents.resize(limit);
+        file.read(&contents[0], limit);
+        contents.resize((size_t)file.gcount());
+    }
+
+    return true;
+}
+
+/**
+ * Write the contents of a file, replacing anything already there.
+ * @param filename The path to the file
+ * @param contents The bytes to write
+ * @returns False if the file could not be written
+ */
+bool WriteFileContents(const wstring& filename, const string& contents)
+{
+#ifdef _WIN32
+    ofstream file(filename.c_str(), ios::binary);
+#else
+    ofstream file(WideToUtf8(filename), ios::binary);
+#endif
+    if (!file)
+    {
+        return false;
+    }
+
+    file.write(contents.data(), contents.size());
+    return (bool)file;
+}
+
+/**
+ * Convert UTF-8 text to a wide string.
+ *
+ * Invalid bytes are passed through as single characters.
+ * @param text UTF-8 text
+ * @returns Wide string
+ */
+wstring Utf8ToWide(const string& text)
+{
+    wstring wide;
+    wide.reserve(text.size());
+
+    for (size_t i = 0; i < text.size(); )
+    {
+        unsigned char c = text[i];
+        int extra = c >= 0xf0 ? 3 : c >= 0xe0 ? 2 : c >= 0xc0 ? 1 : 0;
+        if (i + extra >= text.size())
+        {
+            extra = 0;
+        }
+
+        unsigned long code = extra == 0 ? c : c & (0x3f >> extra);
+        for (int b = 1; b <= extra; b++)
+        {
+            code = (code << 6) | (text[i + b] & 0x3f);
+        }
+        i += extra + 1;
+
+        if (code > 0xffff && sizeof(wchar_t) == 2)
+        {
+            // Surrogate pair for 16 bit wide characters
+            code -= 0x10000;
+            wide += wchar_t(0xd800 + (code >> 10));
+            wide += wchar_t(0xdc00 + (code & 0x3ff));
+        }
+        else
+        {
+            wide += wchar_t(code);
+        }
+    }
+
+    return wide;
+}
+
+/**
+ * Convert a wide string to UTF-8 text.
+ * @param text Wide string
+ * @returns UTF-8 text
+ */
+string WideToUtf8(const wstring& text)
+{
+    string narrow;
+    narrow.reserve(text.size());
+
+    for (size_t i = 0; i < text.size(); i++)
+    {
+        unsigned long code = (unsigned long)text[i];
+
+        // Combine surrogate pairs from 16 bit wide characters
+        if (code >= 0xd800 && code < 0xdc00 && i + 1 < text.size())
+        {
+            code = 0x10000 + ((code - 0xd800) << 10) + ((unsigned long)text[++i] - 0xdc00);
+        }
+
+        if (code < 0x80)
+        {
+            narrow += char(code);
+        }
+        else if (code < 0x800)
+        {
+            narrow += char(0xc0 | (code >> 6));
+            narrow += char(0x80 | (code & 0x3f));
+        }
+        else if (code < 0x10000)
+        {
+            narrow += char(0xe0 | (code >> 12));
+            narrow += char(0x80 | ((code >> 6) & 0x3f));
+            narrow += char(0x80 | (code & 0x3f));
+        }
+        else
+        {
+            narrow += char(0xf0 | (code >> 18));
+            narrow += char(0x80 | ((code >> 12) & 0x3f));
+            narrow += char(0x80 | ((code >> 6) & 0x3f));
+            narrow += char(0x80 | (code & 0x3f));
+        }
+    }
+
+    return narrow;
+}
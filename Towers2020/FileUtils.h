@@ -0,0 +1,19 @@
+/**
+ * \file FileUtils.h
+ *
+ * \author Morgan Mundell
+ *
+ *  Platform independent file reading and text conversion
+ */
+
+#pragma once
+
+#include <string>
+
+bool ReadFileContents(const std::wstring& filename, std::string& contents, size_t limit = std::string::npos);
+
+bool WriteFileContents(const std::wstring& filename, const std::string& contents);
+
+std::wstring Utf8ToWide(const std::string& text);
+
+std::string WideToUtf8(const std::wstring& text);
@@ -16,9 +16,9 @@ public:
 
 	void FindBalloon();
 
-	void CFindBalloon::VisitTileRoad(CTileRoad* road) override;
+	void VisitTileRoad(CTileRoad* road) override;
 
-	void CFindBalloon::VisitBalloon(CBalloon* balloon) override;
+	void VisitBalloon(CBalloon* balloon) override;
 
 private:
 	/// The road object
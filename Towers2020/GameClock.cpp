@@ -0,0 +1,89 @@
+/**
+ * \file GameClock.cpp
+ *
+ * \author Morgan Mundell
+ */
+
+#include "pch.h"
+#include <cmath>
+#include "GameClock.h"
+
+using namespace std;
+
+/**
+ * Constructor
+ * @param tickRate Simulation ticks per second
+ */
+CGameClock::CGameClock(double tickRate)
+{
+    SetTickRate(tickRate);
+}
+
+/**
+ * Set the number of simulation ticks per second.
+ *
+ * Time already accumulated is kept, so changing the rate does
+ * not lose or repeat any simulated time.
+ * @param tickRate Ticks per second, must be greater than zero
+ */
+void CGameClock::SetTickRate(double tickRate)
+{
+    mStep = 1.0 / (tickRate > 0 ? tickRate : DefaultTickRate);
+}
+
+/**
+ * Set how many times faster than real time the simulation runs.
+ *
+ * The step stays the same, a faster clock just hands out more
+ * steps per frame, so a sped up game plays exactly like a normal one.
+ * The tick limit per frame grows with the speed.
+ * @param speed Speed multiplier, 1 for normal speed
+ */
+void CGameClock::SetSpeed(double speed)
+{
+    mSpeed = speed > 0 ? speed : 1;
+}
+
+/**
+ * Add real time to the clock.
+ * @param elapsed Real time since the last call in seconds
+ * @returns Number of fixed steps the simulation should run now
+ */
+int CGameClock::Advance(double elapsed)
+{
+    if (elapsed > 0)
+    {
+        mAccumulator += elapsed * mSpeed;
+    }
+
+    int maxTicks = (int)ceil(mMaxTicks * (mSpeed > 1 ? mSpeed : 1));
+
+    int ticks = 0;
+    while (mAccumulator >= mStep)
+    {
+        if (ticks == maxTicks)
+        {
+            // Too far behind to catch up, keep only the partial step
+            double behind = mAccumulator - fmod(mAccumulator, mStep);
+            mAccumulator -= behind;
+            mDropped += behind;
+            break;
+        }
+
+        mAccumulator -= mStep;
+        ticks++;
+    }
+
+    mTicks += ticks;
+    return ticks;
+}
+
+/**
+ * Forget any accumulated time and the tick counts
+ */
+void CGameClock::Reset()
+{
+    mAccumulator = 0;
+    mTicks = 0;
+    mDropped = 0;
+}
@@ -0,0 +1,104 @@
+/**
+ * \file GameClock.h
+ *
+ * \author Morgan Mundell
+ *
+ *  Fixed timestep accumulator for the simulation
+ */
+
+#pragma once
+
+/**
+ * Turns variable frame times into a whole number of fixed simulation ticks.
+ *
+ * Each frame the real time that passed is added to an accumulator
+ * and the simulation is advanced one fixed step for every step the
+ * accumulator holds. Whatever is left over is less than one step
+ * and is reported as an interpolation fraction for drawing. Since
+ * the simulation only ever sees the fixed step, it does the same
+ * thing no matter how often or how regularly frames are drawn.
+ */
+class CGameClock
+{
+public:
+    /// Default simulation ticks per second
+    static const int DefaultTickRate = 40;
+
+    /// Default limit on ticks run for one frame
+    static const int DefaultMaxTicks = 10;
+
+    CGameClock(double tickRate = DefaultTickRate);
+
+    void SetTickRate(double tickRate);
+
+    /**
+     * Set the most ticks Advance will ask for at once.
+     *
+     * If a frame takes so long that more ticks than this are due,
+     * the extra time is dropped rather than carried over, so one
+     * slow frame cannot make every following frame slower.
+     * @param maxTicks Maximum ticks per frame
+     */
+    void SetMaxTicks(int maxTicks) { mMaxTicks = maxTicks > 0 ? maxTicks : 1; }
+
+    void SetSpeed(double speed);
+
+    /**
+     * How many times faster than real time the simulation runs
+     * @returns Speed multiplier, 1 for normal speed
+     */
+    double GetSpeed() const { return mSpeed; }
+
+    int Advance(double elapsed);
+
+    void Reset();
+
+    /**
+     * Simulation ticks per second
+     * @returns Tick rate
+     */
+    double GetTickRate() const { return 1.0 / mStep; }
+
+    /**
+     * Simulated time of one tick
+     * @returns Step in seconds
+     */
+    double GetStep() const { return mStep; }
+
+    /**
+     * How far the real time is between the last tick and the next
+     * @returns Fraction from 0 up to but not including 1
+     */
+    double GetAlpha() const { return mAccumulator / mStep; }
+
+    /**
+     * Total ticks handed out since the last reset
+     * @returns Tick count
+     */
+    long long GetTicks() const { return mTicks; }
+
+    /**
+     * Time dropped because frames fell too far behind
+     * @returns Dropped time in seconds
+     */
+    double GetDroppedTime() const { return mDropped; }
+
+private:
+    /// Simulated time of one tick in seconds
+    double mStep;
+
+    /// Time not yet simulated
+    double mAccumulator = 0;
+
+    /// Most ticks to run for one frame at normal speed
+    int mMaxTicks = DefaultMaxTicks;
+
+    /// Simulated seconds per real second
+    double mSpeed = 1;
+
+    /// Ticks handed out since the last reset
+    long long mTicks = 0;
+
+    /// Time dropped since the last reset
+    double mDropped = 0;
+};
@@ -0,0 +1,38 @@
+/**
+ * \file GameHost.h
+ *
+ * \author Morgan Mundell
+ *
+ *  Interface to whatever is running the game
+ */
+
+#pragma once
+
+#include <string>
+
+/**
+ * Interface to whatever is running the game.
+ *
+ * The game reports errors and asks questions through this
+ * interface, so it never needs a window of its own. The Windows
+ * application answers with message boxes.
+ */
+class CGameHost
+{
+public:
+    virtual ~CGameHost() {}
+
+    /**
+     * Tell the player something, usually an error
+     * @param message The message to show
+     */
+    virtual void ShowMessage(const std::wstring& message) = 0;
+
+    /**
+     * Ask the player a yes or no question
+     * @param question The question to ask
+     * @param title Title for the question
+     * @returns True if the answer is yes
+     */
+    virtual bool AskYesNo(const std::wstring& question, const std::wstring& title) = 0;
+};
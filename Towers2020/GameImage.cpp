@@ -0,0 +1,65 @@
+/**
+ * \file GameImage.cpp
+ *
+ * \author Morgan Mundell
+ */
+
+#include "pch.h"
+#include <algorithm>
+#include <iterator>
+#include "GameImage.h"
+#include "FileUtils.h"
+
+using namespace std;
+
+/**
+ * Constructor
+ * @param width Width in pixels
+ * @param height Height in pixels
+ * @param hitMask Mask of the visible pixels
+ */
+CGameImage::CGameImage(int width, int height, shared_ptr<CHitMask> hitMask) :
+    mWidth(width), mHeight(height), mHitMask(hitMask)
+{
+}
+
+/**
+ * Describe a PNG file from its header alone.
+ *
+ * The pixels are not decoded, so every pixel of the
+ * image is treated as visible.
+ * @param filename The path to the image file
+ * @returns The image or nullptr if the file is not a readable PNG
+ */
+shared_ptr<CGameImage> CGameImage::ReadHeader(const wstring& filename)
+{
+    // Signature, then the length and type of the IHDR chunk, then the width and height
+    const size_t HeaderSize = 24;
+    const unsigned char Signature[] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n' };
+
+    string header;
+    if (!ReadFileContents(filename, header, HeaderSize) || header.size() < HeaderSize)
+    {
+        return nullptr;
+    }
+
+    auto bytes = reinterpret_cast<const unsigned char*>(header.data());
+    if (!equal(begin(Signature), end(Signature), bytes) || header.compare(12, 4, "IHDR") != 0)
+    {
+        return nullptr;
+    }
+
+    // PNG stores integers big endian
+    auto readInt = [bytes](size_t at) {
+        return int((unsigned(bytes[at]) << 24) | (bytes[at + 1] << 16) | (bytes[at + 2] << 8) | bytes[at + 3]);
+    };
+
+    int wid = readInt(16);
+    int hit = readInt(20);
+    if (wid <= 0 || hit <= 0)
+    {
+        return nullptr;
+    }
+
+    return make_shared<CGameImage>(wid, hit, make_shared<CHitMask>(wid, hit, false));
+}
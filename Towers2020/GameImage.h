@@ -0,0 +1,70 @@
+/**
+ * \file GameImage.h
+ *
+ * \author Morgan Mundell
+ *
+ *  Platform independent description of an image file
+ */
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include "HitMask.h"
+
+/**
+ * An image as the simulation sees it.
+ *
+ * The game only needs to know how big an image is and which of
+ * its pixels can be clicked on. Platforms that draw the image
+ * derive from this class and attach their own decoded pixels.
+ */
+class CGameImage
+{
+public:
+    CGameImage(int width, int height, std::shared_ptr<CHitMask> hitMask);
+
+    ///  Default constructor (disabled)
+    CGameImage() = delete;
+
+    ///  Copy constructor (disabled)
+    CGameImage(const CGameImage&) = delete;
+
+    virtual ~CGameImage() {}
+
+    static std::shared_ptr<CGameImage> ReadHeader(const std::wstring& filename);
+
+    /**
+     * Width of the image
+     * @returns Width in pixels
+     */
+    int GetWidth() const { return mWidth; }
+
+    /**
+     * Height of the image
+     * @returns Height in pixels
+     */
+    int GetHeight() const { return mHeight; }
+
+    /**
+     * Mask of the visible pixels of the image
+     * @returns Hit mask
+     */
+    std::shared_ptr<CHitMask> GetHitMask() const { return mHitMask; }
+
+    /**
+     * Number of bytes held by decoded pixels
+     * @returns Size in bytes, zero if the pixels are not decoded
+     */
+    virtual size_t GetBytes() const { return 0; }
+
+private:
+    /// Width in pixels
+    int mWidth;
+
+    /// Height in pixels
+    int mHeight;
+
+    /// Mask of the visible pixels
+    std::shared_ptr<CHitMask> mHitMask;
+};
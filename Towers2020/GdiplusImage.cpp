@@ -0,0 +1,164 @@
+/**
+ * \file GdiplusImage.cpp
+ *
+ * \author Morgan Mundell
+ */
+
+#include "pch.h"
+#include <cmath>
+#include "GdiplusImage.h"
+
+using namespace std;
+using namespace Gdiplus;
+
+/// Radians to degrees conversion
+const double RtoD = 57.2957795;
+
+/**
+ * Constructor
+ * @param bitmap The decoded bitmap
+ * @param hitMask Mask of the visible pixels of the bitmap
+ */
+CGdiplusImage::CGdiplusImage(shared_ptr<Bitmap> bitmap, shared_ptr<CHitMask> hitMask) :
+    CGameImage(bitmap->GetWidth(), bitmap->GetHeight(), hitMask), mBitmap(bitmap)
+{
+}
+
+/**
+ * Number of bytes held by the decoded bitmap
+ * @returns Approximate size in bytes
+ */
+size_t CGdiplusImage::GetBytes() const
+{
+    return (size_t)GetWidth() * GetHeight() * GetPixelFormatSize(mBitmap->GetPixelFormat()) / 8;
+}
+
+/**
+ * Decode an image file with GDI+
+ * @param filename The path to the image file
+ * @returns The image or nullptr if the file could not be decoded
+ */
+shared_ptr<CGameImage> CGdiplusImageLoader::Load(const wstring& filename)
+{
+    auto bitmap = shared_ptr<Bitmap>(Bitmap::FromFile(filename.c_str()));
+    if (bitmap == nullptr || bitmap->GetLastStatus() != Ok)
+    {
+        return nullptr;
+    }
+
+    return make_shared<CGdiplusImage>(bitmap, BuildHitMask(bitmap.get()));
+}
+
+/**
+ * Draw a copy of an image with each color channel scaled
+ * @param image The image to tint, decoded by this loader
+ * @param red Factor for the red channel, 0 to 1
+ * @param green Factor for the green channel, 0 to 1
+ * @param blue Factor for the blue channel, 0 to 1
+ * @returns The tinted image, sharing the hit mask of the original
+ */
+shared_ptr<CGameImage> CGdiplusImageLoader::Tint(const shared_ptr<CGameImage>& image,
+    float red, float green, float blue)
+{
+    auto source = dynamic_cast<const CGdiplusImage*>(image.get());
+    if (source == nullptr)
+    {
+        return image;
+    }
+
+    int wid = image->GetWidth();
+    int hit = image->GetHeight();
+
+    ColorMatrix matrix = {
+        red, 0, 0, 0, 0,
+        0, green, 0, 0, 0,
+        0, 0, blue, 0, 0,
+        0, 0, 0, 1, 0,
+        0, 0, 0, 0, 1 };
+
+    ImageAttributes attributes;
+    attributes.SetColorMatrix(&matrix, ColorMatrixFlagsDefault, ColorAdjustTypeBitmap);
+
+    // Premultiplied pixels are the quickest for GDI+ to draw
+    auto bitmap = make_shared<Bitmap>(wid, hit, PixelFormat32bppPARGB);
+    Graphics graphics(bitmap.get());
+    graphics.DrawImage(source->GetBitmap(), Rect(0, 0, wid, hit), 0, 0, wid, hit, UnitPixel, &attributes);
+
+    return make_shared<CGdiplusImage>(bitmap, image->GetHitMask());
+}
+
+/**
+ * Draw a copy of an image rotated about its center
+ * @param image The image to rotate, decoded by this loader
+ * @param angle Clockwise rotation in radians
+ * @returns The rotated image, square and wide enough for the image's diagonal
+ */
+shared_ptr<CGameImage> CGdiplusImageLoader::Rotate(const shared_ptr<CGameImage>& image, double angle)
+{
+    auto source = dynamic_cast<const CGdiplusImage*>(image.get());
+    if (source == nullptr)
+    {
+        return image;
+    }
+
+    int wid = image->GetWidth();
+    int hit = image->GetHeight();
+    int size = (int)ceil(sqrt(double(wid) * wid + double(hit) * hit));
+
+    auto bitmap = make_shared<Bitmap>(size, size, PixelFormat32bppPARGB);
+    Graphics graphics(bitmap.get());
+    graphics.SetInterpolationMode(InterpolationModeHighQualityBicubic);
+    graphics.SetPixelOffsetMode(PixelOffsetModeHalf);
+
+    graphics.TranslateTransform((REAL)size / 2, (REAL)size / 2);
+    graphics.RotateTransform((REAL)(angle * RtoD));
+    graphics.DrawImage(source->GetBitmap(), -wid / 2, -hit / 2, wid, hit);
+
+    return make_shared<CGdiplusImage>(bitmap, BuildHitMask(bitmap.get()));
+}
+
+/**
+ * Build the mask of visible pixels for a bitmap.
+ *
+ * Only 32 bit images with an alpha channel can have transparent
+ * pixels. Everything else is visible everywhere.
+ * @param bitmap The decoded bitmap
+ * @returns The new hit mask
+ */
+shared_ptr<CHitMask> CGdiplusImageLoader::BuildHitMask(Bitmap* bitmap)
+{
+    int wid = bitmap->GetWidth();
+    int hit = bitmap->GetHeight();
+
+    auto format = bitmap->GetPixelFormat();
+    bool hasAlpha = format == PixelFormat32bppARGB || format == PixelFormat32bppPARGB;
+
+    auto mask = make_shared<CHitMask>(wid, hit, hasAlpha);
+    if (!hasAlpha)
+    {
+        return mask;
+    }
+
+    Rect rect(0, 0, wid, hit);
+    BitmapData data;
+    if (bitmap->LockBits(&rect, ImageLockModeRead, PixelFormat32bppARGB, &data) != Ok)
+    {
+        return make_shared<CHitMask>(wid, hit, false);
+    }
+
+    for (int y = 0; y < hit; y++)
+    {
+        auto row = reinterpret_cast<const UINT32*>((const BYTE*)data.Scan0 + y * data.Stride);
+        for (int x = 0; x < wid; x++)
+        {
+            // Alpha is the high byte of each ARGB pixel
+            if ((row[x] >> 24) != 0)
+            {
+                mask->Set(x, y);
+            }
+        }
+    }
+
+    bitmap->UnlockBits(&data);
+    return mask;
+}
@@ -0,0 +1,56 @@
+/**
+ * \file GdiplusImage.h
+ *
+ * \author Morgan Mundell
+ *
+ *  Images decoded by GDI+ for drawing in the Windows application
+ */
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include "ImageCache.h"
+
+/**
+ * An image decoded by GDI+.
+ *
+ * Holds the decoded bitmap the GDI+ renderer draws.
+ */
+class CGdiplusImage : public CGameImage
+{
+public:
+    CGdiplusImage(std::shared_ptr<Gdiplus::Bitmap> bitmap, std::shared_ptr<CHitMask> hitMask);
+
+    /**
+     * The decoded bitmap
+     * @returns GDI+ bitmap
+     */
+    Gdiplus::Bitmap* GetBitmap() const { return mBitmap.get(); }
+
+    virtual size_t GetBytes() const override;
+
+private:
+    /// The decoded bitmap
+    std::shared_ptr<Gdiplus::Bitmap> mBitmap;
+};
+
+/**
+ * Loader that decodes images with GDI+.
+ *
+ * Installed in the image cache by the Windows application.
+ */
+class CGdiplusImageLoader : public CImageLoader
+{
+public:
+    virtual std::shared_ptr<CGameImage> Load(const std::wstring& filename) override;
+
+    virtual std::shared_ptr<CGameImage> Tint(const std::shared_ptr<CGameImage>& image,
+        float red, float green, float blue) override;
+
+    virtual std::shared_ptr<CGameImage> Rotate(const std::shared_ptr<CGameImage>& image,
+        double angle) override;
+
+private:
+    static std::shared_ptr<CHitMask> BuildHitMask(Gdiplus::Bitmap* bitmap);
+};
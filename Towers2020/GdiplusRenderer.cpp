@@ -0,0 +1,209 @@
+/**
+ * \file GdiplusRenderer.cpp
+ *
+ * \author Morgan Mundell
+ */
+
+#include "pch.h"
+#include "GdiplusRenderer.h"
+#include "GdiplusImage.h"
+#include "GdiplusTextCache.h"
+
+using namespace std;
+using namespace Gdiplus;
+
+/**
+ * Get the GDI+ bitmap for an image
+ * @param image The image
+ * @returns Bitmap or nullptr if the image was not decoded by GDI+
+ */
+static Bitmap* GetBitmap(const CGameImage* image)
+{
+    auto gdiplusImage = dynamic_cast<const CGdiplusImage*>(image);
+    return gdiplusImage != nullptr ? gdiplusImage->GetBitmap() : nullptr;
+}
+
+/**
+ * Convert a renderer color to a GDI+ color
+ * @param color The renderer color
+ * @returns GDI+ color
+ */
+static Gdiplus::Color ToGdiplus(CRenderer::Color color)
+{
+    return Gdiplus::Color((BYTE)color.mAlpha, (BYTE)color.mRed, (BYTE)color.mGreen, (BYTE)color.mBlue);
+}
+
+/**
+ * Constructor
+ * @param graphics The graphics context to draw on
+ * @param textCache Fonts, brushes and text to reuse, nullptr to make them on each call
+ */
+CGdiplusRenderer::CGdiplusRenderer(Graphics* graphics, CGdiplusTextCache* textCache) :
+    mGraphics(graphics), mTextCache(textCache)
+{
+}
+
+/**
+ * Create an offscreen layer
+ * @param width Layer width in device pixels
+ * @param height Layer height in device pixels
+ * @returns New layer
+ */
+unique_ptr<CRenderer::CLayer> CGdiplusRenderer::CreateLayer(int width, int height)
+{
+    return make_unique<CGdiplusLayer>(width, height);
+}
+
+/**
+ * Copy a layer onto this renderer at the device origin
+ * @param layer Layer made by CreateLayer
+ */
+void CGdiplusRenderer::DrawLayer(CLayer* layer)
+{
+    auto gdiplusLayer = dynamic_cast<CGdiplusLayer*>(layer);
+    if (gdiplusLayer != nullptr)
+    {
+        gdiplusLayer->Draw(mGraphics);
+    }
+}
+
+/**
+ * Set the transform from virtual pixels to the device
+ * @param x Horizontal offset in device pixels
+ * @param y Vertical offset in device pixels
+ * @param scale Device pixels per virtual pixel
+ */
+void CGdiplusRenderer::SetTransform(double x, double y, double scale)
+{
+    mGraphics->ResetTransform();
+    mGraphics->TranslateTransform((REAL)x, (REAL)y);
+    mGraphics->ScaleTransform((REAL)scale, (REAL)scale);
+}
+
+/**
+ * Draw an image
+ * @param image The image to draw
+ * @param x Left of the image
+ * @param y Top of the image
+ * @param width Width to draw the image
+ * @param height Height to draw the image
+ */
+void CGdiplusRenderer::DrawImage(const CGameImage* image, double x, double y, double width, double height)
+{
+    auto bitmap = GetBitmap(image);
+    if (bitmap != nullptr)
+    {
+        mGraphics->DrawImage(bitmap, (REAL)x, (REAL)y, (REAL)width, (REAL)height);
+    }
+}
+
+/**
+ * Fill a rectangle
+ * @param x Left of the rectangle
+ * @param y Top of the rectangle
+ * @param width Rectangle width
+ * @param height Rectangle height
+ * @param color Fill color
+ */
+void CGdiplusRenderer::FillRectangle(double x, double y, double width, double height, Color color)
+{
+    if (mTextCache != nullptr)
+    {
+        mGraphics->FillRectangle(mTextCache->GetBrush(color), (REAL)x, (REAL)y, (REAL)width, (REAL)height);
+        return;
+    }
+
+    SolidBrush brush(ToGdiplus(color));
+    mGraphics->FillRectangle(&brush, (REAL)x, (REAL)y, (REAL)width, (REAL)height);
+}
+
+/**
+ * Fill an ellipse
+ * @param x Left of the bounding rectangle
+ * @param y Top of the bounding rectangle
+ * @param width Width of the bounding rectangle
+ * @param height Height of the bounding rectangle
+ * @param color Fill color
+ */
+void CGdiplusRenderer::FillEllipse(double x, double y, double width, double height, Color color)
+{
+    if (mTextCache != nullptr)
+    {
+        mGraphics->FillEllipse(mTextCache->GetBrush(color), (REAL)x, (REAL)y, (REAL)width, (REAL)height);
+        return;
+    }
+
+    SolidBrush brush(ToGdiplus(color));
+    mGraphics->FillEllipse(&brush, (REAL)x, (REAL)y, (REAL)width, (REAL)height);
+}
+
+/**
+ * Outline an ellipse
+ * @param x Left of the bounding rectangle
+ * @param y Top of the bounding rectangle
+ * @param width Width of the bounding rectangle
+ * @param height Height of the bounding rectangle
+ * @param color Line color
+ * @param penWidth Width of the line
+ */
+void CGdiplusRenderer::DrawEllipse(double x, double y, double width, double height, Color color, double penWidth)
+{
+    Pen pen(ToGdiplus(color), (REAL)penWidth);
+    mGraphics->DrawEllipse(&pen, (REAL)x, (REAL)y, (REAL)width, (REAL)height);
+}
+
+/**
+ * Draw text in Arial
+ * @param text The text to draw
+ * @param x Left of the text
+ * @param y Top of the text
+ * @param size Font size in points
+ * @param color Text color
+ */
+void CGdiplusRenderer::DrawString(const wstring& text, double x, double y, double size, Color color)
+{
+    if (mTextCache != nullptr)
+    {
+        mTextCache->DrawString(mGraphics, text, x, y, size, color);
+        return;
+    }
+
+    FontFamily fontFamily(L"Arial");
+    Gdiplus::Font font(&fontFamily, (REAL)size);
+
+    SolidBrush brush(ToGdiplus(color));
+    mGraphics->DrawString(text.c_str(), -1, &font, PointF((REAL)x, (REAL)y), &brush);
+}
+
+/**
+ * Constructor
+ * @param width Layer width in device pixels
+ * @param height Layer height in device pixels
+ */
+CGdiplusLayer::CGdiplusLayer(int width, int height)
+{
+    mBitmap = make_unique<Bitmap>(max(width, 1), max(height, 1), PixelFormat32bppPARGB);
+    mGraphics = make_unique<Graphics>(mBitmap.get());
+    mRenderer = make_unique<CGdiplusRenderer>(mGraphics.get());
+}
+
+/**
+ * Copy the layer onto a graphics context at the device origin.
+ *
+ * Anything drawn into the layer after it is first shown is not seen.
+ * @param graphics Graphics context to draw on
+ */
+void CGdiplusLayer::Draw(Graphics* graphics)
+{
+    if (mCached == nullptr)
+    {
+        mGraphics->Flush(FlushIntentionSync);
+        mCached = make_unique<CachedBitmap>(mBitmap.get(), graphics);
+    }
+
+    // Cached bitmaps only allow translation, so draw in device pixels
+    auto save = graphics->Save();
+    graphics->ResetTransform();
+    graphics->DrawCachedBitmap(mCached.get(), 0, 0);
+    graphics->Restore(save);
+}
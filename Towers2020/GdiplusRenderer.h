@@ -0,0 +1,95 @@
+/**
+ * \file GdiplusRenderer.h
+ *
+ * \author Morgan Mundell
+ *
+ *  Renderer that draws the game with GDI+
+ */
+
+#pragma once
+
+#include "Renderer.h"
+
+class CGdiplusTextCache;
+
+/**
+ * Renderer that draws the game on a GDI+ graphics context.
+ *
+ * Images must have been decoded by CGdiplusImageLoader. Given a
+ * text cache, fonts, brushes and drawn text are reused from frame
+ * to frame instead of being made on every call.
+ */
+class CGdiplusRenderer : public CRenderer
+{
+public:
+    CGdiplusRenderer(Gdiplus::Graphics* graphics, CGdiplusTextCache* textCache = nullptr);
+
+    ///  Default constructor (disabled)
+    CGdiplusRenderer() = delete;
+
+    ///  Copy constructor (disabled)
+    CGdiplusRenderer(const CGdiplusRenderer&) = delete;
+
+    virtual std::unique_ptr<CLayer> CreateLayer(int width, int height) override;
+
+    virtual void DrawLayer(CLayer* layer) override;
+
+    virtual void SetTransform(double x, double y, double scale) override;
+
+    virtual void DrawImage(const CGameImage* image, double x, double y, double width, double height) override;
+
+    virtual void FillRectangle(double x, double y, double width, double height, Color color) override;
+
+    virtual void FillEllipse(double x, double y, double width, double height, Color color) override;
+
+    virtual void DrawEllipse(double x, double y, double width, double height, Color color, double penWidth) override;
+
+    virtual void DrawString(const std::wstring& text, double x, double y, double size, Color color) override;
+
+private:
+    /// The graphics context we draw on
+    Gdiplus::Graphics* mGraphics;
+
+    /// Fonts, brushes and text kept between frames, nullptr if none
+    CGdiplusTextCache* mTextCache;
+};
+
+/**
+ * Offscreen layer for the GDI+ renderer.
+ *
+ * Drawing goes into a bitmap. The first time the layer is shown
+ * the bitmap is converted to a cached bitmap in the format of the
+ * screen, which GDI+ copies far faster than it draws a bitmap.
+ */
+class CGdiplusLayer : public CRenderer::CLayer
+{
+public:
+    CGdiplusLayer(int width, int height);
+
+    ///  Default constructor (disabled)
+    CGdiplusLayer() = delete;
+
+    ///  Copy constructor (disabled)
+    CGdiplusLayer(const CGdiplusLayer&) = delete;
+
+    /**
+     * The renderer that draws into this layer
+     * @returns Renderer
+     */
+    virtual CRenderer* GetRenderer() override { return mRenderer.get(); }
+
+    void Draw(Gdiplus::Graphics* graphics);
+
+private:
+    /// The bitmap drawn into
+    std::unique_ptr<Gdiplus::Bitmap> mBitmap;
+
+    /// Graphics context on the bitmap
+    std::unique_ptr<Gdiplus::Graphics> mGraphics;
+
+    /// Renderer on the graphics context
+    std::unique_ptr<CGdiplusRenderer> mRenderer;
+
+    /// The bitmap converted for the screen, made when first drawn
+    std::unique_ptr<Gdiplus::CachedBitmap> mCached;
+};
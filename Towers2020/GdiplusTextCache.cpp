@@ -0,0 +1,167 @@
+/**
+ * \file GdiplusTextCache.cpp
+ *
+ * \author Morgan Mundell
+ */
+
+#include "pch.h"
+#include <cmath>
+#include "GdiplusTextCache.h"
+
+using namespace std;
+using namespace Gdiplus;
+
+/**
+ * Pack a renderer color into one ARGB value
+ * @param color The renderer color
+ * @returns Color as 0xAARRGGBB
+ */
+static unsigned int ToArgb(CRenderer::Color color)
+{
+    return (unsigned int)Gdiplus::Color::MakeARGB((BYTE)color.mAlpha, (BYTE)color.mRed,
+        (BYTE)color.mGreen, (BYTE)color.mBlue);
+}
+
+/**
+ * Get a solid brush
+ * @param color Color of the brush
+ * @returns Brush, owned by the cache
+ */
+SolidBrush* CGdiplusTextCache::GetBrush(CRenderer::Color color)
+{
+    auto& brush = mBrushes[ToArgb(color)];
+    if (brush == nullptr)
+    {
+        brush = make_unique<SolidBrush>(Gdiplus::Color(ToArgb(color)));
+    }
+
+    return brush.get();
+}
+
+/**
+ * Get an Arial font
+ * @param size Font size in points
+ * @returns Font, owned by the cache
+ */
+Gdiplus::Font* CGdiplusTextCache::GetFont(double size)
+{
+    if (mFontFamily == nullptr)
+    {
+        mFontFamily = make_unique<FontFamily>(L"Arial");
+    }
+
+    auto& font = mFonts[size];
+    if (font == nullptr)
+    {
+        font = make_unique<Gdiplus::Font>(mFontFamily.get(), (REAL)size);
+    }
+
+    return font.get();
+}
+
+/**
+ * Draw text in Arial, from its bitmap if it has been drawn before
+ * @param graphics Graphics to draw on, its transform may only translate and scale
+ * @param text The text to draw
+ * @param x Left of the text
+ * @param y Top of the text
+ * @param size Font size in points
+ * @param color Text color
+ */
+void CGdiplusTextCache::DrawString(Graphics* graphics, const wstring& text, double x, double y,
+    double size, CRenderer::Color color)
+{
+    Matrix transform;
+    graphics->GetTransform(&transform);
+
+    REAL elements[6];
+    transform.GetElements(elements);
+    double scale = elements[0];
+
+    TextKey key(text, size, ToArgb(color), scale);
+    auto found = mText.find(key);
+    if (found == mText.end())
+    {
+        Text drawn;
+        drawn.mBitmap = RenderText(graphics, text, size * scale, color);
+        found = mText.emplace(key, move(drawn)).first;
+    }
+
+    auto& drawn = found->second;
+    drawn.mLastFrame = mFrame;
+
+    // The bitmap is already at device size, so it is copied to
+    // whole device pixels to keep it from being resampled
+    PointF at((REAL)x, (REAL)y);
+    transform.TransformPoints(&at);
+
+    auto save = graphics->Save();
+    graphics->ResetTransform();
+    graphics->DrawImage(drawn.mBitmap.get(), (INT)lround(at.X), (INT)lround(at.Y),
+        (INT)drawn.mBitmap->GetWidth(), (INT)drawn.mBitmap->GetHeight());
+    graphics->Restore(save);
+}
+
+/**
+ * Lay out text and draw it into a new bitmap
+ * @param graphics Graphics the text will be shown on, for its resolution
+ * @param text The text to draw
+ * @param size Font size in points at device scale
+ * @param color Text color
+ * @returns Bitmap just large enough for the text
+ */
+unique_ptr<Bitmap> CGdiplusTextCache::RenderText(Graphics* graphics, const wstring& text,
+    double size, CRenderer::Color color)
+{
+    auto font = GetFont(size);
+
+    // Measure at the resolution of the graphics the text is shown on
+    Bitmap measureBitmap(1, 1, PixelFormat32bppPARGB);
+    measureBitmap.SetResolution(graphics->GetDpiX(), graphics->GetDpiY());
+    Graphics measure(&measureBitmap);
+
+    RectF bounds;
+    measure.MeasureString(text.c_str(), -1, font, PointF(0, 0), &bounds);
+
+    int width = max(1, (int)ceil(bounds.Width));
+    int height = max(1, (int)ceil(bounds.Height));
+    auto bitmap = make_unique<Bitmap>(width, height, PixelFormat32bppPARGB);
+    bitmap->SetResolution(graphics->GetDpiX(), graphics->GetDpiY());
+
+    Graphics draw(bitmap.get());
+    draw.SetTextRenderingHint(TextRenderingHintAntiAlias);
+    draw.DrawString(text.c_str(), -1, font, PointF(0, 0), GetBrush(color));
+
+    return bitmap;
+}
+
+/**
+ * End a frame, freeing the text that has not been drawn for a while
+ */
+void CGdiplusTextCache::EndFrame()
+{
+    mFrame++;
+
+    for (auto text = mText.begin(); text != mText.end(); )
+    {
+        if (mFrame - text->second.mLastFrame > MaxTextAge)
+        {
+            text = mText.erase(text);
+        }
+        else
+        {
+            ++text;
+        }
+    }
+}
+
+/**
+ * Free everything in the cache
+ */
+void CGdiplusTextCache::Clear()
+{
+    mText.clear();
+    mFonts.clear();
+    mBrushes.clear();
+    mFontFamily = nullptr;
+}
@@ -0,0 +1,88 @@
+/**
+ * \file GdiplusTextCache.h
+ *
+ * \author Morgan Mundell
+ *
+ *  Fonts, brushes and drawn text kept between frames
+ */
+
+#pragma once
+
+#include <map>
+#include <memory>
+#include <string>
+#include <tuple>
+#include "Renderer.h"
+
+/**
+ * GDI+ objects for drawing text and filling shapes, kept between frames.
+ *
+ * Fonts and brushes are made the first time each size or color is
+ * asked for. Text is laid out and drawn into a bitmap the first
+ * time a string is drawn at a given size, color and scale. After that
+ * drawing it is a copy of the bitmap, so frames where the text has not
+ * changed do no text layout at all. Text that has not been drawn
+ * for a while is freed.
+ *
+ * Owned by the window so it outlives the renderers made for each paint.
+ */
+class CGdiplusTextCache
+{
+public:
+    /// Frames a string can go undrawn before its bitmap is freed
+    static const int MaxTextAge = 60;
+
+    CGdiplusTextCache() {}
+
+    ///  Copy constructor (disabled)
+    CGdiplusTextCache(const CGdiplusTextCache&) = delete;
+
+    Gdiplus::SolidBrush* GetBrush(CRenderer::Color color);
+
+    Gdiplus::Font* GetFont(double size);
+
+    void DrawString(Gdiplus::Graphics* graphics, const std::wstring& text, double x, double y,
+        double size, CRenderer::Color color);
+
+    void EndFrame();
+
+    void Clear();
+
+    /**
+     * Number of strings with a bitmap in the cache
+     * @returns String count
+     */
+    size_t GetTextCount() const { return mText.size(); }
+
+private:
+    /// A string drawn into a bitmap
+    struct Text
+    {
+        /// The drawn text
+        std::unique_ptr<Gdiplus::Bitmap> mBitmap;
+
+        /// Frame the text was last drawn in
+        long long mLastFrame = 0;
+    };
+
+    /// What a drawn string depends on: text, font size, color and device pixels per unit
+    typedef std::tuple<std::wstring, double, unsigned int, double> TextKey;
+
+    std::unique_ptr<Gdiplus::Bitmap> RenderText(Gdiplus::Graphics* graphics, const std::wstring& text,
+        double size, CRenderer::Color color);
+
+    /// Arial, made when the first font is
+    std::unique_ptr<Gdiplus::FontFamily> mFontFamily;
+
+    /// Fonts by size in points
+    std::map<double, std::unique_ptr<Gdiplus::Font>> mFonts;
+
+    /// Brushes by ARGB color
+    std::map<unsigned int, std::unique_ptr<Gdiplus::SolidBrush>> mBrushes;
+
+    /// Drawn strings
+    std::map<TextKey, Text> mText;
+
+    /// Frames ended so far
+    long long mFrame = 0;
+};
@@ -34,7 +34,7 @@ public:
 	 * Method Disabled (no entities are drawn on ship entities)
 	 * @param graphics The graphics 
 	 */
-	virtual void RenderEntities(Gdiplus::Graphics* graphics) {};
+	virtual void RenderEntities(CRenderer* graphics) {};
 
 	virtual bool HitTest(double x, double y) override;
 };
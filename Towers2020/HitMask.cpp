@@ -0,0 +1,23 @@
+/**
+ * \file HitMask.cpp
+ *
+ * \author Morgan Mundell
+ */
+
+#include "pch.h"
+#include "HitMask.h"
+
+/**
+ * Constructor. All pixels start out transparent.
+ * @param width Image width in pixels
+ * @param height Image height in pixels
+ * @param hasAlpha True if the image has an alpha channel
+ */
+CHitMask::CHitMask(int width, int height, bool hasAlpha) :
+    mWidth(width), mHeight(height), mHasAlpha(hasAlpha), mStride((width + 63) / 64)
+{
+    if (mHasAlpha)
+    {
+        mBits.resize((size_t)mStride * height);
+    }
+}
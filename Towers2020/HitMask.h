@@ -0,0 +1,81 @@
+/**
+ * \file HitMask.h
+ *
+ * \author Morgan Mundell
+ *
+ *  One bit per pixel mask of where an image is visible
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+/**
+ * One bit per pixel mask of the visible pixels of an image.
+ *
+ * Built once when an image is decoded so hit testing never has
+ * to go back to the bitmap. Images without an alpha channel are
+ * visible everywhere and store no bits at all.
+ */
+class CHitMask
+{
+public:
+    CHitMask(int width, int height, bool hasAlpha);
+
+    ///  Default constructor (disabled)
+    CHitMask() = delete;
+
+    /**
+     * Mark a pixel as visible
+     * @param x X pixel in the image
+     * @param y Y pixel in the image
+     */
+    void Set(int x, int y) { mBits[y * mStride + (x >> 6)] |= uint64_t(1) << (x & 63); }
+
+    /**
+     * Test if a pixel of the image is visible.
+     * @param x X pixel in the image
+     * @param y Y pixel in the image
+     * @returns True if the pixel is drawn
+     */
+    bool Test(int x, int y) const
+    {
+        if (!mHasAlpha)
+        {
+            return true;
+        }
+
+        return (mBits[y * mStride + (x >> 6)] >> (x & 63)) & 1;
+    }
+
+    /**
+     * Test if a location is inside the image
+     * @param x X pixel in the image
+     * @param y Y pixel in the image
+     * @returns True if x, y is a pixel of the image
+     */
+    bool Contains(int x, int y) const { return x >= 0 && y >= 0 && x < mWidth && y < mHeight; }
+
+    /**
+     * Does the image have an alpha channel?
+     * @returns True if some pixels may be transparent
+     */
+    bool HasAlpha() const { return mHasAlpha; }
+
+private:
+    /// Image width in pixels
+    int mWidth;
+
+    /// Image height in pixels
+    int mHeight;
+
+    /// True if the image has an alpha channel
+    bool mHasAlpha;
+
+    /// Number of 64 bit words per row
+    int mStride;
+
+    /// The visible pixel bits, row by row
+    std::vector<uint64_t> mBits;
+};
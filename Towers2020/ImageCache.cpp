@@ -0,0 +1,216 @@
+/**
+ * \file ImageCache.cpp
+ *
+ * \author Morgan Mundell
+ */
+
+#include "pch.h"
+#include <cmath>
+#include "ImageCache.h"
+
+using namespace std;
+
+/// Radians in a full turn
+const double FullTurn = 6.28318530717958648;
+
+/**
+ * Get the process-wide image cache
+ * @returns The one and only image cache
+ */
+CImageCache& CImageCache::Instance()
+{
+    static CImageCache cache;
+    return cache;
+}
+
+/**
+ * Get the decoded image for a file, decoding it on first use.
+ * @param filename The path to the image file
+ * @returns Shared image or nullptr if the file could not be decoded
+ */
+shared_ptr<CGameImage> CImageCache::Get(const wstring& filename)
+{
+    return Find(filename);
+}
+
+/**
+ * Get a tinted copy of the image for a file, making it on first use.
+ *
+ * Callers should keep to a small set of tints, as every
+ * different one is kept for as long as the cache is.
+ * @param filename The path to the image file
+ * @param red Factor for the red channel, 0 to 1
+ * @param green Factor for the green channel, 0 to 1
+ * @param blue Factor for the blue channel, 0 to 1
+ * @returns Shared image or nullptr if the file could not be decoded
+ */
+shared_ptr<CGameImage> CImageCache::GetTinted(const wstring& filename, float red, float green, float blue)
+{
+    // Looked up without building a key string, as every
+    // balloon asks for its tinted image when it is made
+    auto base = mImages.find(filename);
+    auto image = base != mImages.end() ? base->second : Find(filename);
+    if (image == nullptr)
+    {
+        return nullptr;
+    }
+
+    auto key = make_tuple(image.get(), red, green, blue);
+
+    auto found = mTinted.find(key);
+    if (found != mTinted.end())
+    {
+        mHits++;
+        return found->second;
+    }
+
+    mMisses++;
+
+    auto tinted = mLoader != nullptr ? mLoader->Tint(image, red, green, blue) : image;
+    if (tinted == nullptr)
+    {
+        return nullptr;
+    }
+
+    if (tinted != image)
+    {
+        mBytes += tinted->GetBytes();
+    }
+
+    mTinted[key] = tinted;
+    return tinted;
+}
+
+/**
+ * Get a rotated copy of the image for a file, making it on first use.
+ *
+ * The angle is rounded to the nearest of the cache's rotation steps,
+ * so the number of copies per file is bounded.
+ * @param filename The path to the image file
+ * @param angle Clockwise rotation in radians
+ * @returns Shared image or nullptr if the file could not be decoded
+ */
+shared_ptr<CGameImage> CImageCache::GetRotated(const wstring& filename, double angle)
+{
+    // The copies are keyed by the decoded image, not by a string
+    // built from the filename and the angle
+    auto base = mImages.find(filename);
+    return GetRotated(base != mImages.end() ? base->second : Find(filename), angle);
+}
+
+/**
+ * Get a rotated copy of an image from the cache, making it on first use.
+ *
+ * For callers that already hold the image, so finding the
+ * copy needs no filename.
+ * @param image Image from the cache, nullptr gives nullptr
+ * @param angle Clockwise rotation in radians
+ * @returns Shared image or nullptr if it could not be made
+ */
+shared_ptr<CGameImage> CImageCache::GetRotated(const shared_ptr<CGameImage>& image, double angle)
+{
+    if (image == nullptr)
+    {
+        return nullptr;
+    }
+
+    int step = RotationStep(angle, mRotationSteps);
+    auto key = make_tuple(image.get(), step, mRotationSteps);
+
+    auto found = mRotated.find(key);
+    if (found != mRotated.end())
+    {
+        mHits++;
+        return found->second;
+    }
+
+    mMisses++;
+
+    double rounded = step * FullTurn / mRotationSteps;
+    auto rotated = mLoader != nullptr ? mLoader->Rotate(image, rounded) : image;
+    if (rotated == nullptr)
+    {
+        return nullptr;
+    }
+
+    if (rotated != image)
+    {
+        mBytes += rotated->GetBytes();
+    }
+
+    mRotated[key] = rotated;
+    return rotated;
+}
+
+/**
+ * Round an angle to the nearest of a number of steps per turn
+ * @param angle Angle in radians, any size or sign
+ * @param steps Steps per turn
+ * @returns Step from 0 to steps - 1
+ */
+int CImageCache::RotationStep(double angle, int steps)
+{
+    int step = (int)lround(angle * steps / FullTurn) % steps;
+    return step < 0 ? step + steps : step;
+}
+
+/**
+ * Get the mask of visible pixels for an image file.
+ * @param filename The path to the image file
+ * @returns Shared hit mask or nullptr if the file could not be decoded
+ */
+shared_ptr<CHitMask> CImageCache::GetHitMask(const wstring& filename)
+{
+    // Masks are fetched right after the image, so a lookup
+    // that finds the image is not counted as another hit
+    auto found = mImages.find(filename);
+    if (found != mImages.end())
+    {
+        return found->second->GetHitMask();
+    }
+
+    auto image = Find(filename);
+    return image != nullptr ? image->GetHitMask() : nullptr;
+}
+
+/**
+ * Find the image for a file, decoding it on first use.
+ * @param filename The path to the image file
+ * @returns The image or nullptr if the file could not be decoded
+ */
+shared_ptr<CGameImage> CImageCache::Find(const wstring& filename)
+{
+    auto found = mImages.find(filename);
+    if (found != mImages.end())
+    {
+        mHits++;
+        return found->second;
+    }
+
+    mMisses++;
+
+    auto image = mLoader != nullptr ? mLoader->Load(filename) : CGameImage::ReadHeader(filename);
+    if (image == nullptr)
+    {
+        // Failures are not cached so a later request can retry
+        return nullptr;
+    }
+
+    mBytes += image->GetBytes();
+    mImages[filename] = image;
+    return image;
+}
+
+/**
+ * Release the cache's references to all images.
+ *
+ * Must be called before the platform's graphics library is shut
+ * down so no decoded image outlives the library.
+ */
+void CImageCache::Clear()
+{
+    mImages.clear();
+    mTinted.clear();
+    mRotated.clear();
+    mBytes = 0;
+}
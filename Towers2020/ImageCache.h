@@ -0,0 +1,175 @@
+/**
+ * \file ImageCache.h
+ *
+ * \author Morgan Mundell
+ *
+ *  Process-wide cache of decoded images shared by all items
+ */
+
+#pragma once
+
+#include <map>
+#include <memory>
+#include <string>
+#include <tuple>
+#include "GameImage.h"
+
+/**
+ * Interface for decoding an image file.
+ *
+ * The platform that draws the game installs a loader that decodes
+ * the pixels it needs. Without one the cache only reads image headers.
+ */
+class CImageLoader
+{
+public:
+    virtual ~CImageLoader() {}
+
+    /**
+     * Decode an image file
+     * @param filename The path to the image file
+     * @returns The image or nullptr if the file could not be decoded
+     */
+    virtual std::shared_ptr<CGameImage> Load(const std::wstring& filename) = 0;
+
+    /**
+     * Make a copy of an image with each color channel scaled.
+     *
+     * Loaders that keep no pixels return the image itself.
+     * @param image The image to tint
+     * @param red Factor for the red channel, 0 to 1
+     * @param green Factor for the green channel, 0 to 1
+     * @param blue Factor for the blue channel, 0 to 1
+     * @returns The tinted image or nullptr if it could not be made
+     */
+    virtual std::shared_ptr<CGameImage> Tint(const std::shared_ptr<CGameImage>& image,
+        float red, float green, float blue) { return image; }
+
+    /**
+     * Make a copy of an image rotated about its center.
+     *
+     * The copy is made large enough to hold the image at any angle,
+     * with the image centered in it. Loaders that keep no pixels
+     * return the image itself.
+     * @param image The image to rotate
+     * @param angle Clockwise rotation in radians
+     * @returns The rotated image or nullptr if it could not be made
+     */
+    virtual std::shared_ptr<CGameImage> Rotate(const std::shared_ptr<CGameImage>& image,
+        double angle) { return image; }
+};
+
+/**
+ * Process-wide cache of decoded images.
+ *
+ * Every item that needs an image asks the cache for it by filename.
+ * The first request decodes the file, every later request for the
+ * same file shares the already decoded image. Images are reference
+ * counted through shared_ptr, so an image stays valid for as long as
+ * any item is still drawing it. A hit mask of the visible pixels is
+ * built alongside every image when it is decoded.
+ *
+ * Tinted and rotated copies of an image are cached the same way, so
+ * each color or angle is only made once however many items draw it.
+ * Angles are rounded to one of a fixed number of steps per turn.
+ */
+class CImageCache
+{
+public:
+    /// Angles per turn rotated images are rounded to unless set otherwise
+    static const int DefaultRotationSteps = 64;
+
+    static CImageCache& Instance();
+
+    ///  Copy constructor (disabled)
+    CImageCache(const CImageCache&) = delete;
+
+    ///  Assignment operator (disabled)
+    void operator=(const CImageCache&) = delete;
+
+    std::shared_ptr<CGameImage> Get(const std::wstring& filename);
+
+    std::shared_ptr<CGameImage> GetTinted(const std::wstring& filename, float red, float green, float blue);
+
+    std::shared_ptr<CGameImage> GetRotated(const std::wstring& filename, double angle);
+
+    std::shared_ptr<CGameImage> GetRotated(const std::shared_ptr<CGameImage>& image, double angle);
+
+    std::shared_ptr<CHitMask> GetHitMask(const std::wstring& filename);
+
+    static int RotationStep(double angle, int steps);
+
+    void Clear();
+
+    /**
+     * Set the loader used to decode images not yet in the cache
+     * @param loader The loader or nullptr to only read image headers
+     */
+    void SetLoader(std::shared_ptr<CImageLoader> loader) { mLoader = loader; }
+
+    /**
+     * Set how many angles per turn rotated images are rounded to
+     * @param steps Steps per turn, a multiple of 8 keeps the compass directions exact
+     */
+    void SetRotationSteps(int steps) { mRotationSteps = steps > 0 ? steps : 1; }
+
+    /**
+     * How many angles per turn rotated images are rounded to
+     * @returns Steps per turn
+     */
+    int GetRotationSteps() const { return mRotationSteps; }
+
+    /**
+     * Number of requests satisfied from the cache
+     * @returns Hit count
+     */
+    int GetHits() const { return mHits; }
+
+    /**
+     * Number of requests that had to decode a file
+     * @returns Miss count
+     */
+    int GetMisses() const { return mMisses; }
+
+    /**
+     * Approximate number of bytes held by decoded images
+     * @returns Decoded size in bytes
+     */
+    size_t GetBytes() const { return mBytes; }
+
+    /**
+     * Number of distinct images in the cache
+     * @returns Image count
+     */
+    size_t GetCount() const { return mImages.size() + mTinted.size() + mRotated.size(); }
+
+private:
+    /// Constructor (use Instance)
+    CImageCache() {}
+
+    std::shared_ptr<CGameImage> Find(const std::wstring& filename);
+
+    /// Decoded images keyed by filename
+    std::map<std::wstring, std::shared_ptr<CGameImage>> mImages;
+
+    /// Tinted images keyed by the image and the factor for each channel
+    std::map<std::tuple<const CGameImage*, float, float, float>, std::shared_ptr<CGameImage>> mTinted;
+
+    /// Rotated images keyed by the image, rotation step and steps per turn
+    std::map<std::tuple<const CGameImage*, int, int>, std::shared_ptr<CGameImage>> mRotated;
+
+    /// Loader for images not yet in the cache
+    std::shared_ptr<CImageLoader> mLoader;
+
+    /// Requests satisfied from the cache
+    int mHits = 0;
+
+    /// Requests that had to decode a file
+    int mMisses = 0;
+
+    /// Approximate decoded size of all cached images
+    size_t mBytes = 0;
+
+    /// Angles per turn rotated images are rounded to
+    int mRotationSteps = DefaultRotationSteps;
+};
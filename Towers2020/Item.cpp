@@ -9,21 +9,22 @@
  */
 
 #include "pch.h"
+#include <cmath>
 #include<memory>
 #include "Item.h"
 #include "TowersGame.h"
+#include "ImageCache.h"
 
 using namespace std;
-using namespace Gdiplus;
 
 /// The directory containing the file images
-const std::wstring CItem::ImagesDirectory = L"Images/";
+const std::wstring CItem::ImagesDirectory = L"images/";
 
 /** 
 * Draw this item
 * @param graphics The graphics context to draw on 
 */
-void CItem::Draw(Gdiplus::Graphics* graphics)
+void CItem::Draw(CRenderer* graphics)
 {
     if (mItemImage != nullptr)
     {
@@ -31,8 +32,8 @@ void CItem::Draw(Gdiplus::Graphics* graphics)
         int hit = mItemImage->GetHeight();
 
         graphics->DrawImage(mItemImage.get(),
-            float(GetX() - wid / 2), float(GetY() - hit / 2),
-            (float)mItemImage->GetWidth() + 1, (float)mItemImage->GetHeight() + 1);
+            GetX() - wid / 2, GetY() - hit / 2,
+            mItemImage->GetWidth() + 1, mItemImage->GetHeight() + 1);
     }
 }
 
@@ -59,9 +60,11 @@ bool CItem::HitTest(double x, double y)
 {
     double insideTolerance = 32; // tolerance
 
-    double wid = mItemImage->GetWidth(); //width
-    double het = mItemImage->GetHeight(); // height 
-    /// will add back later once images are added to code
+    if (mHitMask == nullptr)
+    {
+        // No image to click on
+        return false;
+    }
 
     // Test to see if x, y are in the image
     if (abs(x - mX) > insideTolerance || abs(y - mY) > insideTolerance)
@@ -69,24 +72,21 @@ bool CItem::HitTest(double x, double y)
         // We are outside the image
         return false;
     }
-    
+
     // Test to see if x, y are in the drawn part of the image
-    auto format = mItemImage->GetPixelFormat();
-    if (format == PixelFormat32bppARGB || format == PixelFormat32bppPARGB)
+    int transX = (int)(x - GetX() + GetWidth() / 2);
+    int transY = (int)(y - GetY() + GetHeight() / 2);
+
+    // Clicks inside the tolerance but off the edge of a
+    // smaller image count as hits
+    if (!mHitMask->Contains(transX, transY))
     {
-        double transX = x - GetX() + wid / 2;
-        double transY = y - GetY() + het / 2;
-        // This image has an alpha map, which implements the 
-        // transparency. If so, we should check to see if we
-        // clicked on a pixel where alpha is not zero, meaning
-        // the pixel shows on the screen.
-        Color color;
-        mItemImage->GetPixel((int)transX, (int)transY, &color);
-        return color.GetAlpha() != 0;
-    } 
-    else {
         return true;
     }
+
+    // The mask records which pixels have a non-zero alpha,
+    // meaning the pixel shows on the screen.
+    return mHitMask->Test(transX, transY);
 }
 
 /**
@@ -111,18 +111,20 @@ void CItem::SetImage(const std::wstring & file)
     if (!file.empty())
     {
         wstring filename = ImagesDirectory + file;
-        mItemImage = unique_ptr<Bitmap>(Bitmap::FromFile(filename.c_str()));
-        if (mItemImage->GetLastStatus() != Ok)
+        mItemImage = CImageCache::Instance().Get(filename);
+        mHitMask = CImageCache::Instance().GetHitMask(filename);
+        if (mItemImage == nullptr)
         {
             wstring msg(L"Failed to open ");
             msg += filename;
-            AfxMessageBox(msg.c_str());
+            GetGame()->ShowMessage(msg);
             return;
         }
     }
     else
     {
-        mItemImage.release();
+        mItemImage.reset();
+        mHitMask.reset();
     }
 
     mFile = file;
@@ -15,6 +15,8 @@
 #include <utility>
 #include "ItemVisitor.h"
 #include "XmlNode.h"
+#include "GameImage.h"
+#include "Renderer.h"
 
 class CTowersGame;
 
@@ -97,7 +99,7 @@ public:
      */
     std::wstring GetItemId() { return mItemId; }
 
-    void CItem::QuantizeLocation();
+    void QuantizeLocation();
 
     std::shared_ptr<CItem> GetAdjacent(int dx, int dy);
 
@@ -107,7 +109,14 @@ public:
      */
     virtual void Accept(CItemVisitor* visitor) = 0;
 
-    virtual void Draw(Gdiplus::Graphics* graphics);
+    virtual void Draw(CRenderer* graphics);
+
+    /**
+     * Does this item look the same for the whole level?
+     * Static items are drawn once into the game's tile layer.
+     * @returns True if the item never moves or changes
+     */
+    virtual bool IsStatic() const { return false; }
 
     /** 
      * Handle updates for animation
@@ -119,7 +128,7 @@ public:
      * Renders the entities generated by an attack of a tower
      * @param graphics The graphics object
      */
-    virtual void RenderEntities(Gdiplus::Graphics* graphics) = 0;
+    virtual void RenderEntities(CRenderer* graphics) = 0;
 
 protected:
 
@@ -132,8 +141,11 @@ private:
     /// The file for this item
     std::wstring mFile;
 
-    /// The image of this tile
-    std::unique_ptr<Gdiplus::Bitmap> mItemImage;
+    /// The image of this tile, shared through the image cache
+    std::shared_ptr<CGameImage> mItemImage;
+
+    /// Mask of the visible pixels of the image, used for hit testing
+    std::shared_ptr<CHitMask> mHitMask;
 
     /// The id of this tile according to the XML Declarations section.
     std::wstring mItemId;
@@ -0,0 +1,168 @@
+/**
+ * \file ItemRegistry.cpp
+ *
+ * \author Morgan Mundell
+ */
+
+#include "pch.h"
+#include <algorithm>
+#include "ItemRegistry.h"
+#include "ItemVisitor.h"
+#include "TileRoad.h"
+#include "Tower8.h"
+#include "TowerBomb.h"
+#include "TowerRings.h"
+#include "TowerAirship.h"
+#include "GoButton.h"
+
+using namespace std;
+
+/**
+ * Visitor that finds which of the registry's lists an item belongs in
+ */
+class CRegistryVisitor : public CItemVisitor
+{
+public:
+    /**
+     * Visit a road tile
+     * @param road The road
+     */
+    void VisitTileRoad(CTileRoad* road) override { mRoad = road; }
+
+    /**
+     * Visit a dart tower
+     * @param tower8 The tower
+     */
+    void VisitTower8(CTower8* tower8) override { SetTower(tower8, CItemRegistry::TowerKind::Eight); }
+
+    /**
+     * Visit a bomb tower
+     * @param bomb The tower
+     */
+    void VisitTowerBomb(CTowerBomb* bomb) override { SetTower(bomb, CItemRegistry::TowerKind::Bomb); }
+
+    /**
+     * Visit a ring tower
+     * @param ring The tower
+     */
+    void VisitTowerRings(CTowerRings* ring) override { SetTower(ring, CItemRegistry::TowerKind::Rings); }
+
+    /**
+     * Visit an airship tower
+     * @param airship The tower
+     */
+    void VisitTowerAirship(CTowerAirship* airship) override { SetTower(airship, CItemRegistry::TowerKind::Airship); }
+
+    /**
+     * Visit a go button
+     * @param button The button
+     */
+    void VisitDiagGoButton(CGoButton* button) override { mGoButton = button; }
+
+    CTileRoad* mRoad = nullptr;         ///< The item as a road, if it is one
+    CTower* mTower = nullptr;           ///< The item as a tower, if it is one
+    CItemRegistry::TowerKind mKind = CItemRegistry::TowerKind::Eight;  ///< Kind of tower
+    CGoButton* mGoButton = nullptr;     ///< The item as a go button, if it is one
+
+private:
+    /**
+     * Record a tower and its kind
+     * @param tower The tower
+     * @param kind Kind of tower
+     */
+    void SetTower(CTower* tower, CItemRegistry::TowerKind kind) { mTower = tower; mKind = kind; }
+};
+
+/**
+ * Remove an item from one of the lists, keeping the order of the rest
+ * @param list List the item is in
+ * @param item The item
+ */
+template<class T>
+static void RemoveFrom(vector<shared_ptr<T>>& list, const T* item)
+{
+    auto found = find_if(list.begin(), list.end(),
+        [item](const shared_ptr<T>& entry) { return entry.get() == item; });
+    if (found != list.end())
+    {
+        list.erase(found);
+    }
+}
+
+/**
+ * Add an item to the list for its type, if there is one
+ * @param item Item just added to the game
+ */
+void CItemRegistry::Add(const shared_ptr<CItem>& item)
+{
+    CRegistryVisitor visitor;
+    item->Accept(&visitor);
+
+    // Each list shares ownership with the item, but points at the type it is kept as
+    if (visitor.mRoad != nullptr)
+    {
+        mRoads.push_back(shared_ptr<CTileRoad>(item, visitor.mRoad));
+    }
+    else if (visitor.mTower != nullptr)
+    {
+        mTowers[(int)visitor.mKind].push_back(shared_ptr<CTower>(item, visitor.mTower));
+    }
+    else if (visitor.mGoButton != nullptr)
+    {
+        mGoButtons.push_back(shared_ptr<CGoButton>(item, visitor.mGoButton));
+    }
+}
+
+/**
+ * Remove an item from the list for its type
+ * @param item Item being deleted from the game
+ */
+void CItemRegistry::Remove(CItem* item)
+{
+    CRegistryVisitor visitor;
+    item->Accept(&visitor);
+
+    if (visitor.mRoad != nullptr)
+    {
+        RemoveFrom(mRoads, visitor.mRoad);
+    }
+    else if (visitor.mTower != nullptr)
+    {
+        RemoveFrom(mTowers[(int)visitor.mKind], visitor.mTower);
+    }
+    else if (visitor.mGoButton != nullptr)
+    {
+        RemoveFrom(mGoButtons, visitor.mGoButton);
+    }
+}
+
+/**
+ * Empty every list
+ */
+void CItemRegistry::Clear()
+{
+    mRoads.clear();
+    for (auto& towers : mTowers)
+    {
+        towers.clear();
+    }
+
+    mGoButtons.clear();
+}
+
+/**
+ * Find the road tile balloons start from
+ * @returns The first road marked as a start, nullptr if none
+ */
+shared_ptr<CTileRoad> CItemRegistry::GetStartRoad() const
+{
+    for (auto& road : mRoads)
+    {
+        if (road->IsStartTile())
+        {
+            return road;
+        }
+    }
+
+    return nullptr;
+}
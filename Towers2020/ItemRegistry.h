@@ -0,0 +1,83 @@
+/**
+ * \file ItemRegistry.h
+ *
+ * \author Morgan Mundell
+ *
+ *  Lists of the game's items by type
+ */
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+class CItem;
+class CTileRoad;
+class CTower;
+class CGoButton;
+
+/**
+ * Keeps the game's items of the types the game looks for in lists
+ * of their own, so finding them does not mean visiting every item.
+ *
+ * Each item is sorted into its list once as it is added, with a
+ * single visitor call. Items of other types are not kept.
+ */
+class CItemRegistry
+{
+public:
+    /// Kinds of tower, each with its own list
+    enum class TowerKind { Eight, Bomb, Rings, Airship };
+
+    /// Number of kinds of tower
+    static const int TowerKinds = 4;
+
+    CItemRegistry() {}
+
+    ///  Copy constructor (disabled)
+    CItemRegistry(const CItemRegistry&) = delete;
+
+    void Add(const std::shared_ptr<CItem>& item);
+
+    void Remove(CItem* item);
+
+    void Clear();
+
+    std::shared_ptr<CTileRoad> GetStartRoad() const;
+
+    /**
+     * All road tiles, in the order they were added
+     * @returns Vector of roads
+     */
+    const std::vector<std::shared_ptr<CTileRoad>>& GetRoads() const { return mRoads; }
+
+    /**
+     * All towers of one kind, including the ones in the palette
+     * @param kind Kind of tower
+     * @returns Vector of towers
+     */
+    const std::vector<std::shared_ptr<CTower>>& GetTowers(TowerKind kind) const { return mTowers[(int)kind]; }
+
+    /**
+     * Number of towers of one kind, including the ones in the palette
+     * @param kind Kind of tower
+     * @returns Tower count
+     */
+    int GetTowerCount(TowerKind kind) const { return (int)mTowers[(int)kind].size(); }
+
+    /**
+     * All go buttons, at most one while a level is waiting to start
+     * @returns Vector of go buttons
+     */
+    const std::vector<std::shared_ptr<CGoButton>>& GetGoButtons() const { return mGoButtons; }
+
+private:
+    /// Road tiles
+    std::vector<std::shared_ptr<CTileRoad>> mRoads;
+
+    /// Towers, one list for each kind
+    std::vector<std::shared_ptr<CTower>> mTowers[TowerKinds];
+
+    /// Go buttons
+    std::vector<std::shared_ptr<CGoButton>> mGoButtons;
+};
@@ -0,0 +1,300 @@
+/**
+ * \file LevelGenerator.cpp
+ *
+ * \author Morgan Mundell
+ */
+
+#include "pch.h"
+#include <algorithm>
+#include <sstream>
+#include "LevelGenerator.h"
+#include "FileUtils.h"
+
+using namespace std;
+
+/// Declarations every generated level uses, the same images as the shipped levels
+static const char* Declarations =
+    "    <declarations>\n"
+    "        <road id=\"i001\" image=\"roadEW.png\" type=\"EW\"/>\n"
+    "        <road id=\"i002\" image=\"roadNS.png\" type=\"NS\"/>\n"
+    "        <road id=\"i003\" image=\"roadSE.png\" type=\"SE\"/>\n"
+    "        <road id=\"i004\" image=\"roadSW.png\" type=\"SW\"/>\n"
+    "        <road id=\"i005\" image=\"roadNE.png\" type=\"NE\"/>\n"
+    "        <road id=\"i006\" image=\"roadNW.png\" type=\"NW\"/>\n"
+    "        <open id=\"i007\" image=\"grass1.png\"/>\n"
+    "        <open id=\"i008\" image=\"grass2.png\"/>\n"
+    "        <house id=\"i011\" image=\"house1.png\"/>\n"
+    "        <house id=\"i012\" image=\"house2.png\"/>\n"
+    "        <house id=\"i013\" image=\"house3.png\"/>\n"
+    "        <trees id=\"i018\" image=\"trees1.png\"/>\n"
+    "        <trees id=\"i019\" image=\"trees2.png\"/>\n"
+    "        <trees id=\"i020\" image=\"trees3.png\"/>\n"
+    "        <trees id=\"i021\" image=\"trees4.png\"/>\n"
+    "    </declarations>\n";
+
+/// Road piece types and the declaration each uses
+static const char* RoadIds[][2] = {
+    { "EW", "i001" }, { "NS", "i002" }, { "SE", "i003" },
+    { "SW", "i004" }, { "NE", "i005" }, { "NW", "i006" } };
+
+/// Names of the tower types in the level file
+static const char* TowerNames[CLevelGenerator::NumTowerTypes] = { "tower8", "bomb", "rings", "airship" };
+
+/// Percent of the grass that gets trees or a house instead
+const int ScenicPercent = 8;
+
+/**
+ * Constructor
+ */
+CLevelGenerator::CLevelGenerator()
+{
+    fill(mTowers, mTowers + NumTowerTypes, 0);
+}
+
+/**
+ * Set the size of the level
+ * @param width Width in tiles, 1 to MaxSize
+ * @param height Height in tiles, 1 to MaxSize
+ */
+void CLevelGenerator::SetSize(int width, int height)
+{
+    mWidth = max(1, min(width, (int)MaxSize));
+    mHeight = max(1, min(height, (int)MaxSize));
+}
+
+/**
+ * Name of a tower type in the level file
+ * @param type Tower type
+ * @returns Name
+ */
+const char* CLevelGenerator::GetTowerName(TowerType type)
+{
+    return TowerNames[type];
+}
+
+/**
+ * Generate a level
+ * @returns The level file's text
+ */
+string CLevelGenerator::Generate()
+{
+    mRandom.seed(mSeed);
+
+    vector<string> roads(mWidth * mHeight);
+    LayRoad(roads);
+
+    vector<Cell> cells(mWidth * mHeight, Grass);
+    int startRow = 0;
+    mRoadTiles = 0;
+    for (int i = 0; i < mWidth * mHeight; i++)
+    {
+        if (!roads[i].empty())
+        {
+            cells[i] = Road;
+            mRoadTiles++;
+        }
+    }
+
+    for (int y = 0; y < mHeight; y++)
+    {
+        if (cells[y * mWidth] == Road)
+        {
+            startRow = y;
+        }
+    }
+
+    vector<int> towers(mWidth * mHeight, -1);
+    PlaceTowers(cells, towers);
+
+    stringstream xml;
+    xml << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n";
+    xml << "<level width=\"" << mWidth << "\" height=\"" << mHeight
+        << "\" start-y=\"" << startRow << "\" start-x=\"0\" balloons=\"" << mBalloons
+        << "\" balloon-interval=\"" << mBalloonInterval << "\">\n";
+    xml << Declarations;
+    xml << "    <items>\n";
+
+    uniform_int_distribution<int> percent(0, 99);
+    uniform_int_distribution<int> pick(0, 3);
+    for (int y = 0; y < mHeight; y++)
+    {
+        for (int x = 0; x < mWidth; x++)
+        {
+            int i = y * mWidth + x;
+            if (cells[i] == Road)
+            {
+                const char* id = "i001";
+                for (auto& road : RoadIds)
+                {
+                    if (roads[i] == road[0])
+                    {
+                        id = road[1];
+                    }
+                }
+
+                // The road is travelled from its west side at the start
+                xml << "        <road id=\"" << id << "\" x=\"" << x << "\" y=\"" << y << "\""
+                    << (x == 0 ? " start=\"false\"" : "") << "/>\n";
+            }
+            else if (cells[i] == Grass && percent(mRandom) < ScenicPercent)
+            {
+                int scenery = pick(mRandom);
+                if (scenery == 0)
+                {
+                    xml << "        <house id=\"i01" << 1 + pick(mRandom) % 3 << "\" x=\"" << x << "\" y=\"" << y << "\"/>\n";
+                }
+                else
+                {
+                    xml << "        <trees id=\"i0" << 18 + pick(mRandom) << "\" x=\"" << x << "\" y=\"" << y << "\"/>\n";
+                }
+            }
+            else
+            {
+                xml << "        <open id=\"i00" << 7 + (x + y) % 2 << "\" x=\"" << x << "\" y=\"" << y << "\"/>\n";
+            }
+        }
+    }
+
+    // Towers come after the tiles so they are drawn above them
+    for (int i = 0; i < mWidth * mHeight; i++)
+    {
+        if (towers[i] >= 0)
+        {
+            xml << "        <tower type=\"" << TowerNames[towers[i]] << "\" x=\"" << i % mWidth
+                << "\" y=\"" << i / mWidth << "\"/>\n";
+        }
+    }
+
+    xml << "    </items>\n</level>\n";
+    return xml.str();
+}
+
+/**
+ * Generate a level and write it to a file
+ * @param filename File to write
+ * @returns False if the file could not be written
+ */
+bool CLevelGenerator::Write(const wstring& filename)
+{
+    return WriteFileContents(filename, Generate());
+}
+
+/**
+ * Lay the road from the west edge to the east edge.
+ *
+ * In each column the road either carries straight on east or
+ * turns north or south, runs a few tiles and turns east again.
+ * @param roads Receives the road piece type of each cell, empty for no road
+ */
+void CLevelGenerator::LayRoad(vector<string>& roads)
+{
+    int maxRun = max(1, mHeight / 4);
+    uniform_int_distribution<int> startRow(0, mHeight - 1);
+    uniform_int_distribution<int> run(1, maxRun);
+    uniform_int_distribution<int> choice(0, 2);
+
+    int row = startRow(mRandom);
+    for (int x = 0; x < mWidth; x++)
+    {
+        // 0 goes straight, 1 turns north, 2 turns south
+        int turn = choice(mRandom);
+        int target = row;
+        if (turn == 1)
+        {
+            target = max(0, row - run(mRandom));
+        }
+        else if (turn == 2)
+        {
+            target = min(mHeight - 1, row + run(mRandom));
+        }
+
+        if (target == row)
+        {
+            roads[row * mWidth + x] = "EW";
+        }
+        else if (target < row)
+        {
+            roads[row * mWidth + x] = "NW";
+            for (int y = target + 1; y < row; y++)
+            {
+                roads[y * mWidth + x] = "NS";
+            }
+            roads[target * mWidth + x] = "SE";
+        }
+        else
+        {
+            roads[row * mWidth + x] = "SW";
+            for (int y = row + 1; y < target; y++)
+            {
+                roads[y * mWidth + x] = "NS";
+            }
+            roads[target * mWidth + x] = "NE";
+        }
+
+        row = target;
+    }
+}
+
+/**
+ * Place the towers on grass next to the road, taking turns between the types
+ * @param cells Cell contents, tower cells are marked
+ * @param towers Receives the tower type on each cell, -1 for none
+ */
+void CLevelGenerator::PlaceTowers(vector<Cell>& cells, vector<int>& towers)
+{
+    vector<int> candidates;
+    for (int y = 0; y < mHeight; y++)
+    {
+        for (int x = 0; x < mWidth; x++)
+        {
+            if (cells[y * mWidth + x] != Grass)
+            {
+                continue;
+            }
+
+            bool nearRoad = false;
+            for (int dy = -1; dy <= 1 && !nearRoad; dy++)
+            {
+                for (int dx = -1; dx <= 1; dx++)
+                {
+                    int nx = x + dx, ny = y + dy;
+                    if (nx >= 0 && ny >= 0 && nx < mWidth && ny < mHeight && cells[ny * mWidth + nx] == Road)
+                    {
+                        nearRoad = true;
+                        break;
+                    }
+                }
+            }
+
+            if (nearRoad)
+            {
+                candidates.push_back(y * mWidth + x);
+            }
+        }
+    }
+
+    shuffle(candidates.begin(), candidates.end(), mRandom);
+
+    int remaining[NumTowerTypes];
+    copy(mTowers, mTowers + NumTowerTypes, remaining);
+
+    mPlacedTowers = 0;
+    size_t next = 0;
+    bool placed = true;
+    while (placed && next < candidates.size())
+    {
+        placed = false;
+        for (int type = 0; type < NumTowerTypes && next < candidates.size(); type++)
+        {
+            if (remaining[type] > 0)
+            {
+                int cell = candidates[next++];
+                cells[cell] = Tower;
+                towers[cell] = type;
+                remaining[type]--;
+                mPlacedTowers++;
+                placed = true;
+            }
+        }
+    }
+}
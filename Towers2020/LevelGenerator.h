@@ -0,0 +1,116 @@
+/**
+ * \file LevelGenerator.h
+ *
+ * \author Morgan Mundell
+ *
+ *  Writes large procedural levels for stress testing
+ */
+
+#pragma once
+
+#include <random>
+#include <string>
+#include <vector>
+
+/**
+ * Generates level files in the same format as the shipped levels.
+ *
+ * A level is a grid of grass with scattered trees and houses and
+ * a winding road from the west edge to the east edge. The road
+ * crosses each column once, running straight east or turning
+ * north or south for a while first, so it never touches itself.
+ * Towers of each type can be placed on the grass next to the road.
+ *
+ * The same settings and seed always give the same level.
+ */
+class CLevelGenerator
+{
+public:
+    /// Tower types a level can place, in the order of GetTowerName
+    enum TowerType { Tower8, Bomb, Rings, Airship, NumTowerTypes };
+
+    /// Largest width or height the generator will make
+    static const int MaxSize = 1024;
+
+    CLevelGenerator();
+
+    void SetSize(int width, int height);
+
+    /**
+     * Set the number of balloons the level sends
+     * @param balloons Balloon count
+     */
+    void SetBalloons(int balloons) { mBalloons = balloons; }
+
+    /**
+     * Set the time between balloons
+     * @param interval Simulated seconds between balloons
+     */
+    void SetBalloonInterval(double interval) { mBalloonInterval = interval; }
+
+    /**
+     * Set how many towers of one type the level places
+     * @param type Tower type
+     * @param count Number of towers
+     */
+    void SetTowers(TowerType type, int count) { mTowers[type] = count; }
+
+    /**
+     * Set the seed the layout is generated from
+     * @param seed Seed
+     */
+    void SetSeed(unsigned int seed) { mSeed = seed; }
+
+    std::string Generate();
+
+    bool Write(const std::wstring& filename);
+
+    /**
+     * Number of road tiles in the last level generated
+     * @returns Road length in tiles
+     */
+    int GetRoadTiles() const { return mRoadTiles; }
+
+    /**
+     * Number of towers placed in the last level generated
+     * @returns Tower count, less than asked for if the road had too little grass beside it
+     */
+    int GetPlacedTowers() const { return mPlacedTowers; }
+
+    static const char* GetTowerName(TowerType type);
+
+private:
+    /// What is on a grid cell while generating
+    enum Cell : char { Grass, Road, Tower };
+
+    void LayRoad(std::vector<std::string>& roads);
+
+    void PlaceTowers(std::vector<Cell>& cells, std::vector<int>& towers);
+
+    /// Width in tiles
+    int mWidth = 16;
+
+    /// Height in tiles
+    int mHeight = 16;
+
+    /// Balloons the level sends
+    int mBalloons = 30;
+
+    /// Simulated seconds between balloons
+    double mBalloonInterval = 0.5;
+
+    /// Towers of each type to place
+    int mTowers[NumTowerTypes];
+
+    /// Seed for the layout
+    unsigned int mSeed = 1;
+
+    /// Random numbers for the level being generated
+    std::mt19937 mRandom;
+
+    /// Road tiles in the last level
+    int mRoadTiles = 0;
+
+    /// Towers placed in the last level
+    int mPlacedTowers = 0;
+};
@@ -0,0 +1,303 @@
+/**
+ * \file Profiler.cpp
+ *
+ * \author Morgan Mundell
+ */
+
+#include "pch.h"
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+#include <iomanip>
+#include "Profiler.h"
+#include "Renderer.h"
+
+using namespace std;
+
+/// Names of the zones for the overlay
+static const wchar_t* ZoneNames[CProfiler::NumZones] = {
+    L"Frame", L"Update", L"Item update", L"Collision", L"Draw", L"Entities", L"Blit" };
+
+/// Frame time we are aiming for in milliseconds
+const double TargetFrameTime = 30;
+
+/// Width of the overlay in virtual pixels
+const double OverlayWidth = 480;
+
+/// Height of the frame time graph in virtual pixels
+const double GraphHeight = 90;
+
+/// Frame time at the top of the graph in milliseconds
+const double GraphMaxTime = 60;
+
+/// Number of buckets in the frame time histogram
+const int HistogramBuckets = 20;
+
+/// Width of a histogram bucket in milliseconds
+const double HistogramBucketWidth = 3;
+
+/// Height of the tallest histogram bar in virtual pixels
+const double HistogramHeight = 60;
+
+/// Nanoseconds in a millisecond
+const double NanosecondsPerMs = 1e6;
+
+/**
+ * Get the one profiler
+ * @returns The profiler
+ */
+CProfiler& CProfiler::Instance()
+{
+    static CProfiler profiler;
+    return profiler;
+}
+
+/**
+ * Constructor
+ */
+CProfiler::CProfiler() : mEnabled(false), mFrames(0)
+{
+    for (auto& time : mCurrent)
+    {
+        time.store(0);
+    }
+
+    for (auto& frame : mHistory)
+    {
+        for (auto& time : frame)
+        {
+            time.store(0);
+        }
+    }
+}
+
+/**
+ * Turn profiling on or off.
+ *
+ * Turning it on starts a new history so old frames don't mix
+ * with ones timed much later.
+ * @param enabled True to time the subsystems
+ */
+void CProfiler::SetEnabled(bool enabled)
+{
+    if (enabled && !IsEnabled())
+    {
+        for (auto& time : mCurrent)
+        {
+            time.store(0, memory_order_relaxed);
+        }
+        mFrames.store(0, memory_order_release);
+    }
+
+    mEnabled.store(enabled, memory_order_relaxed);
+}
+
+/**
+ * Finish the current frame, moving its times into the history
+ */
+void CProfiler::EndFrame()
+{
+    if (!IsEnabled())
+    {
+        return;
+    }
+
+    long long frame = mFrames.load(memory_order_relaxed);
+    auto& slot = mHistory[frame % HistoryFrames];
+    for (int zone = 0; zone < NumZones; zone++)
+    {
+        slot[zone].store(mCurrent[zone].exchange(0, memory_order_relaxed), memory_order_relaxed);
+    }
+
+    mFrames.store(frame + 1, memory_order_release);
+}
+
+/**
+ * Number of frames in the history
+ * @returns Frames that can be asked about, at most HistoryFrames
+ */
+int CProfiler::GetFrameCount() const
+{
+    return (int)min(mFrames.load(memory_order_acquire), (long long)HistoryFrames);
+}
+
+/**
+ * Time spent in a zone during an earlier frame
+ * @param zone Zone to ask about
+ * @param framesAgo 0 for the most recent frame, 1 for the one before...
+ * @returns Time in milliseconds, 0 if the frame is not in the history
+ */
+double CProfiler::GetTime(Zone zone, int framesAgo) const
+{
+    long long frames = mFrames.load(memory_order_acquire);
+    if (framesAgo < 0 || framesAgo >= HistoryFrames || framesAgo >= frames)
+    {
+        return 0;
+    }
+
+    long long frame = frames - 1 - framesAgo;
+    return mHistory[frame % HistoryFrames][zone].load(memory_order_relaxed) / NanosecondsPerMs;
+}
+
+/**
+ * Average time spent in a zone per frame over the history
+ * @param zone Zone to ask about
+ * @returns Mean time in milliseconds
+ */
+double CProfiler::GetMean(Zone zone) const
+{
+    int count = GetFrameCount();
+    if (count == 0)
+    {
+        return 0;
+    }
+
+    double total = 0;
+    for (int i = 0; i < count; i++)
+    {
+        total += GetTime(zone, i);
+    }
+
+    return total / count;
+}
+
+/**
+ * Time in a zone that a given fraction of the frames in the history stay under
+ * @param zone Zone to ask about
+ * @param percentile Percentile from 0 to 100
+ * @returns Time in milliseconds
+ */
+double CProfiler::GetPercentile(Zone zone, double percentile) const
+{
+    int count = GetFrameCount();
+    if (count == 0)
+    {
+        return 0;
+    }
+
+    vector<double> times;
+    for (int i = 0; i < count; i++)
+    {
+        times.push_back(GetTime(zone, i));
+    }
+
+    // Nearest rank
+    int rank = (int)ceil(percentile / 100 * count);
+    rank = max(1, min(rank, count));
+
+    nth_element(times.begin(), times.begin() + (rank - 1), times.end());
+    return times[rank - 1];
+}
+
+/**
+ * Count how many frames in the history fall in each time range
+ * @param zone Zone to ask about
+ * @param bucketWidth Width of each range in milliseconds
+ * @param buckets Receives the counts, the last bucket also counts anything longer
+ * @param numBuckets Number of buckets
+ */
+void CProfiler::GetHistogram(Zone zone, double bucketWidth, int* buckets, int numBuckets) const
+{
+    fill(buckets, buckets + numBuckets, 0);
+
+    int count = GetFrameCount();
+    for (int i = 0; i < count; i++)
+    {
+        int bucket = (int)(GetTime(zone, i) / bucketWidth);
+        buckets[min(bucket, numBuckets - 1)]++;
+    }
+}
+
+/**
+ * Name of a zone to show the player
+ * @param zone Zone
+ * @returns Name
+ */
+const wchar_t* CProfiler::GetName(Zone zone)
+{
+    return ZoneNames[zone];
+}
+
+/**
+ * Draw the timing overlay.
+ *
+ * Shows a graph of recent frame times with the frames over our
+ * target in red, the frame time percentiles, a histogram of frame
+ * times and the mean time of each subsystem, slowest first.
+ * @param graphics Renderer to draw with
+ * @param x Left of the overlay in virtual pixels
+ * @param y Top of the overlay in virtual pixels
+ */
+void CProfiler::DrawOverlay(CRenderer* graphics, double x, double y) const
+{
+    CRenderer::Color background(0, 0, 0, 180);
+    CRenderer::Color white(255, 255, 255);
+    CRenderer::Color green(80, 220, 80);
+    CRenderer::Color red(240, 60, 60);
+    CRenderer::Color gray(160, 160, 160);
+
+    const double lineHeight = 20;
+    double height = GraphHeight + HistogramHeight + lineHeight * (NumZones + 3) + 30;
+    graphics->FillRectangle(x, y, OverlayWidth, height, background);
+
+    // Frame time graph, newest frame on the right
+    double barWidth = OverlayWidth / HistoryFrames;
+    double graphBottom = y + GraphHeight;
+    int count = GetFrameCount();
+    for (int i = 0; i < count; i++)
+    {
+        double time = GetTime(Frame, i);
+        double barHeight = min(time, GraphMaxTime) / GraphMaxTime * GraphHeight;
+        graphics->FillRectangle(x + OverlayWidth - (i + 1) * barWidth, graphBottom - barHeight,
+            barWidth, barHeight, time > TargetFrameTime ? red : green);
+    }
+
+    double targetY = graphBottom - TargetFrameTime / GraphMaxTime * GraphHeight;
+    graphics->FillRectangle(x, targetY, OverlayWidth, 1, gray);
+
+    double lineY = graphBottom + 5;
+
+    wstringstream percentiles;
+    percentiles << fixed << setprecision(1) << L"Frame ms  p50 " << GetPercentile(Frame, 50)
+        << L"  p95 " << GetPercentile(Frame, 95) << L"  p99 " << GetPercentile(Frame, 99);
+    graphics->DrawString(percentiles.str(), x + 5, lineY, 10, white);
+    lineY += lineHeight;
+
+    // Histogram of frame times
+    int buckets[HistogramBuckets];
+    GetHistogram(Frame, HistogramBucketWidth, buckets, HistogramBuckets);
+    int most = *max_element(buckets, buckets + HistogramBuckets);
+    double bucketWidth = OverlayWidth / HistogramBuckets;
+    double histogramBottom = lineY + HistogramHeight;
+    for (int b = 0; b < HistogramBuckets && most > 0; b++)
+    {
+        double barHeight = double(buckets[b]) / most * HistogramHeight;
+        bool over = (b + 1) * HistogramBucketWidth > TargetFrameTime;
+        graphics->FillRectangle(x + b * bucketWidth + 1, histogramBottom - barHeight,
+            bucketWidth - 2, barHeight, over ? red : green);
+    }
+    lineY = histogramBottom + 5;
+
+    // Subsystems, slowest first
+    vector<Zone> zones;
+    for (int zone = 0; zone < NumZones; zone++)
+    {
+        zones.push_back(Zone(zone));
+    }
+
+    vector<double> means(NumZones);
+    for (auto zone : zones)
+    {
+        means[zone] = GetMean(zone);
+    }
+
+    sort(zones.begin(), zones.end(), [&means](Zone a, Zone b) { return means[a] > means[b]; });
+
+    for (auto zone : zones)
+    {
+        wstringstream line;
+        line << fixed << setprecision(2) << GetName(zone) << L"  " << means[zone] << L" ms";
+        graphics->DrawString(line.str(), x + 5, lineY, 10, white);
+        lineY += lineHeight;
+    }
+}
@@ -0,0 +1,175 @@
+/**
+ * \file Profiler.h
+ *
+ * \author Morgan Mundell
+ *
+ *  Per frame timing of the game's subsystems
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+
+class CRenderer;
+
+/**
+ * Collects how long each subsystem takes every frame.
+ *
+ * Code to be measured is wrapped in a CProfileScope. The time spent
+ * in each zone is summed over a frame and, when the frame ends, the
+ * sums are written to a ring buffer holding the last HistoryFrames
+ * frames. Times are nested, so a zone includes the zones inside it.
+ *
+ * Adding time and ending a frame only use atomic operations, and a
+ * frame's slot is published with a release store of the frame count,
+ * so the history can be read without locks while the game runs.
+ */
+class CProfiler
+{
+public:
+    /// The subsystems we time
+    enum Zone
+    {
+        /// A whole frame from the start of painting to the end of the blit
+        Frame,
+        /// CTowersGame::Update
+        Update,
+        /// The Update calls of the items
+        ItemUpdate,
+        /// Tower collision checks against the balloons
+        Collision,
+        /// CTowersGame::OnDraw
+        Draw,
+        /// Drawing the entities above the items
+        RenderEntities,
+        /// Copying the back buffer to the screen
+        Blit,
+        /// Number of zones
+        NumZones
+    };
+
+    /// Number of frames kept
+    static const int HistoryFrames = 240;
+
+    static CProfiler& Instance();
+
+    /**
+     * Is profiling turned on?
+     * @returns True if timing and showing the overlay
+     */
+    bool IsEnabled() const { return mEnabled.load(std::memory_order_relaxed); }
+
+    void SetEnabled(bool enabled);
+
+    /**
+     * Add time spent in a zone to the current frame
+     * @param zone Zone the time was spent in
+     * @param nanoseconds Time spent
+     */
+    void Add(Zone zone, long long nanoseconds)
+    {
+        mCurrent[zone].fetch_add(nanoseconds, std::memory_order_relaxed);
+    }
+
+    void EndFrame();
+
+    int GetFrameCount() const;
+
+    double GetTime(Zone zone, int framesAgo) const;
+
+    double GetMean(Zone zone) const;
+
+    double GetPercentile(Zone zone, double percentile) const;
+
+    void GetHistogram(Zone zone, double bucketWidth, int* buckets, int numBuckets) const;
+
+    static const wchar_t* GetName(Zone zone);
+
+    void DrawOverlay(CRenderer* graphics, double x, double y) const;
+
+private:
+    /// Constructor, use Instance
+    CProfiler();
+
+    /// Copy constructor (disabled)
+    CProfiler(const CProfiler&) = delete;
+
+    /// Is profiling turned on
+    std::atomic<bool> mEnabled;
+
+    /// Time in each zone so far this frame, in nanoseconds
+    std::atomic<long long> mCurrent[NumZones];
+
+    /// Time in each zone for the last HistoryFrames frames, in nanoseconds
+    std::atomic<long long> mHistory[HistoryFrames][NumZones];
+
+    /// Number of frames ended since profiling was turned on
+    std::atomic<long long> mFrames;
+};
+
+/**
+ * Times the block of code it is declared in.
+ *
+ * Costs one check of a flag when profiling is turned off.
+ */
+class CProfileScope
+{
+public:
+    /**
+     * Constructor, starts timing
+     * @param zone Zone the time is spent in
+     * @param enabled False to not time this pass through the block
+     */
+    CProfileScope(CProfiler::Zone zone, bool enabled = true) :
+        mZone(zone), mRunning(enabled && CProfiler::Instance().IsEnabled())
+    {
+        if (mRunning)
+        {
+            mStart = std::chrono::steady_clock::now();
+        }
+    }
+
+    /// Destructor, adds the time to the zone
+    ~CProfileScope()
+    {
+        if (mRunning)
+        {
+            auto time = std::chrono::steady_clock::now() - mStart;
+            CProfiler::Instance().Add(mZone,
+                std::chrono::duration_cast<std::chrono::nanoseconds>(time).count());
+        }
+    }
+
+    /// Copy constructor (disabled)
+    CProfileScope(const CProfileScope&) = delete;
+
+private:
+    /// Zone being timed
+    CProfiler::Zone mZone;
+
+    /// True if profiling was on when timing started
+    bool mRunning;
+
+    /// When timing started
+    std::chrono::steady_clock::time_point mStart;
+};
+
+/**
+ * Ends a profiler frame when it goes out of scope.
+ *
+ * Declare it before anything else timed in the frame so the
+ * frame ends after every other scope has added its time.
+ */
+class CProfileFrame
+{
+public:
+    /// Constructor
+    CProfileFrame() {}
+
+    /// Destructor, ends the frame
+    ~CProfileFrame() { CProfiler::Instance().EndFrame(); }
+
+    /// Copy constructor (disabled)
+    CProfileFrame(const CProfileFrame&) = delete;
+};
@@ -0,0 +1,150 @@
+/**
+ * \file Renderer.h
+ *
+ * \author Morgan Mundell
+ *
+ *  Interface the game draws itself through
+ */
+
+#pragma once
+
+#include <memory>
+#include <string>
+
+class CGameImage;
+
+/**
+ * Interface the game draws itself through.
+ *
+ * The simulation never talks to a graphics library directly. The
+ * platform that shows the game implements this interface and hands
+ * it to CTowersGame::OnDraw. A headless run simply never draws.
+ *
+ * A renderer may also offer offscreen layers, so drawing that does
+ * not change from frame to frame is done once and then copied.
+ */
+class CRenderer
+{
+public:
+    /// A color to draw with
+    struct Color
+    {
+        /**
+         * Constructor
+         * @param red Red component 0-255
+         * @param green Green component 0-255
+         * @param blue Blue component 0-255
+         * @param alpha Opacity 0-255
+         */
+        Color(int red, int green, int blue, int alpha = 255) :
+            mRed(red), mGreen(green), mBlue(blue), mAlpha(alpha) {}
+
+        int mRed;       ///< Red component
+        int mGreen;     ///< Green component
+        int mBlue;      ///< Blue component
+        int mAlpha;     ///< Opacity
+    };
+
+    /**
+     * An offscreen surface the size of the window, drawn once and shown many times
+     */
+    class CLayer
+    {
+    public:
+        virtual ~CLayer() {}
+
+        /**
+         * The renderer that draws into this layer
+         * @returns Renderer, owned by the layer
+         */
+        virtual CRenderer* GetRenderer() = 0;
+    };
+
+    virtual ~CRenderer() {}
+
+    /**
+     * Create an offscreen layer.
+     *
+     * Renderers without layers return nullptr and the caller
+     * draws everything directly each frame.
+     * @param width Layer width in device pixels
+     * @param height Layer height in device pixels
+     * @returns New layer or nullptr if not supported
+     */
+    virtual std::unique_ptr<CLayer> CreateLayer(int width, int height) { return nullptr; }
+
+    /**
+     * Copy a layer made by CreateLayer onto this renderer at the device
+     * origin, ignoring the transform
+     * @param layer The layer to draw
+     */
+    virtual void DrawLayer(CLayer* layer) {}
+
+    /**
+     * Does this renderer put pixels on a surface?
+     *
+     * Renderers that only look at what is drawn return false, so
+     * drawing through them is not timed as part of the frame.
+     * @returns True if drawing is shown
+     */
+    virtual bool IsDrawing() const { return true; }
+
+    /**
+     * Set the transform from virtual pixels to the device, replacing any previous one
+     * @param x Horizontal offset in device pixels
+     * @param y Vertical offset in device pixels
+     * @param scale Device pixels per virtual pixel
+     */
+    virtual void SetTransform(double x, double y, double scale) = 0;
+
+    /**
+     * Draw an image
+     * @param image The image to draw
+     * @param x Left of the image
+     * @param y Top of the image
+     * @param width Width to draw the image
+     * @param height Height to draw the image
+     */
+    virtual void DrawImage(const CGameImage* image, double x, double y, double width, double height) = 0;
+
+    /**
+     * Fill a rectangle
+     * @param x Left of the rectangle
+     * @param y Top of the rectangle
+     * @param width Rectangle width
+     * @param height Rectangle height
+     * @param color Fill color
+     */
+    virtual void FillRectangle(double x, double y, double width, double height, Color color) = 0;
+
+    /**
+     * Fill an ellipse
+     * @param x Left of the bounding rectangle
+     * @param y Top of the bounding rectangle
+     * @param width Width of the bounding rectangle
+     * @param height Height of the bounding rectangle
+     * @param color Fill color
+     */
+    virtual void FillEllipse(double x, double y, double width, double height, Color color) = 0;
+
+    /**
+     * Outline an ellipse
+     * @param x Left of the bounding rectangle
+     * @param y Top of the bounding rectangle
+     * @param width Width of the bounding rectangle
+     * @param height Height of the bounding rectangle
+     * @param color Line color
+     * @param penWidth Width of the line
+     */
+    virtual void DrawEllipse(double x, double y, double width, double height, Color color, double penWidth) = 0;
+
+    /**
+     * Draw text in Arial
+     * @param text The text to draw
+     * @param x Left of the text
+     * @param y Top of the text
+     * @param size Font size in points
+     * @param color Text color
+     */
+    virtual void DrawString(const std::wstring& text, double x, double y, double size, Color color) = 0;
+};
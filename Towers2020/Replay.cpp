@@ -0,0 +1,267 @@
+/**
+ * \file Replay.cpp
+ *
+ * \author Morgan Mundell
+ */
+
+#include "pch.h"
+#include <cstdint>
+#include <cstring>
+#include "Replay.h"
+#include "FileUtils.h"
+
+using namespace std;
+
+/// First bytes of a replay file
+const char ReplayMagic[4] = { 'T', 'W', 'R', 'P' };
+
+/// Version of the replay file format
+const unsigned ReplayVersion = 1;
+
+/**
+ * Append an unsigned number using as few bytes as it needs
+ * @param data Bytes to append to
+ * @param value Number to append
+ */
+static void WriteNumber(string& data, uint64_t value)
+{
+    while (value >= 0x80)
+    {
+        data += char((value & 0x7f) | 0x80);
+        value >>= 7;
+    }
+    data += char(value);
+}
+
+/**
+ * Append a double as its 8 bytes, least significant first
+ * @param data Bytes to append to
+ * @param value Number to append
+ */
+static void WriteDouble(string& data, double value)
+{
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    for (int i = 0; i < 8; i++)
+    {
+        data += char(bits >> (i * 8));
+    }
+}
+
+/**
+ * Read a number written by WriteNumber
+ * @param data Bytes to read from
+ * @param pos Position to read at, advanced past the number
+ * @param value Receives the number
+ * @returns False if the data ends first
+ */
+static bool ReadNumber(const string& data, size_t& pos, uint64_t& value)
+{
+    value = 0;
+    for (int shift = 0; shift < 64; shift += 7)
+    {
+        if (pos >= data.size())
+        {
+            return false;
+        }
+
+        unsigned char byte = data[pos++];
+        value |= uint64_t(byte & 0x7f) << shift;
+        if ((byte & 0x80) == 0)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * Read a double written by WriteDouble
+ * @param data Bytes to read from
+ * @param pos Position to read at, advanced past the number
+ * @param value Receives the number
+ * @returns False if the data ends first
+ */
+static bool ReadDouble(const string& data, size_t& pos, double& value)
+{
+    if (pos + 8 > data.size())
+    {
+        return false;
+    }
+
+    uint64_t bits = 0;
+    for (int i = 0; i < 8; i++)
+    {
+        bits |= uint64_t((unsigned char)data[pos++]) << (i * 8);
+    }
+    memcpy(&value, &bits, sizeof(value));
+    return true;
+}
+
+/**
+ * Remove all recorded input
+ */
+void CReplay::Clear()
+{
+    mEvents.clear();
+    mEndTick = 0;
+}
+
+/**
+ * Record an input
+ * @param tick Simulation tick the input happened before
+ * @param type Kind of input
+ * @param x X location or answer
+ * @param y Y location
+ * @param text Filename for a load
+ */
+void CReplay::Add(long long tick, Type type, double x, double y, const wstring& text)
+{
+    Event event;
+    event.mTick = tick;
+    event.mType = type;
+    event.mX = x;
+    event.mY = y;
+    event.mText = text;
+    mEvents.push_back(event);
+
+    if (tick > mEndTick)
+    {
+        mEndTick = tick;
+    }
+}
+
+/**
+ * Write the replay to a file
+ * @param filename File to write
+ * @returns False if the file could not be written
+ */
+bool CReplay::Save(const wstring& filename) const
+{
+    string data(ReplayMagic, sizeof(ReplayMagic));
+    WriteNumber(data, ReplayVersion);
+    WriteNumber(data, mSeed);
+    WriteDouble(data, mStep);
+    WriteNumber(data, mEndTick);
+    WriteNumber(data, mEvents.size());
+
+    long long tick = 0;
+    for (auto& event : mEvents)
+    {
+        WriteNumber(data, event.mTick - tick);
+        tick = event.mTick;
+
+        data += char(event.mType);
+        switch (event.mType)
+        {
+        case Type::Load:
+        {
+            string text = WideToUtf8(event.mText);
+            WriteNumber(data, text.size());
+            data += text;
+            break;
+        }
+
+        case Type::Answer:
+            data += char(event.mX != 0 ? 1 : 0);
+            break;
+
+        default:
+            WriteDouble(data, event.mX);
+            WriteDouble(data, event.mY);
+            break;
+        }
+    }
+
+    return WriteFileContents(filename, data);
+}
+
+/**
+ * Read a replay from a file
+ * @param filename File to read
+ * @returns False if the file could not be read or is not a replay
+ */
+bool CReplay::Load(const wstring& filename)
+{
+    string data;
+    if (!ReadFileContents(filename, data) ||
+        data.size() < sizeof(ReplayMagic) ||
+        memcmp(data.data(), ReplayMagic, sizeof(ReplayMagic)) != 0)
+    {
+        return false;
+    }
+
+    size_t pos = sizeof(ReplayMagic);
+    uint64_t version, seed, endTick, count;
+    double step;
+    if (!ReadNumber(data, pos, version) || version != ReplayVersion ||
+        !ReadNumber(data, pos, seed) ||
+        !ReadDouble(data, pos, step) ||
+        !ReadNumber(data, pos, endTick) ||
+        !ReadNumber(data, pos, count))
+    {
+        return false;
+    }
+
+    vector<Event> events;
+    long long tick = 0;
+    for (uint64_t i = 0; i < count; i++)
+    {
+        uint64_t delta;
+        if (!ReadNumber(data, pos, delta) || pos >= data.size())
+        {
+            return false;
+        }
+
+        Event event;
+        tick += (long long)delta;
+        event.mTick = tick;
+        event.mType = Type(data[pos++]);
+        event.mX = 0;
+        event.mY = 0;
+
+        switch (event.mType)
+        {
+        case Type::Load:
+        {
+            uint64_t length;
+            if (!ReadNumber(data, pos, length) || pos + length > data.size())
+            {
+                return false;
+            }
+            event.mText = Utf8ToWide(data.substr(pos, (size_t)length));
+            pos += (size_t)length;
+            break;
+        }
+
+        case Type::Answer:
+            if (pos >= data.size())
+            {
+                return false;
+            }
+            event.mX = data[pos++] != 0 ? 1 : 0;
+            break;
+
+        case Type::Grab:
+        case Type::Drop:
+        case Type::Cancel:
+            if (!ReadDouble(data, pos, event.mX) || !ReadDouble(data, pos, event.mY))
+            {
+                return false;
+            }
+            break;
+
+        default:
+            return false;
+        }
+
+        events.push_back(event);
+    }
+
+    mEvents = events;
+    mSeed = (unsigned int)seed;
+    mStep = step;
+    mEndTick = (long long)endTick;
+    return true;
+}
@@ -0,0 +1,122 @@
+/**
+ * \file Replay.h
+ *
+ * \author Morgan Mundell
+ *
+ *  Recorded player input that can be fed back into a game
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+/**
+ * The player input of one game, each stamped with its simulation tick.
+ *
+ * Together with the random seed and the simulation step this is
+ * everything needed to play the game again exactly. Replays are
+ * stored in a compact binary file: a short header and then one
+ * record per input holding the ticks since the previous input,
+ * the input type and its arguments.
+ */
+class CReplay
+{
+public:
+    /// Kinds of input
+    enum class Type : unsigned char
+    {
+        /// A level file was loaded
+        Load = 1,
+        /// The mouse button went down on the game
+        Grab = 2,
+        /// The mouse button was released while holding an item
+        Drop = 3,
+        /// The held item was let go without being dropped
+        Cancel = 4,
+        /// A yes or no question was answered
+        Answer = 5
+    };
+
+    /// One recorded input
+    struct Event
+    {
+        /// Simulation tick the input happened before
+        long long mTick;
+
+        /// Kind of input
+        Type mType;
+
+        /// X location in virtual pixels, or 1 for a yes answer
+        double mX;
+
+        /// Y location in virtual pixels
+        double mY;
+
+        /// Filename of a loaded level
+        std::wstring mText;
+    };
+
+    void Clear();
+
+    void Add(long long tick, Type type, double x = 0, double y = 0, const std::wstring& text = L"");
+
+    bool Save(const std::wstring& filename) const;
+
+    bool Load(const std::wstring& filename);
+
+    /**
+     * The recorded inputs in the order they happened
+     * @returns Vector of events
+     */
+    const std::vector<Event>& GetEvents() const { return mEvents; }
+
+    /**
+     * Seed of the game's random numbers when recording started
+     * @returns Seed
+     */
+    unsigned int GetSeed() const { return mSeed; }
+
+    /**
+     * Set the seed of the game's random numbers
+     * @param seed Seed
+     */
+    void SetSeed(unsigned int seed) { mSeed = seed; }
+
+    /**
+     * Simulated time of one tick
+     * @returns Step in seconds
+     */
+    double GetStep() const { return mStep; }
+
+    /**
+     * Set the simulated time of one tick
+     * @param step Step in seconds
+     */
+    void SetStep(double step) { mStep = step; }
+
+    /**
+     * Number of ticks the game ran while recording
+     * @returns Tick count
+     */
+    long long GetEndTick() const { return mEndTick; }
+
+    /**
+     * Set the number of ticks the game ran while recording
+     * @param tick Tick count
+     */
+    void SetEndTick(long long tick) { mEndTick = tick; }
+
+private:
+    /// Recorded inputs in order
+    std::vector<Event> mEvents;
+
+    /// Seed of the game's random numbers
+    unsigned int mSeed = 0;
+
+    /// Simulated time of one tick in seconds
+    double mStep = 0.025;
+
+    /// Number of ticks the game ran
+    long long mEndTick = 0;
+};
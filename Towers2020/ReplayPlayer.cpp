@@ -0,0 +1,116 @@
+/**
+ * \file ReplayPlayer.cpp
+ *
+ * \author Morgan Mundell
+ */
+
+#include "pch.h"
+#include <iostream>
+#include "ReplayPlayer.h"
+#include "TowersGame.h"
+
+using namespace std;
+
+/**
+ * Prepare a game to have the replay played into it
+ * @param game A newly constructed game
+ */
+void CReplayPlayer::Start(CTowersGame* game)
+{
+    mGame = game;
+    mNext = 0;
+    mNextAnswer = 0;
+
+    mGame->SetSeed(mReplay.GetSeed());
+    mGame->SetHost(this);
+}
+
+/**
+ * Apply the input for the current tick and advance the game one tick
+ * @returns False once the game has run as many ticks as were recorded
+ */
+bool CReplayPlayer::Step()
+{
+    auto& events = mReplay.GetEvents();
+
+    while (mNext < events.size() && events[mNext].mTick <= mGame->GetTick())
+    {
+        auto& event = events[mNext++];
+        switch (event.mType)
+        {
+        case CReplay::Type::Load:
+            mGame->Load(event.mText);
+            break;
+
+        case CReplay::Type::Grab:
+            mGame->Grab(event.mX, event.mY);
+            break;
+
+        case CReplay::Type::Drop:
+            mGame->Drop(event.mX, event.mY);
+            break;
+
+        case CReplay::Type::Cancel:
+            mGame->Drag(event.mX, event.mY);
+            mGame->CancelGrab();
+            break;
+
+        default:
+            // Answers are given when the game asks for them
+            break;
+        }
+    }
+
+    if (mGame->GetTick() >= mReplay.GetEndTick())
+    {
+        return false;
+    }
+
+    mGame->Update(mReplay.GetStep());
+    return true;
+}
+
+/**
+ * Play the whole replay
+ * @returns Number of ticks run
+ */
+long long CReplayPlayer::Run()
+{
+    long long ticks = 0;
+    while (Step())
+    {
+        ticks++;
+    }
+
+    return ticks;
+}
+
+/**
+ * Messages during a replay go to the error stream
+ * @param message The message
+ */
+void CReplayPlayer::ShowMessage(const wstring& message)
+{
+    wcerr << message << endl;
+}
+
+/**
+ * Answer a question the way it was answered when recording
+ * @param question The question
+ * @param title Title for the question
+ * @returns The recorded answer, no if there is none
+ */
+bool CReplayPlayer::AskYesNo(const wstring& question, const wstring& title)
+{
+    auto& events = mReplay.GetEvents();
+    while (mNextAnswer < events.size())
+    {
+        auto& event = events[mNextAnswer++];
+        if (event.mType == CReplay::Type::Answer)
+        {
+            return event.mX != 0;
+        }
+    }
+
+    return false;
+}
@@ -0,0 +1,61 @@
+/**
+ * \file ReplayPlayer.h
+ *
+ * \author Morgan Mundell
+ *
+ *  Plays a recorded replay back into a game
+ */
+
+#pragma once
+
+#include "GameHost.h"
+#include "Replay.h"
+
+class CTowersGame;
+
+/**
+ * Feeds the input of a replay into a game tick by tick.
+ *
+ * The player seeds the game the way it was seeded when the replay
+ * was recorded and stands in as the game's host, so questions are
+ * answered the way the player answered them. The game must be newly
+ * constructed so it starts from the same state.
+ */
+class CReplayPlayer : public CGameHost
+{
+public:
+    /**
+     * Constructor
+     * @param replay The replay to play, must outlive the player
+     */
+    CReplayPlayer(const CReplay& replay) : mReplay(replay) {}
+
+    /// Default constructor (disabled)
+    CReplayPlayer() = delete;
+
+    /// Copy constructor (disabled)
+    CReplayPlayer(const CReplayPlayer&) = delete;
+
+    void Start(CTowersGame* game);
+
+    bool Step();
+
+    long long Run();
+
+    virtual void ShowMessage(const std::wstring& message) override;
+
+    virtual bool AskYesNo(const std::wstring& question, const std::wstring& title) override;
+
+private:
+    /// The replay being played
+    const CReplay& mReplay;
+
+    /// The game being played into
+    CTowersGame* mGame = nullptr;
+
+    /// Index of the next event to apply
+    size_t mNext = 0;
+
+    /// Index to start looking for the next answer from
+    size_t mNextAnswer = 0;
+};
@@ -0,0 +1,78 @@
+/**
+ * \file RoadPath.cpp
+ *
+ * \author Morgan Mundell
+ */
+
+#include "pch.h"
+#include <algorithm>
+#include <cmath>
+#include "RoadPath.h"
+
+using namespace std;
+
+/**
+ * Remove all segments from the path
+ */
+void CRoadPath::Clear()
+{
+    mSegments.clear();
+    mLength = 0;
+}
+
+/**
+ * Add a segment to the end of the path.
+ *
+ * Segments of zero length are ignored.
+ * @param x1 X location of the start of the segment
+ * @param y1 Y location of the start of the segment
+ * @param x2 X location of the end of the segment
+ * @param y2 Y location of the end of the segment
+ */
+void CRoadPath::AddSegment(double x1, double y1, double x2, double y2)
+{
+    double dx = x2 - x1;
+    double dy = y2 - y1;
+    double length = sqrt(dx * dx + dy * dy);
+    if (length <= 0)
+    {
+        return;
+    }
+
+    Segment segment;
+    segment.mX = x1;
+    segment.mY = y1;
+    segment.mDirX = dx / length;
+    segment.mDirY = dy / length;
+    segment.mStart = mLength;
+    segment.mLength = length;
+
+    mSegments.push_back(segment);
+    mLength += length;
+}
+
+/**
+ * Find the location a given distance along the path.
+ * @param distance Distance from the start of the path
+ * @param x Returns the X location
+ * @param y Returns the Y location
+ * @returns False if the distance is past the end of the path or there is no path
+ */
+bool CRoadPath::Locate(double distance, double& x, double& y) const
+{
+    if (mSegments.empty() || distance >= mLength)
+    {
+        return false;
+    }
+
+    // Find the last segment that starts at or before the distance
+    auto after = upper_bound(mSegments.begin(), mSegments.end(), distance,
+        [](double d, const Segment& segment) { return d < segment.mStart; });
+
+    const Segment& segment = after == mSegments.begin() ? *after : *(after - 1);
+
+    double along = max(0.0, distance - segment.mStart);
+    x = segment.mX + segment.mDirX * along;
+    y = segment.mY + segment.mDirY * along;
+    return true;
+}
@@ -0,0 +1,76 @@
+/**
+ * \file RoadPath.h
+ *
+ * \author Morgan Mundell
+ *
+ *  The road of a level compiled into a single polyline
+ */
+
+#pragma once
+
+#include <vector>
+
+/**
+ * The road of a level compiled into one polyline.
+ *
+ * The segments are stored in order along the road together with
+ * the distance from the start of the road to the start of each
+ * segment, so anything travelling the road only needs to know how
+ * far along it is.
+ */
+class CRoadPath
+{
+public:
+    /// One straight piece of the road
+    struct Segment
+    {
+        /// X location of the start of the segment
+        double mX;
+
+        /// Y location of the start of the segment
+        double mY;
+
+        /// X component of the unit direction of travel
+        double mDirX;
+
+        /// Y component of the unit direction of travel
+        double mDirY;
+
+        /// Distance along the path to the start of the segment
+        double mStart;
+
+        /// Length of the segment
+        double mLength;
+    };
+
+    void Clear();
+
+    void AddSegment(double x1, double y1, double x2, double y2);
+
+    bool Locate(double distance, double& x, double& y) const;
+
+    /**
+     * Total length of the path
+     * @returns Length in virtual pixels
+     */
+    double GetLength() const { return mLength; }
+
+    /**
+     * Is there any path at all?
+     * @returns True if the path has no segments
+     */
+    bool IsEmpty() const { return mSegments.empty(); }
+
+    /**
+     * Get the segments of the path in order
+     * @returns Vector of segments
+     */
+    const std::vector<Segment>& GetSegments() const { return mSegments; }
+
+private:
+    /// The segments in order along the road
+    std::vector<Segment> mSegments;
+
+    /// Total length of the path
+    double mLength = 0;
+};
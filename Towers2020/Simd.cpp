@@ -0,0 +1,82 @@
+/**
+ * \file Simd.cpp
+ *
+ * \author Morgan Mundell
+ */
+
+#include "pch.h"
+#include "Simd.h"
+
+#if defined(_MSC_VER) && defined(TOWERS_SIMD_X86)
+#include <intrin.h>
+#endif
+
+/**
+ * Ask the processor for the best vector instructions it has
+ * @returns Best level supported by the processor and the operating system
+ */
+static SimdLevel DetectSimdLevel()
+{
+#if defined(_MSC_VER) && defined(TOWERS_SIMD_X86)
+    int info[4];
+    __cpuid(info, 0);
+    int leaves = info[0];
+
+    __cpuid(info, 1);
+    bool sse2 = (info[3] & (1 << 26)) != 0;
+    bool osxsave = (info[2] & (1 << 27)) != 0;
+    bool avx = (info[2] & (1 << 28)) != 0;
+
+    // AVX registers are only usable if the operating system saves them
+    bool avx2 = false;
+    if (leaves >= 7 && osxsave && avx && (_xgetbv(0) & 6) == 6)
+    {
+        __cpuidex(info, 7, 0);
+        avx2 = (info[1] & (1 << 5)) != 0;
+    }
+
+    return avx2 ? SimdLevel::Avx2 : sse2 ? SimdLevel::Sse2 : SimdLevel::Scalar;
+#elif defined(__GNUC__) && defined(TOWERS_SIMD_X86)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+    {
+        return SimdLevel::Avx2;
+    }
+
+    return __builtin_cpu_supports("sse2") ? SimdLevel::Sse2 : SimdLevel::Scalar;
+#else
+    return SimdLevel::Scalar;
+#endif
+}
+
+/**
+ * Get the best vector instructions the processor has.
+ *
+ * The processor is only asked once.
+ * @returns Best supported level
+ */
+SimdLevel GetSimdLevel()
+{
+    static SimdLevel level = DetectSimdLevel();
+    return level;
+}
+
+/**
+ * Name of a level of vector instructions, for reports
+ * @param level The level
+ * @returns Name, Ex: L"AVX2"
+ */
+const wchar_t* SimdLevelName(SimdLevel level)
+{
+    switch (level)
+    {
+    case SimdLevel::Avx2:
+        return L"AVX2";
+
+    case SimdLevel::Sse2:
+        return L"SSE2";
+
+    default:
+        return L"scalar";
+    }
+}
@@ -0,0 +1,24 @@
+/**
+ * \file Simd.h
+ *
+ * \author Morgan Mundell
+ *
+ *  Finding which vector instructions the processor running the game has
+ */
+
+#pragma once
+
+#if defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || \
+    (defined(__SSE2__) && (defined(__x86_64__) || defined(__i386__)))
+/// Defined when building for x86 with SSE2, where the vector kernels are compiled
+#define TOWERS_SIMD_X86 1
+#endif
+
+/**
+ * Sets of vector instructions a kernel can be written with, from least to most
+ */
+enum class SimdLevel { Scalar, Sse2, Avx2 };
+
+SimdLevel GetSimdLevel();
+
+const wchar_t* SimdLevelName(SimdLevel level);
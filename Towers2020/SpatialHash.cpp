@@ -0,0 +1,168 @@
+/**
+ * \file SpatialHash.cpp
+ *
+ * \author Morgan Mundell
+ */
+
+#include "pch.h"
+#include <cmath>
+#include "SpatialHash.h"
+#include "Balloon.h"
+
+using namespace std;
+
+/**
+ * Remove all balloons from the hash.
+ *
+ * The cells keep their storage so rebuilding every tick
+ * does not allocate once the level is running.
+ */
+void CSpatialHash::Clear()
+{
+    for (auto& occupied : mOccupied)
+    {
+        occupied.mCell->mBalloons.clear();
+        occupied.mCell->mX.clear();
+        occupied.mCell->mY.clear();
+    }
+
+    mOccupied.clear();
+    mCount = 0;
+}
+
+/**
+ * Add a balloon at its current location
+ * @param balloon The balloon to add
+ */
+void CSpatialHash::Insert(CBalloon* balloon)
+{
+    double x = balloon->GetX();
+    double y = balloon->GetY();
+    int column = CellOf(x);
+    int row = CellOf(y);
+
+    auto& cell = mCells[CellKey(column, row)];
+    if (cell.mBalloons.empty())
+    {
+        mOccupied.push_back({ column, row, &cell });
+    }
+
+    cell.mBalloons.push_back(balloon);
+    cell.mX.push_back(x);
+    cell.mY.push_back(y);
+    mCount++;
+}
+
+/**
+ * Call a function for each occupied cell a circle's bounding box overlaps
+ * @param x X location of the center of the circle
+ * @param y Y location of the center of the circle
+ * @param radius Radius of the circle
+ * @param visit Function called with each cell
+ */
+template<class Visit>
+void CSpatialHash::VisitCells(double x, double y, double radius, Visit visit) const
+{
+    if (mCount == 0 || radius < 0)
+    {
+        return;
+    }
+
+    int column1 = CellOf(x - radius);
+    int column2 = CellOf(x + radius);
+    int row1 = CellOf(y - radius);
+    int row2 = CellOf(y + radius);
+
+    // A circle covering more cells than are occupied is
+    // cheaper to answer by visiting the occupied cells
+    double covered = double(column2 - column1 + 1) * (row2 - row1 + 1);
+    if (covered > mOccupied.size())
+    {
+        for (auto& occupied : mOccupied)
+        {
+            if (occupied.mColumn >= column1 && occupied.mColumn <= column2 &&
+                occupied.mRow >= row1 && occupied.mRow <= row2)
+            {
+                visit(*occupied.mCell);
+            }
+        }
+
+        return;
+    }
+
+    for (int row = row1; row <= row2; row++)
+    {
+        for (int column = column1; column <= column2; column++)
+        {
+            auto cell = mCells.find(CellKey(column, row));
+            if (cell != mCells.end() && !cell->second.mBalloons.empty())
+            {
+                visit(cell->second);
+            }
+        }
+    }
+}
+
+/**
+ * Find every balloon that was within a radius of a point when it was added.
+ * @param x X location of the center of the circle
+ * @param y Y location of the center of the circle
+ * @param radius Radius of the circle
+ * @param found Balloons in the circle, with the locations they were added at, are appended to this
+ */
+void CSpatialHash::Query(double x, double y, double radius, vector<Entry>& found) const
+{
+    double radius2 = radius * radius;
+    VisitCells(x, y, radius, [&](const Cell& cell) {
+        for (size_t i = 0; i < cell.mBalloons.size(); i++)
+        {
+            double dX = x - cell.mX[i];
+            double dY = y - cell.mY[i];
+            if (dX * dX + dY * dY <= radius2)
+            {
+                found.push_back({ cell.mBalloons[i], cell.mX[i], cell.mY[i] });
+            }
+        }
+    });
+}
+
+/**
+ * Gather every balloon in the cells a circle's bounding box overlaps.
+ *
+ * Balloons gathered may still be outside the circle, the caller
+ * tests the gathered locations itself, all at once. Each array
+ * must have room for every balloon in the hash.
+ * @param x X location of the center of the circle
+ * @param y Y location of the center of the circle
+ * @param radius Radius of the circle
+ * @param balloons Array the balloons are written to
+ * @param xs Array the X locations the balloons were added at are written to
+ * @param ys Array the Y locations the balloons were added at are written to
+ * @returns Number of balloons gathered
+ */
+size_t CSpatialHash::Gather(double x, double y, double radius,
+    CBalloon** balloons, double* xs, double* ys) const
+{
+    size_t count = 0;
+    VisitCells(x, y, radius, [&](const Cell& cell) {
+        // Cells hold only a few balloons, too few for a call to copy them
+        for (size_t i = 0; i < cell.mBalloons.size(); i++, count++)
+        {
+            balloons[count] = cell.mBalloons[i];
+            xs[count] = cell.mX[i];
+            ys[count] = cell.mY[i];
+        }
+    });
+
+    return count;
+}
+
+/**
+ * Cell index for a location along either axis
+ * @param value X or Y location
+ * @returns Column or row of the cell
+ */
+int CSpatialHash::CellOf(double value) const
+{
+    return (int)floor(value / mCellSize);
+}
@@ -0,0 +1,112 @@
+/**
+ * \file SpatialHash.h
+ *
+ * \author Morgan Mundell
+ *
+ *  Uniform grid of balloon locations for radius queries
+ */
+
+#pragma once
+
+#include <unordered_map>
+#include <vector>
+
+class CBalloon;
+
+/**
+ * Uniform grid spatial hash of balloon locations.
+ *
+ * Balloons are bucketed by the grid cell their location falls in.
+ * Each keeps the location it was added at, and queries test that
+ * location, so balloons moving after the hash is built do not leave
+ * it out of step with its cells. A cell keeps its locations in arrays
+ * of their own, so the balloons near a point can be gathered into
+ * arrays a whole cell at a time and tested together.
+ *
+ * A radius query only visits the cells the circle overlaps, so the
+ * cost depends on the number of balloons near the query point rather
+ * than on the size of the level.
+ *
+ * The hash is rebuilt every update while the road owns the balloons,
+ * so it holds plain pointers to them.
+ */
+class CSpatialHash
+{
+public:
+    /// A balloon and where it was when it was added
+    struct Entry
+    {
+        CBalloon* mBalloon;     ///< The balloon
+        double mX;              ///< X location when added
+        double mY;              ///< Y location when added
+    };
+
+    /**
+     * Constructor
+     * @param cellSize Width and height of a cell in virtual pixels
+     */
+    CSpatialHash(double cellSize) : mCellSize(cellSize) {}
+
+    /// Default constructor (disabled)
+    CSpatialHash() = delete;
+
+    void Clear();
+
+    void Insert(CBalloon* balloon);
+
+    void Query(double x, double y, double radius, std::vector<Entry>& found) const;
+
+    size_t Gather(double x, double y, double radius, CBalloon** balloons, double* xs, double* ys) const;
+
+    /**
+     * Number of balloons in the hash
+     * @returns Balloon count
+     */
+    int GetCount() const { return mCount; }
+
+private:
+    /// The balloons in one cell of the grid, in parallel arrays
+    struct Cell
+    {
+        std::vector<CBalloon*> mBalloons;   ///< The balloons
+        std::vector<double> mX;             ///< X locations when added
+        std::vector<double> mY;             ///< Y locations when added
+    };
+
+    /// A cell holding balloons, with its column and row kept beside it
+    /// so finding the cells near a point does not touch the others
+    struct Occupied
+    {
+        int mColumn;                        ///< Column of the cell
+        int mRow;                           ///< Row of the cell
+        Cell* mCell;                        ///< The cell
+    };
+
+    /**
+     * Key for a cell of the grid
+     * @param column Cell column
+     * @param row Cell row
+     * @returns Key combining both into one value
+     */
+    static long long CellKey(int column, int row)
+    {
+        return ((long long)column << 32) ^ (unsigned int)row;
+    }
+
+    int CellOf(double value) const;
+
+    template<class Visit>
+    void VisitCells(double x, double y, double radius, Visit visit) const;
+
+    /// Width and height of a cell
+    double mCellSize;
+
+    /// Every cell that has held a balloon. Emptied cells keep their storage.
+    std::unordered_map<long long, Cell> mCells;
+
+    /// The cells holding balloons now, in the order they were first filled
+    std::vector<Occupied> mOccupied;
+
+    /// Number of balloons in the hash
+    int mCount = 0;
+};
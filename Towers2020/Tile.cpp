@@ -12,7 +12,6 @@
 #include "Tile.h"
 
 using namespace std;
-using namespace Gdiplus;
 
 /** 
  * Constructor
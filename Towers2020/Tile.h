@@ -23,13 +23,19 @@ public:
     ///  Default constructor (disabled)
     CTile() = delete;
 
-    void CTile::XmlLoad(const std::shared_ptr<xmlnode::CXmlNode>& node);
+    void XmlLoad(const std::shared_ptr<xmlnode::CXmlNode>& node);
 
     ///  Copy constructor (disabled)
     CTile(const CTile&) = delete;
 
     ~CTile();
 
+    /**
+     * Tiles never change once a level is loaded
+     * @returns True
+     */
+    virtual bool IsStatic() const override { return true; }
+
 private: 
 };
 
@@ -0,0 +1,53 @@
+/**
+ * \file TileGrid.cpp
+ *
+ * \author Morgan Mundell
+ */
+
+#include "pch.h"
+#include "TileGrid.h"
+
+/**
+ * Resize the grid and empty every cell.
+ * @param column Column of the first cell
+ * @param row Row of the first cell
+ * @param columns Number of columns
+ * @param rows Number of rows
+ */
+void CTileGrid::Resize(int column, int row, int columns, int rows)
+{
+    mColumn = column;
+    mRow = row;
+    mColumns = columns > 0 ? columns : 0;
+    mRows = rows > 0 ? rows : 0;
+
+    mCells.assign((size_t)mColumns * mRows, NoTile);
+}
+
+/**
+ * Remove all cells from the grid
+ */
+void CTileGrid::Clear()
+{
+    Resize(0, 0, 0, 0);
+}
+
+/**
+ * Set the tile at a grid location
+ * @param column Grid column
+ * @param row Grid row
+ * @param index Tile index to store
+ * @returns False if the location is outside the grid
+ */
+bool CTileGrid::Set(int column, int row, int index)
+{
+    int c = column - mColumn;
+    int r = row - mRow;
+    if (c < 0 || r < 0 || c >= mColumns || r >= mRows)
+    {
+        return false;
+    }
+
+    mCells[r * mColumns + c] = index;
+    return true;
+}
@@ -0,0 +1,77 @@
+/**
+ * \file TileGrid.h
+ *
+ * \author Morgan Mundell
+ *
+ *  Dense grid index used for tile adjacency lookups
+ */
+
+#pragma once
+
+#include <vector>
+
+/**
+ * Dense width by height grid of tile indices.
+ *
+ * Each cell holds the index of the tile at that grid location
+ * or NoTile if the location is empty. Lookups are a bounds check
+ * and an array access.
+ */
+class CTileGrid
+{
+public:
+    /// Value of an empty cell
+    static const int NoTile = -1;
+
+    void Resize(int column, int row, int columns, int rows);
+
+    void Clear();
+
+    bool Set(int column, int row, int index);
+
+    /**
+     * Find the tile at a grid location
+     * @param column Grid column
+     * @param row Grid row
+     * @returns Tile index or NoTile if none or outside the grid
+     */
+    int Find(int column, int row) const
+    {
+        int c = column - mColumn;
+        int r = row - mRow;
+        if (c < 0 || r < 0 || c >= mColumns || r >= mRows)
+        {
+            return NoTile;
+        }
+
+        return mCells[r * mColumns + c];
+    }
+
+    /**
+     * Number of columns in the grid
+     * @returns Column count
+     */
+    int GetColumns() const { return mColumns; }
+
+    /**
+     * Number of rows in the grid
+     * @returns Row count
+     */
+    int GetRows() const { return mRows; }
+
+private:
+    /// Column of the first cell
+    int mColumn = 0;
+
+    /// Row of the first cell
+    int mRow = 0;
+
+    /// Number of columns
+    int mColumns = 0;
+
+    /// Number of rows
+    int mRows = 0;
+
+    /// The cells, row by row
+    std::vector<int> mCells;
+};
@@ -41,6 +41,6 @@ public:
      * Method Disabled (no entities are drawn on trees)
      * @param graphics The graphics object
      */
-    virtual void RenderEntities(Gdiplus::Graphics* graphics) {};
+    virtual void RenderEntities(CRenderer* graphics) {};
 };
 
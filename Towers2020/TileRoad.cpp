@@ -11,6 +11,7 @@
 #include "pch.h"
 #include "TileRoad.h"
 #include "ConfigureRoad.h"
+#include "Trace.h"
 
 #include <algorithm>
 #include <memory>
@@ -18,8 +19,31 @@
 
 using namespace std;
 
-/// Indicates when a balloon's mT will be subtracted
-bool mCleanup = false; 
+/**
+ * Convert one letter of a road type into a side
+ * @param letter Letter from the type, Ex: L'N'
+ * @returns The side or None if not a side letter
+ */
+static CTileRoad::Side LetterToSide(wchar_t letter)
+{
+    switch (letter)
+    {
+    case L'N':
+        return CTileRoad::Side::North;
+
+    case L'S':
+        return CTileRoad::Side::South;
+
+    case L'E':
+        return CTileRoad::Side::East;
+
+    case L'W':
+        return CTileRoad::Side::West;
+
+    default:
+        return CTileRoad::Side::None;
+    }
+}
 
 /** 
  * Constructor
@@ -33,6 +57,11 @@ CTileRoad::CTileRoad(CTowersGame* item) : CTile(item)
 /// Destructor
 CTileRoad::~CTileRoad()
 {
+    // Balloons may be held elsewhere after the road is gone
+    for (auto& balloon : mBalloons)
+    {
+        balloon->Detach();
+    }
 }
 
 /**
@@ -46,6 +75,13 @@ void CTileRoad::XmlLoad(const std::shared_ptr<xmlnode::CXmlNode>& node)
     CTile::XmlLoad(node);
 
     mType = GetDeclarationAttribute(GetItemId(), L"type");
+
+    // Forward travel enters by the first side in the type and leaves by the second
+    if (mType.size() == 2)
+    {
+        mEntry = LetterToSide(mType[0]);
+        mExit = LetterToSide(mType[1]);
+    }
     
     if (node->GetAttributeValue(L"start", L"") == L"true")
     {
@@ -61,225 +97,132 @@ void CTileRoad::XmlLoad(const std::shared_ptr<xmlnode::CXmlNode>& node)
 }
 
 /**
- * Place the balloon on the North/West tile, where
- * forward motion is assumed to be from a North entrance
- * to a West exit.
- * @param balloon The balloon we are placing.
+ * Find the point in the middle of one side of the tile
+ * @param side The side of the tile
+ * @param x Returns the X location
+ * @param y Returns the Y location
  */
-void CTileRoad::PlaceBalloonNW(std::shared_ptr<CBalloon> balloon)
+void CTileRoad::SidePoint(Side side, double& x, double& y)
 {
-    // Current t value for this balloon
-    auto t = balloon->GetT();
-
     // Initially set to the center of the tile in each dimension
-    auto y = GetY() + GetHeight() / 2;
-    auto x = GetX() + GetWidth() / 2;
-
-    if (balloon->IsReverse())
-    {
-        t = 1 - t;
-    }
+    x = GetX() + GetWidth() / 2.0;
+    y = GetY() + GetHeight() / 2.0;
 
-    if (t < 0.5)
+    switch (side)
     {
-        // First half of path
-        // Moving vertically down
-        y = GetY() + t * GetHeight();
-    }
-    else
-    {
-        // Second half of path
-        // Moving horizontally left
-        x = GetX() + (1 - t) * GetWidth();
-    }
-
-    balloon->SetLocation(x, y);
-}
+    case Side::North:
+        y = GetY();
+        break;
 
-/**
- * Place the balloon on the South/East tile, where
- * forward motion is assumed to be from a South entrance
- * to an East exit.
- * @param balloon The balloon we are placing.
- */
-void CTileRoad::PlaceBalloonSE(std::shared_ptr<CBalloon> balloon)
-{
-    // Current t value for this balloon
-    auto t = balloon->GetT();
+    case Side::South:
+        y = GetY() + GetHeight();
+        break;
 
-    // Initially set to the center of the file in each dimension
-    int y = GetY() + GetHeight() / 2;
-    int x = GetX() + GetWidth() / 2;
+    case Side::East:
+        x = GetX() + GetWidth();
+        break;
 
-    if (balloon->IsReverse())
-    {
-        t = 1 - t;
-    }
+    case Side::West:
+        x = GetX();
+        break;
 
-    if (t < 0.5)
-    {
-        // First half of path
-        // Moving vertically up
-        y = GetY() - (t - 1) * GetHeight();
+    default:
+        break;
     }
-    else
-    {
-        // Second half of path
-        // Moving horizontally right
-        x = GetX() + t * GetWidth();
-    }
-
-    balloon->SetLocation(x, y);
 }
 
 /**
- * Place the balloon on the South/West tile, where
- * forward motion is assumed to be from a West entrance
- * to a South exit.
- * @param balloon The balloon we are placing.
- */ 
-void CTileRoad::PlaceBalloonSW(std::shared_ptr<CBalloon> balloon)
+ * Add the road across this tile to the end of a path.
+ *
+ * Straight roads are one segment from the entry to the exit.
+ * Turns go from the entry to the center of the tile and then
+ * on to the exit.
+ * @param path The path we are adding to
+ * @param reverse True if the tile is travelled backwards
+ */
+void CTileRoad::AddToPath(CRoadPath* path, bool reverse)
 {
-    // Current t value for this balloon
-    auto t = balloon->GetT();
-
-    // Initially set to the center of the file in each dimension
-    auto y = GetY() + GetHeight() / 2;
-    auto x = GetX() + GetWidth() / 2;
+    double entryX, entryY, exitX, exitY;
+    SidePoint(GetEntry(reverse), entryX, entryY);
+    SidePoint(GetExit(reverse), exitX, exitY);
 
-    if (balloon->IsReverse())
+    if (entryX == exitX || entryY == exitY)
     {
-        t = 1 - t;
-    }
-
-    if (t < 0.5)
-    {
-        // First half of path
-        // Moving vertically up
-        y = GetY() - (t - 1) * GetHeight();
+        path->AddSegment(entryX, entryY, exitX, exitY);
     }
     else
     {
-        // Second half of path
-        // Moving horizonally left
-        x = GetX() + (1 - t) * GetWidth();
+        double centerX = GetX() + GetWidth() / 2.0;
+        double centerY = GetY() + GetHeight() / 2.0;
+        path->AddSegment(entryX, entryY, centerX, centerY);
+        path->AddSegment(centerX, centerY, exitX, exitY);
     }
-
-    balloon->SetLocation(x, y);
 }
 
 /**
- * Place the balloon on the North/South tile, where
- * forward motion is assumed to be from a North entrance
- * to a South exit.
- * @param balloon The balloon we are placing.
+ * Generates a Ballon entity at the request of the level.
+ * @param offsetX The X offset relative to the start of the level.
+ * @param offsetY The Y offset relative to the start of the level.
+ * @returns Handle to the new balloon
  */
-void CTileRoad::PlaceBalloonNS(std::shared_ptr<CBalloon> balloon)
+CBalloon::Handle CTileRoad::GenerateBalloon(double offsetX, double offsetY)
 {
-    // Current t value for this balloon
-    auto t = balloon->GetT();
+    auto balloon = make_shared<CBalloon>(GetGame());
+    balloon->setXOffset(offsetX);
+    balloon->setYOffset(offsetY);
+    balloon->SetLocation(GetX() + (int)balloon->GetXOffset(), GetY() + (int)balloon->GetYOffset());
+    balloon->Attach(&mStore);
 
-    // Initially set to the center of the file in each dimension
-    auto y = GetY() + GetHeight() / 2;
-    auto x = GetX() + GetWidth() / 2;
+    // Balloons start at the beginning of the level's road
+    PlaceBalloon(balloon.get());
 
-    if (balloon->IsReverse())
+    unsigned int slot;
+    if (!mFreeSlots.empty())
     {
-        t = 1 - t;
+        slot = mFreeSlots.back();
+        mFreeSlots.pop_back();
     }
-
-    // Full path
-    // Moving vertically down
-    y = GetY() + t * GetHeight();
-
-    balloon->SetLocation(x, y);
-}
-
-/**
- * Place the balloon on the North/East tile, where
- * forward motion is assumed to be from a North entrance
- * to an East exit.
- * @param balloon The balloon we are placing.
- */
-void CTileRoad::PlaceBalloonNE(std::shared_ptr<CBalloon> balloon)
-{
-    // Current t value for this balloon
-    auto t = balloon->GetT();
-
-    if (balloon->IsReverse())
+    else
     {
-        t = 1 - t;
+        slot = (unsigned int)mSlots.size();
+        mSlots.push_back(Slot());
     }
 
-    // Initially set to the center of the file in each dimension
-    auto y = GetY() + GetHeight() / 2;
-    auto x = GetX() + GetWidth() / 2;
+    mSlots[slot].mIndex = (int)mBalloons.size();
 
-    if (t < 0.5)
-    {
-        // First half of path
-        // Moving vertically down
-        y = GetY() + t * GetHeight();
-    }
-    else
-    {
-        // Second half of path
-        // Moving horizontally right
-        x = GetX() + t * GetWidth();
-    }
+    CBalloon::Handle handle;
+    handle.mSlot = slot;
+    handle.mGeneration = mSlots[slot].mGeneration;
+    balloon->SetHandle(handle);
 
-    balloon->SetLocation(x, y);
+    mBalloons.push_back(balloon);
+    TOWERS_TRACE_INSTANT("BalloonSpawn");
+    return handle;
 }
 
 /**
- * Place the balloon on the East/West tile, where
- * forward motion is assumed to be from an East entrance
- * to a West exit.
- * @param balloon The balloon we are placing.
+ * Get the balloon a handle refers to
+ * @param handle Handle from GenerateBalloon or a balloon's GetHandle
+ * @returns The balloon or nullptr if it has been retired from the road
  */
-void CTileRoad::PlaceBalloonEW(std::shared_ptr<CBalloon> balloon)
+CBalloon* CTileRoad::GetBalloon(CBalloon::Handle handle) const
 {
-    // Current t value for this balloon
-    auto t = balloon->GetT();
-
-    if (balloon->IsReverse())
+    if (handle.mSlot >= mSlots.size())
     {
-        t = 1 - t;
+        return nullptr;
     }
 
-    // Initially set to the center of the file in each dimension
-    auto y = GetY() + GetHeight() / 2;
-    auto x = GetX() + GetWidth() / 2;
-
-    // Second half of path
-    // Moving horizontally left
-    x = GetX() + (1 - t) * GetWidth();
-
-    balloon->SetLocation(x, y);
-}
-
-/**
- * Generates a Ballon entity at the request of the level.
- * @param offsetX The X offset relative to the start of the level.
- * @param offsetY The Y offset relative to the start of the level.
- */
-void CTileRoad::GenerateBalloon(double offsetX, double offsetY)
-{
-    auto balloon = make_shared<CBalloon>(GetGame());
-    balloon->setXOffset(offsetX);
-    balloon->setYOffset(offsetY);
-    balloon->SetLocation(GetX() + (int)balloon->GetXOffset(), GetY() + (int)balloon->GetYOffset());
-
-    // If the starting tile is reversed, then reverse the balloon upon load
-    if (mStartDirection == false)
+    auto& slot = mSlots[handle.mSlot];
+    if (slot.mIndex < 0 || slot.mGeneration != handle.mGeneration)
     {
-        balloon->Backwards();
+        return nullptr;
     }
-    mBalloons.push_back(balloon);
+
+    return mBalloons[slot.mIndex].get();
 }
 
 /**
- * Code for updating the position of the balloon goes here after each tile
+ * Code for updating the position of the balloons travelling from this tile
  * @param elapsed The elapsed time
  */
 void CTileRoad::Update(double elapsed)
@@ -289,267 +232,157 @@ void CTileRoad::Update(double elapsed)
 
         if (mTimeToGenerate < 0 && mNumToGenerate > 0)
         {
-            mTimeToGenerate = 0.5;
+            mTimeToGenerate = mGenerateInterval;
 
             GenerateBalloon(-64, -64);
 
             mNumToGenerate -= 1;
         }
     }
-    
-
-    // Adds new balloons to the collection
-    for (auto balloon : mBalloonsToTransfer)
-    {
-        shared_ptr<CBalloon> bal = move(balloon);
-
-        bal->SetIsDeleted(false);
-
-        mBalloons.push_back(bal);
-    }
-    mBalloonsToTransfer.clear();
 
     // Deletes balloons removed from the collection
-    for (auto balloon : mBalloonsToDelete)
-    {
-        auto it = find(mBalloons.begin(), mBalloons.end(), balloon);
-        int index = distance(mBalloons.begin(), it);
-        mBalloons.erase(mBalloons.begin() + index);
-    }
-    mBalloonsToDelete.clear();
+    RetireBalloons();
 
-    for (auto balloon : mBalloons)
+    auto& path = GetGame()->GetRoadPath();
+    double length = path.GetLength();
+
+    for (size_t i = 0; i < mStore.GetCount(); )
     {
-        // A transferred balloon will have mT subtracted by 1
-        if (balloon->HasTransferred())
+        if (mStore.GetDistance(i) >= length)
         {
-            balloon->SetT(balloon->GetT() - 1);
-            balloon->SetHasTransferred(false);
-        }
+            // Balloons delete themselves at the end of the path
+            if (!mStore.Is(i, CBalloonStore::Popped))
+            {
+                GetGame()->AddToGameScore(-1);
+                GetGame()->DecrementBalloonCount();
+                TOWERS_TRACE_INSTANT("BalloonLeak");
+            }
 
-        auto t = balloon->GetT();
+            // Towers later in this update still see it in the spatial
+            // hash, so it must look popped to them as it leaves
+            mBalloons[i]->SetRendering(false);
+            mBalloons[i]->SetIsDeleted(true);
 
-        if (t >= 1)
-        {
-            balloon->SetHasTransferred(true);
-            DetermineTileProgression(balloon);
-        }
-        else
-        {
-            PlaceBalloon(balloon);
+            // The last balloon moves into this place, so look at it next
+            RemoveBalloon(i);
+            continue;
         }
 
-        balloon->Update(elapsed);
+        i++;
     }
+
+    // Every balloon left is placed and then moved on together
+    mStore.Place(path);
+    mStore.Advance(elapsed);
 }
 
 /** 
- * Uses a PlaceBalloonXX method to determine the placement of an updating balloon.
+ * Place an updating balloon at its distance along the level's road.
  * @param balloon The balloon needing to be moved 
  */
-void CTileRoad::PlaceBalloon(std::shared_ptr<CBalloon> balloon)
+void CTileRoad::PlaceBalloon(CBalloon* balloon)
 {
-    if (mType == L"EW")
-        PlaceBalloonEW(balloon);
-    else if (mType == L"NE")
-        PlaceBalloonNE(balloon);
-    else if (mType == L"NS")
-        PlaceBalloonNS(balloon);
-    else if (mType == L"NW")
-        PlaceBalloonNW(balloon);
-    else if (mType == L"SE")
-        PlaceBalloonSE(balloon);
-    else if (mType == L"SW")
-        PlaceBalloonSW(balloon);
+    double x, y;
+    if (GetGame()->GetRoadPath().Locate(balloon->GetDistance(), x, y))
+    {
+        balloon->SetLocation(x, y);
+    }
 }
 
 /**
- * Determines the next road tile a balloon will follow after its time on a tile expires. 
- * Schedules balloons for deletion and addition to other lists. 
+ * Queue a balloon for removal when balloons are next retired
  * @param balloon The balloon needing to be deleted/traded out of the collection
  */
-void CTileRoad::DetermineTileProgression(std::shared_ptr<CBalloon> balloon)
+void CTileRoad::ScheduleDelete(CBalloon* balloon)
 {
-    // We must determine the type of the tile this balloon currently is on
-    // and if it is going backwards
-
-    // Save the next adjacent tile to the current one
-    shared_ptr<CItem> temp;
-
-    // Variables to record which direction the adjacent tile is leading
-    int dx = -99, dy = -99;
-    bool reverse = balloon->IsReverse();
-
-    // If the balloon has ended on the North end
-    if (mType == L"NS" && reverse ||
-        mType == L"NW" && reverse ||
-        mType == L"NE" && reverse)
-    {
-        dx = 0;
-        dy = -1;
-        temp = GetAdjacent(dx, dy); // Up
-    }
-    // If the balloon has ended on the South end
-    else if (mType == L"NS" && !reverse ||
-             mType == L"SE" && reverse  ||
-             mType == L"SW" && reverse)
-    {
-        dx = 0;
-        dy = 1;
-        temp = GetAdjacent(dx, dy); // Down
-    }
-    // If the balloon has ended on the West end
-    else if (mType == L"EW" && !reverse ||
-             mType == L"NW" && !reverse ||
-             mType == L"SW" && !reverse)
+    // Make sure we are not deleting the balloon twice by accident
+    if (!balloon->IsBeingDeleted())
     {
-        dx = -1;
-        dy = 0;
-        temp = GetAdjacent(dx, dy); // Left
+        balloon->SetIsDeleted(true);
+        mDead++;
     }
-    // If the balloon has ended on the East end
-    else if (mType == L"EW" && reverse ||
-             mType == L"NE" && !reverse  ||
-             mType == L"SE" && !reverse)
+}
+
+/**
+ * Pop a balloon hit by a tower.
+ *
+ * The balloon stops drawing and being hit at once
+ * and leaves the road when balloons are next retired.
+ * @param balloon Balloon on this road
+ */
+void CTileRoad::PopBalloon(CBalloon* balloon)
+{
+    if (balloon->GetRendering())
     {
-        dx = 1;
-        dy = 0;
-        temp = GetAdjacent(dx, dy); // Right
+        balloon->SetRendering(false);
+        GetGame()->DecrementBalloonCount();
+        mDead++;
+        TOWERS_TRACE_INSTANT("BalloonPop");
     }
+}
 
-    CConfigureRoad visitor;
-
-    // End of path if temp is null (no adjacency)
-    if (temp == nullptr)
+/**
+ * Take popped and deleted balloons out of the road.
+ *
+ * Each one is replaced by the last balloon in the collection, so the
+ * balloons left are still contiguous and nothing else has to move.
+ * Handles to the retired balloons stop matching.
+ */
+void CTileRoad::RetireBalloons()
+{
+    if (mDead == 0)
     {
-
-
-        // Balloons delete themselves at the end of the path
-
-        ScheduleDelete(balloon);
-        if (balloon->GetRendering())
-        {
-            GetGame()->AddToGameScore(-1);
-            GetGame()->DecrementBalloonCount();
-        }
-        
         return;
     }
 
-    temp->Accept(&visitor);
-
-    wstring type = visitor.GetRoadType();
-
-
-    // The balloon is being transferred to a Northern (Southern-accepting) tile. Figure out which:
-    if (dx == 0 && dy == -1)
-    {
-        // Balloon is transfering North to an "NS"-type tile
-        if (type == L"NS")
-        {
-            balloon->Backwards(); // Indicate the balloon is now moving backwards
-        }
-        // Balloon is transfering North to an "SE"-type tile
-        else if (type == L"SE")
-        {
-            balloon->Forwards(); // Indicate the balloon is now moving forwards
-        }
-        // Balloon is transfering North to an "SW"-type tile
-        else if (type == L"SW")
-        {
-            balloon->Forwards();
-        }
-    }
-    // The balloon is being transferred to a Southern (Northern-accepting) tile. Figure out which:
-    else if (dx == 0 && dy == 1)
-    {
-        if (type == L"NE")
-        {
-            balloon->Forwards();
-        }
-        else if (type == L"NS")
-        {
-            balloon->Forwards();
-        }
-        else if (type == L"NW")
-        {
-            balloon->Forwards();
-        }
-    }
-    // The balloon is being transferred to a Western (Eastern-accepting) tile. Figure out which:
-    else if (dx == -1 && dy == 0)
-    {
-        if (type == L"EW")
-        {
-            balloon->Forwards();
-        }
-        else if (type == L"NE")
-        {
-            balloon->Backwards();
-        }
-        else if (type == L"SE")
-        {
-            balloon->Backwards();
-        }
-    }
-    // The balloon is being transferred to a Eastern (Western-accepting) tile. Figure out which:
-    else if (dx == 1 && dy == 0)
+    for (size_t i = 0; i < mBalloons.size(); )
     {
-        if (type == L"EW")
+        auto& balloon = mBalloons[i];
+        if (balloon->GetRendering() && !balloon->IsBeingDeleted())
         {
-            balloon->Backwards();
+            i++;
         }
-        else if (type == L"NW")
-        {
-            balloon->Backwards();
-        }
-        else if (type == L"SW")
+        else
         {
-            balloon->Backwards();
+            // The last balloon moves here, so look at this index again
+            RemoveBalloon(i);
         }
     }
 
-    // Schedule a delete to this Tlle's balloon.
-    // Schedule a transfer of this Tile's balloon to another Tile's collection.
-
-    ScheduleDelete(balloon);
-    visitor.GetRoad()->ScheduleTransfer(balloon);
+    mDead = 0;
 }
 
 /**
- * A list balloons queued for removal by DetermineTileProgression() 
- * @param balloon The balloon needing to be deleted/traded out of the collection
+ * Remove a balloon by moving the last balloon into its place
+ * @param index Index of the balloon in mBalloons
  */
-void CTileRoad::ScheduleDelete(std::shared_ptr<CBalloon> balloon)
+void CTileRoad::RemoveBalloon(size_t index)
 {
-    // Make sure we are not deleting the balloon twice by accident
-    if (!balloon->IsBeingDeleted())
-    {
-        shared_ptr<CBalloon> bal = move(balloon);
-        bal->SetIsDeleted(true); // Pop the balloon (temporarily)
-
-        mBalloonsToDelete.push_back(bal);
+    auto handle = mBalloons[index]->GetHandle();
+    auto& slot = mSlots[handle.mSlot];
+    slot.mGeneration++;
+    slot.mIndex = -1;
+    mFreeSlots.push_back(handle.mSlot);
+    mBalloons[index]->SetHandle(CBalloon::Handle());
+    mBalloons[index]->Detach();
 
+    // The store moves its last balloon the same way
+    mStore.Remove(index);
+    if (index + 1 < mBalloons.size())
+    {
+        mBalloons[index] = move(mBalloons.back());
+        mBalloons[index]->SetStoreIndex(index);
+        mSlots[mBalloons[index]->GetHandle().mSlot].mIndex = (int)index;
     }
 
-}
-
-/**
- * A list balloons queued to be added to the road tile by DetermineTileProgression() 
- * @param balloon The balloon needing to be added to the collection
- */
-void CTileRoad::ScheduleTransfer(std::shared_ptr<CBalloon> balloon)
-{
-    // Add a new externally created balloon into this tile's collection
-    shared_ptr<CBalloon> bal = move(balloon);
-    mBalloonsToTransfer.push_back(bal);
+    mBalloons.pop_back();
 }
 
 /** 
  * Draw this item
  * @param graphics The graphics context to draw on 
  */
-void CTileRoad::Draw(Gdiplus::Graphics* graphics)
+void CTileRoad::Draw(CRenderer* graphics)
 {
     CItem::Draw(graphics);
 }
@@ -559,10 +392,10 @@ void CTileRoad::Draw(Gdiplus::Graphics* graphics)
  * Does not draw the item itself.
  * @param graphics The graphics context to draw on 
  */
-void CTileRoad::RenderEntities(Gdiplus::Graphics* graphics)
+void CTileRoad::RenderEntities(CRenderer* graphics)
 {
     
-    for (auto balloon : mBalloons)
+    for (auto& balloon : mBalloons)
     {
         if (balloon->GetRendering())
         {
@@ -571,81 +404,13 @@ void CTileRoad::RenderEntities(Gdiplus::Graphics* graphics)
     }
 }
 
-/**
- * Hit test all balloons on a tile road
- * @param x The x value of the balloon
- * @param y The y value of the balloon
- * @param towerRadius The radius to check for a hit
- * @param dartTower True if a dart tower
- * @return int value of collisions
- */
-int CTileRoad::HitTestAllBalloons(int x, int y, double towerRadius, bool dartTower)
-{
-    std::vector<std::shared_ptr<CBalloon>> toDelete;
-    bool numHit = 0;
-
-    for (auto balloon : mBalloons)
-    {
-        if (balloon->GetRendering())
-        {
-
-            double dX = 0, dY = 0, distance = 0;
-
-            dX = (x - double(balloon->GetX()));
-            dY = (y - double(balloon->GetY()));
-
-            distance = sqrt(dX * dX + dY * dY);
-
-            if (!dartTower && distance <= towerRadius + 24)
-            {
-                toDelete.push_back(balloon);
-
-                numHit++;
-            }
-            else if (dartTower && distance <= towerRadius + 30)
-            {
-                dX = abs(dX);   // the X in the first quadrant
-                dY = abs(dY);   // the Y in the first quadrant
-
-                if (dX < 30)
-                {
-                    toDelete.push_back(balloon);
-                    numHit++;
-                }
-                else if (dY < 30)
-                {
-                    toDelete.push_back(balloon);
-                    numHit++;
-                }
-                else if (abs(dX - dY) < 30)
-                {
-                    toDelete.push_back(balloon);
-                    numHit++;
-                }
-            }
-        }
-    }
-
-    for (auto balloon : toDelete)
-    {
-        //ScheduleDelete(balloon);
-        if (balloon->GetRendering())
-        {
-            balloon->SetRendering(false);
-            GetGame()->DecrementBalloonCount();
-        }
-    }
-
-    return numHit;
-}
-
 /** 
  * Accepts all the potential balloons in a tile 
  * @param visitor The visitor pass through 
  */
 void CTileRoad::AcceptAllBalloons(CItemVisitor* visitor)
 {
-    for (auto balloon : mBalloons)
+    for (auto& balloon : mBalloons)
     {
         balloon->Accept(visitor);
     }
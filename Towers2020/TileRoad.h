@@ -11,7 +11,9 @@
 #include "Tile.h"
 #include "XmlNode.h"
 #include "Balloon.h"
+#include "BalloonStore.h"
 #include "TowersGame.h"
+#include "RoadPath.h"
 
  /**
   *  Implements a simple tile with tiles we can manipulate
@@ -20,6 +22,9 @@ class CTileRoad : public CTile
 {
 public:
 
+    /// Sides of a road tile the road can enter or leave by
+    enum class Side { None, North, South, East, West };
+
     CTileRoad(CTowersGame* game);
 
     ///  Default constructor (disabled)
@@ -54,44 +59,84 @@ public:
      */
     bool IsStartTile() { return mStartTile; };
 
-    virtual void Draw(Gdiplus::Graphics* graphics);
+    /**
+     * Gets the direction balloons travel from the start tile
+     * @returns True if balloons travel the tile forwards
+     */
+    bool IsStartForward() const { return mStartDirection; }
 
-    virtual void RenderEntities(Gdiplus::Graphics* graphics);
+    /**
+     * The side the road enters this tile by
+     * @param reverse True if travelling the tile backwards
+     * @returns Entry side
+     */
+    Side GetEntry(bool reverse) const { return reverse ? mExit : mEntry; }
 
-    int HitTestAllBalloons(int x, int y, double towerRadius, bool dartTower);
+    /**
+     * The side the road leaves this tile by
+     * @param reverse True if travelling the tile backwards
+     * @returns Exit side
+     */
+    Side GetExit(bool reverse) const { return reverse ? mEntry : mExit; }
 
-    void AcceptAllBalloons(CItemVisitor* visitor);
+    void AddToPath(CRoadPath* path, bool reverse);
 
-    void GenerateBalloon(double offsetX, double offsetY);
+    virtual void Draw(CRenderer* graphics);
 
-    void PlaceBalloon(std::shared_ptr<CBalloon> balloon);
+    virtual void RenderEntities(CRenderer* graphics);
 
-    void CTileRoad::ScheduleDelete(std::shared_ptr<CBalloon> balloon);
+    void AcceptAllBalloons(CItemVisitor* visitor);
 
-    void CTileRoad::ScheduleTransfer(std::shared_ptr<CBalloon> balloon);
+    /**
+     * Get the balloons travelling from this tile
+     * @returns Vector of balloons
+     */
+    const std::vector<std::shared_ptr<CBalloon>>& GetBalloons() const { return mBalloons; }
 
     /**
-     * Sets whether this tile is the starter tile for the level 
-     * @param isStarter true = Is a starter road : false = Is not a starter road
+     * Get the moving state of the balloons travelling from this tile
+     * @returns Store indexed the same as GetBalloons
      */
-    void CTileRoad::SetStarterRoad(bool isStarter) { mStarterRoad = isStarter; }
+    CBalloonStore& GetBalloonStore() { return mStore; }
 
+    CBalloon::Handle GenerateBalloon(double offsetX, double offsetY);
 
-private:
+    CBalloon* GetBalloon(CBalloon::Handle handle) const;
 
-    void CTileRoad::DetermineTileProgression(std::shared_ptr<CBalloon> balloon);
+    void PlaceBalloon(CBalloon* balloon);
 
-    void PlaceBalloonNW(std::shared_ptr<CBalloon> balloon);
+    void ScheduleDelete(CBalloon* balloon);
 
-    void PlaceBalloonSE(std::shared_ptr<CBalloon> balloon);
+    void PopBalloon(CBalloon* balloon);
 
-    void PlaceBalloonSW(std::shared_ptr<CBalloon> balloon);
+    void RetireBalloons();
 
-    void PlaceBalloonEW(std::shared_ptr<CBalloon> balloon);
+    /**
+     * Sets whether this tile is the starter tile for the level 
+     * @param isStarter true = Is a starter road : false = Is not a starter road
+     */
+    void SetStarterRoad(bool isStarter) { mStarterRoad = isStarter; }
+
+    /**
+     * Set how many balloons this tile generates once the level starts
+     * @param count Number of balloons
+     * @param interval Simulated seconds between balloons
+     */
+    void SetBalloonsToGenerate(int count, double interval) { mNumToGenerate = count; mGenerateInterval = interval; }
+
+
+private:
 
-    void PlaceBalloonNS(std::shared_ptr<CBalloon> balloon);
+    /// Where a balloon handle's slot points
+    struct Slot
+    {
+        unsigned int mGeneration = 1;   ///< Generation of the balloon in the slot, or of the next one
+        int mIndex = -1;                ///< Index of the balloon in mBalloons, -1 if the slot is free
+    };
 
-    void PlaceBalloonNE(std::shared_ptr<CBalloon> balloon);
+    void SidePoint(Side side, double& x, double& y);
+
+    void RemoveBalloon(size_t index);
 
     /// Indicates if this tile will be the spawner of balloons
     bool mStartTile = false; 
@@ -102,26 +147,40 @@ private:
      */
     bool mStartDirection = false;
 
-    /// List of balloons
+    /// List of balloons travelling the road from this start tile
     std::vector<std::shared_ptr<CBalloon>> mBalloons;    
 
-    /// List of balloons to delete
-    std::vector<std::shared_ptr<CBalloon>> mBalloonsToDelete; 
+    /// Moving state of the balloons, indexed the same as mBalloons
+    CBalloonStore mStore;
+
+    /// Slots balloon handles refer to, each pointing into mBalloons
+    std::vector<Slot> mSlots;
 
-    /// List of balloons to trasnfer to a new tile
-    std::vector<std::shared_ptr<CBalloon>> mBalloonsToTransfer; 
+    /// Slots free for the next balloons
+    std::vector<unsigned int> mFreeSlots;
+
+    /// Number of balloons popped or deleted and not yet retired
+    int mDead = 0;
 
     /// The type of road object it is
     std::wstring mType = L"NS"; 
 
+    /// Side the road enters by when travelled forwards
+    Side mEntry = Side::North;
+
+    /// Side the road leaves by when travelled forwards
+    Side mExit = Side::South;
+
     /// Time to generate next balloon
     double mTimeToGenerate = 0;
 
     /// Total number of balloons to generate
     int mNumToGenerate = 30;
 
+    /// Simulated seconds between generated balloons
+    double mGenerateInterval = 0.5;
+
     /// Bool to determine starter road
     bool mStarterRoad = false;
 
 };
-
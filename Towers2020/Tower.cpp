@@ -12,7 +12,6 @@
 #include "Tower.h"
 
 using namespace std;
-using namespace Gdiplus;
 
 /** 
  * Constructor
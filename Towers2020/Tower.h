@@ -48,7 +48,7 @@ public:
  	 * Method used to call all entity render functions that a tower may own.
 	 * @param graphics The graphics object
 	 */
-	virtual void RenderEntities(Gdiplus::Graphics* graphics) = 0;
+	virtual void RenderEntities(CRenderer* graphics) = 0;
 private:
 	/** 
 	 * Determines if a tower is placed on a tile (stationary). 
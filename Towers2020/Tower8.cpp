@@ -10,9 +10,9 @@
 
 #include "pch.h"
 #include "Tower8.h"
+#include "Trace.h"
 #include <math.h>
 using namespace std;
-using namespace Gdiplus;
 
 /// Default image
 const wstring EmptyImage = L"tower8.png";
@@ -24,11 +24,13 @@ const wstring EmptyImage = L"tower8.png";
 CTower8::CTower8(CTowersGame* item) : CTower(item)
 {
 	SetImage(EmptyImage);
+	mDarts.reserve(8);
 }
 
-/// Default Destructor
+/// Destructor
 CTower8::~CTower8()
 {
+	ReleaseDarts();
 }
 
 /** 
@@ -61,7 +63,7 @@ void CTower8::GenerateAllDarts()
  */
 void CTower8::GenerateDart(double offsetX, double offsetY, double sector)
 {
-	auto dart = make_shared<CDart>(GetGame());
+	auto dart = GetGame()->GetDartPool().Acquire();
 	dart->setXOffset(offsetX);
 	dart->setYOffset(offsetY);
 	dart->SetLocation(GetX() + dart->GetXOffset(), GetY() + dart->GetYOffset());
@@ -69,10 +71,25 @@ void CTower8::GenerateDart(double offsetX, double offsetY, double sector)
 	mDarts.push_back(dart);
 }
 
+/**
+ * Give all of the tower's darts back to the game's dart pool
+ */
+void CTower8::ReleaseDarts()
+{
+	for (auto dart : mDarts)
+	{
+		GetGame()->GetDartPool().Release(dart);
+	}
+
+	mDarts.clear();
+}
+
 /** Function that controls/initiates the attack sequence of a tower. 
  */
 void CTower8::Attack()
 {
+	TOWERS_TRACE_SPAN("CTower8::Attack");
+
 	GenerateAllDarts();
 }
 
@@ -108,7 +125,7 @@ void CTower8::Update(double elapsed)
 
 		if (dartRadius >= 100) 
 		{
-			mDarts.clear();
+			ReleaseDarts();
 		}
 
 		int collide = GetGame()->CollisionCheck(GetX(), GetY(), dartRadius, true);
@@ -124,7 +141,7 @@ void CTower8::Update(double elapsed)
  * Draw this item
  * @param graphics The graphics context to draw on 
  */
-void CTower8::Draw(Gdiplus::Graphics* graphics)
+void CTower8::Draw(CRenderer* graphics)
 {
 	CItem::Draw(graphics);
 
@@ -134,7 +151,7 @@ void CTower8::Draw(Gdiplus::Graphics* graphics)
  * Method used to call all dart render functions.
  * @param graphics The graphics object
  */
-void CTower8::RenderEntities(Gdiplus::Graphics* graphics)
+void CTower8::RenderEntities(CRenderer* graphics)
 {
 	for (auto dart : mDarts)
 	{
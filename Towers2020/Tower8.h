@@ -44,13 +44,15 @@ public:
 
     virtual void Update(double elapsed) override;
 
-    virtual void Draw(Gdiplus::Graphics* graphics);
+    virtual void Draw(CRenderer* graphics);
 
-    virtual void RenderEntities(Gdiplus::Graphics* graphics);
+    virtual void RenderEntities(CRenderer* graphics);
 
 private:
-    /// Dart entities owned by the tower
-	std::vector<std::shared_ptr<CDart>> mDarts;
+    void ReleaseDarts();
+
+    /// Dart entities fired by the tower, from the game's dart pool
+	std::vector<CDart*> mDarts;
 
     /// The time until the tower fires
 	double mTimeTofire = 5;
@@ -10,9 +10,9 @@
 
 #include "pch.h"
 #include "TowerAirship.h"
+#include "Trace.h"
 #include <math.h>
 using namespace std;
-using namespace Gdiplus;
 
 /// Default image
 const wstring EmptyImage = L"tower-airship.png";
@@ -24,11 +24,14 @@ const wstring EmptyImage = L"tower-airship.png";
 CTowerAirship::CTowerAirship(CTowersGame* item) : CTower(item)
 {
 	SetImage(EmptyImage);
+	mDarts.reserve(8);
 }
 
 /// Destructor
 CTowerAirship::~CTowerAirship()
 {
+	ReleaseDarts();
+	GetGame()->GetAirshipPool().Release(mAirship);
 }
 
 /** Generates the airship. 
@@ -36,7 +39,8 @@ CTowerAirship::~CTowerAirship()
 void CTowerAirship::GenerateAirship()
 {
 	double offsetX = -10, offsetY = 0, sector = 0;
-	mAirship = make_shared<CAirship>(GetGame());
+	GetGame()->GetAirshipPool().Release(mAirship);
+	mAirship = GetGame()->GetAirshipPool().Acquire();
 	mAirship->setXOffset(offsetX);
 	mAirship->setYOffset(offsetY);
 	mAirship->SetLocation(GetX() + mAirship->GetXOffset(), GetY() + mAirship->GetYOffset());
@@ -51,7 +55,7 @@ void CTowerAirship::GenerateAirship()
  */
 void CTowerAirship::GenerateDart(double offsetX, double offsetY, double sector)
 {
-	auto dart = make_shared<CDart>(GetGame());
+	auto dart = GetGame()->GetDartPool().Acquire();
 	dart->setXOffset(offsetX);
 	dart->setYOffset(offsetY);
 	dart->SetLocation(GetX() + dart->GetXOffset() - 170, GetY() + dart->GetYOffset());
@@ -81,10 +85,25 @@ void CTowerAirship::GenerateAllDarts()
 	GenerateDart(10, -10, 7); // Generate NorthEastbound dart
 }
 
+/**
+ * Give all of the airship's darts back to the game's dart pool
+ */
+void CTowerAirship::ReleaseDarts()
+{
+	for (auto dart : mDarts)
+	{
+		GetGame()->GetDartPool().Release(dart);
+	}
+
+	mDarts.clear();
+}
+
 /** Controls/initiates the attack sequence of a tower. 
  */
 void CTowerAirship::Attack()
 {
+	TOWERS_TRACE_SPAN("CTowerAirship::Attack");
+
 	GenerateAirship();
 	mAirshipDraw = true;
 }
@@ -144,7 +163,7 @@ void CTowerAirship::Update(double elapsed)
 			}
 			if (!mAirshipDraw)
 			{
-				mDarts.clear();
+				ReleaseDarts();
 
 				mDrawDarts= false;
 			}
@@ -162,7 +181,7 @@ void CTowerAirship::Update(double elapsed)
  * Draw this item
  * @param graphics The graphics context to draw on 
  */
-void CTowerAirship::Draw(Gdiplus::Graphics* graphics)
+void CTowerAirship::Draw(CRenderer* graphics)
 {
 	CItem::Draw(graphics);
 
@@ -172,7 +191,7 @@ void CTowerAirship::Draw(Gdiplus::Graphics* graphics)
  * Method used to call all dart render functions
  * @param graphics The graphics object
  */
-void CTowerAirship::RenderEntities(Gdiplus::Graphics* graphics)
+void CTowerAirship::RenderEntities(CRenderer* graphics)
 {
 	if (mAirship != nullptr && mAirshipDraw)
 	{
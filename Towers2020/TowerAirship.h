@@ -43,20 +43,22 @@ public:
 
 	virtual void Update(double elapsed) override;
 
-	virtual void Draw(Gdiplus::Graphics* graphics);
+	virtual void Draw(CRenderer* graphics);
 
-	virtual void RenderEntities(Gdiplus::Graphics* graphics);
+	virtual void RenderEntities(CRenderer* graphics);
 
 	void GenerateDart(double offsetX, double offsetY, double radians);
 
 	void GenerateAllDarts();
 
 private:
-	/// Dart entities owned by the tower
-	std::vector<std::shared_ptr<CDart>> mDarts;  
+	void ReleaseDarts();
 
-	/// The airship collection
-	std::shared_ptr<CAirship> mAirship;
+	/// Dart entities dropped by the airship, from the game's dart pool
+	std::vector<CDart*> mDarts;  
+
+	/// The airship, from the game's airship pool, nullptr before the first attack
+	CAirship* mAirship = nullptr;
 
 	/// Double for time to fire
 	double mTimeTofire = 7;  
@@ -10,13 +10,13 @@
 
 #include "pch.h"
 #include "TowerBomb.h"
+#include "Trace.h"
 
 using namespace std;
 
 /// Default image
 const wstring EmptyImage = L"tower-bomb.png";
 
-using namespace Gdiplus;
 
 /** 
  * Constructor
@@ -27,10 +27,7 @@ CTowerBomb::CTowerBomb(CTowersGame* item) : CTower(item)
 	mCircleX = this->GetX();
 	mCircleY = this->GetY();
 	SetImage(EmptyImage);
-	CBombCounter visitor;
-	auto TowersGame = GetGame();
-	TowersGame->Accept(&visitor);
-	int numOfBombs = visitor.GetNumberOfBombs();
+	int numOfBombs = GetGame()->GetRegistry().GetTowerCount(CItemRegistry::TowerKind::Bomb);
 	//adds 3 seconds to explosion time for each bomb in the game
 	mTimeToExplode = mTimeToExplode + (3 * numOfBombs);
 }
@@ -71,6 +68,8 @@ void CTowerBomb::Update(double elapsed)
  */
 void CTowerBomb::Attack()
 {
+	TOWERS_TRACE_SPAN("CTowerBomb::Attack");
+
 	// Set the new drawing location of the circle up and to the left
 
 	mCircleX -= 100; // Adding X sets an object left on screen
@@ -100,7 +99,7 @@ void CTowerBomb::Attack()
  * Draw this item
  * @param graphics The graphics context to draw on 
  */
-void CTowerBomb::Draw(Gdiplus::Graphics* graphics)
+void CTowerBomb::Draw(CRenderer* graphics)
 {
 	if (mBlownUp)
 	{
@@ -114,23 +113,23 @@ void CTowerBomb::Draw(Gdiplus::Graphics* graphics)
  * Method Disabled (no entities are drawn on/in bomb entities)
  * @param graphics The graphics 
  */
-void CTowerBomb::RenderEntities(Gdiplus::Graphics* graphics)
+void CTowerBomb::RenderEntities(CRenderer* graphics)
 {
 	if (!mBlownUp) 
 	{
 		// Create pen.
-		SolidBrush redPen(Color(128, 0, 0));
-		SolidBrush middlePen(Color(140, 20, 0));
-		SolidBrush innerPen(Color(140, 60, 20));
+		CRenderer::Color redPen(128, 0, 0);
+		CRenderer::Color middlePen(140, 20, 0);
+		CRenderer::Color innerPen(140, 60, 20);
 
 		// 1. The circle must be within an acceptable radius
 		// 2. The tower must be placed
 		// 3. The game must be started (go button pressed)
 		if (mDrawCircle && GetIsPlaced() && GetGame()->GetGoButtonPressed() && mShow)
 		{
-			graphics->FillEllipse(&redPen, mCircleX, mCircleY, mBombDiameter, mBombDiameter);
-			graphics->FillEllipse(&middlePen, (mCircleX-GetX())*2/3 + GetX(), (mCircleY-GetY())*2/3 + GetY(), mBombDiameter*2/3, mBombDiameter*2/3);
-			graphics->FillEllipse(&innerPen, (mCircleX - GetX()) / 3 + GetX(), (mCircleY - GetY()) / 3 + GetY(), mBombDiameter / 3, mBombDiameter / 3);
+			graphics->FillEllipse(mCircleX, mCircleY, mBombDiameter, mBombDiameter, redPen);
+			graphics->FillEllipse((mCircleX-GetX())*2/3 + GetX(), (mCircleY-GetY())*2/3 + GetY(), mBombDiameter*2/3, mBombDiameter*2/3, middlePen);
+			graphics->FillEllipse((mCircleX - GetX()) / 3 + GetX(), (mCircleY - GetY()) / 3 + GetY(), mBombDiameter / 3, mBombDiameter / 3, innerPen);
 		}
 	}
 	
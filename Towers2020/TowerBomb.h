@@ -9,7 +9,6 @@
 
 #pragma once
 #include "Tower.h"
-#include "BombCounter.h"
 #include "TowersGame.h"
 
  /**
@@ -39,7 +38,7 @@ public:
      */
     virtual void Accept(CItemVisitor* visitor) override { visitor->VisitTowerBomb(this); }
 
-    virtual void Draw(Gdiplus::Graphics* graphics);
+    virtual void Draw(CRenderer* graphics);
 
     /**
      * Method to set the time to explode
@@ -53,7 +52,7 @@ public:
      */
     bool GetBlownUp() { return mBlownUp;  }
 
-    virtual void RenderEntities(Gdiplus::Graphics* graphics) override;
+    virtual void RenderEntities(CRenderer* graphics) override;
 
 
 private:
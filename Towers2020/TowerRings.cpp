@@ -10,6 +10,7 @@
 
 #include "pch.h"
 #include "TowerRings.h"
+#include "Trace.h"
 
 using namespace std;
 
@@ -63,6 +64,8 @@ void CTowerRings::Update(double elapsed)
  */
 void CTowerRings::Attack()
 {
+	TOWERS_TRACE_SPAN("CTowerRings::Attack");
+
 	if (mDrawCircle)
 	{
 		int collide = GetGame()->CollisionCheck(GetX(), GetY(), mCircleDiameter/2, false);
@@ -96,26 +99,24 @@ void CTowerRings::Attack()
  * Renders the ring of the tower
  * @param graphics The graphics object
  */
-void CTowerRings::RenderEntities(Gdiplus::Graphics* graphics)
+void CTowerRings::RenderEntities(CRenderer* graphics)
 {
-	// Create pen.
-	Pen redPen(Color(255, 250, 20, 2));
-
-	redPen.SetWidth(3.0F);
+	// Pen color
+	CRenderer::Color red(250, 20, 2);
 
 	// 1. The circle must be within an acceptable radius
 	// 2. The tower must be placed
 	// 3. The game must be started (go button pressed)
 	if (mDrawCircle && GetIsPlaced() && GetGame()->GetGoButtonPressed())
 	{
-		graphics->DrawEllipse(&redPen, mCircleX, mCircleY, mCircleDiameter, mCircleDiameter);
+		graphics->DrawEllipse(mCircleX, mCircleY, mCircleDiameter, mCircleDiameter, red, 3.0);
 	}
 }
 
 /** Draw this item
  * @param graphics The graphics context to draw on 
  */
-void CTowerRings::Draw(Gdiplus::Graphics* graphics)
+void CTowerRings::Draw(CRenderer* graphics)
 {
 	CItem::Draw(graphics);
 }
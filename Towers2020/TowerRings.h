@@ -12,7 +12,6 @@
 #include "Tower.h"
 
 
-using namespace Gdiplus;
 
  /**
   *  Implements a simple tower we can manipulate
@@ -38,7 +37,7 @@ public:
      */
     virtual void Accept(CItemVisitor* visitor) override { visitor->VisitTowerRings(this); }
 
-    virtual void Draw(Gdiplus::Graphics* graphics);
+    virtual void Draw(CRenderer* graphics);
 
     virtual void Attack() override;
 
@@ -54,7 +53,7 @@ public:
      */
     bool GetAttacking() const { return mAttacking; }
 
-    virtual void RenderEntities(Gdiplus::Graphics* graphics) override;
+    virtual void RenderEntities(CRenderer* graphics) override;
 
 
 private:
@@ -9,6 +9,8 @@
 #include "afxdialogex.h"
 #include "Towers2020.h"
 #include "MainFrm.h"
+#include "ImageCache.h"
+#include "GdiplusImage.h"
 
 #ifdef _DEBUG
 #define new DEBUG_NEW
@@ -65,6 +67,7 @@ BOOL CTowers2020App::InitInstance()
 
 	CWinApp::InitInstance();
 	Gdiplus::GdiplusStartup(&gdiplusToken, &gdiplusStartupInput, NULL);
+	CImageCache::Instance().SetLoader(std::make_shared<CGdiplusImageLoader>());
 
 
 	// Initialize OLE libraries
@@ -114,6 +117,8 @@ BOOL CTowers2020App::InitInstance()
 
 int CTowers2020App::ExitInstance()
 {
+	// Cached bitmaps must be released while GDI+ is still running
+	CImageCache::Instance().Clear();
 	Gdiplus::GdiplusShutdown(gdiplusToken);
 
 	//TODO: handle additional resources you may have added
@@ -14,6 +14,8 @@
 #include <vector>
 #include <map>
 #include <utility>
+#include <unordered_set>
+#include <iostream>
 #include "TowersGame.h"
 #include "TileTrees.h"
 #include "TileHouse.h"
@@ -25,12 +27,17 @@
 #include "ScoreCounter.h"
 #include "ConfigureRoad.h"
 #include "CanMoveVisitor.h"
+#include "DiagVisitor.h"
+#include "Tower8.h"
+#include "TowerBomb.h"
+#include "TowerRings.h"
+#include "TowerAirship.h"
 #include "Balloon.h"
 #include "GoButton.h"
 #include "FindBalloon.h"
-#include "RoadCollector.h"
+#include "Profiler.h"
+#include "Trace.h"
 using namespace std;
-using namespace Gdiplus;
 using namespace xmlnode;
 
 /// Game area width in virtual pixels
@@ -39,6 +46,36 @@ const static int Width = 1224;
 /// Game area height in virtual pixels
 const static int Height = 1024;
 
+/// X location of the palette, anything to the right of this is on it
+const static double PaletteEdge = 1024;
+
+/// X Location for every tower on the palette
+const static double PaletteX = 1150;
+
+/// Y Location for the Ring Tower on the palette
+const static double PaletteYTowerRings = 80;
+
+/// Y Location for the Tower 8 on the palette
+const static double PaletteYTower8 = 180;
+
+/// Y Location for the Bomb Tower on the palette
+const static double PaletteYTowerBomb = 280;
+
+/// Y Location for the Airship Tower on the palette
+const static double PaletteYTowerAirship = 380;
+
+/// X location of the profiler overlay
+const static double ProfilerX = 16;
+
+/// Y location of the profiler overlay
+const static double ProfilerY = 16;
+
+/// Balloons in a level that does not say how many
+const static int DefaultLevelBalloons = 30;
+
+/// Seconds between balloons in a level that does not say
+const static double DefaultBalloonInterval = 0.5;
+
 /// Constructor
 CTowersGame::CTowersGame()
 {
@@ -55,6 +92,12 @@ CTowersGame::~CTowersGame()
 void CTowersGame::Add(shared_ptr<CItem> item)
 {
 	mItems.push_back(item);
+	mRegistry.Add(item);
+
+	if (item->IsStatic())
+	{
+		TilesChanged();
+	}
 }
 
 /**
@@ -98,76 +141,159 @@ void CTowersGame::MoveToFront(shared_ptr<CItem> item)
 
 /**
  * Draw the game area
- * @param graphics The GDI+ graphics context to draw on
+ * @param graphics The renderer to draw with
  * @param width Width of the client window
  * @param height Height of the client window
+ * @param alpha Fraction of a simulation step since the last update,
+ *        0 draws everything where the last update left it
  */
-void CTowersGame::OnDraw(Graphics* graphics, int width, int height)
+void CTowersGame::OnDraw(CRenderer* graphics, int width, int height, double alpha)
 {
-    // Fill the background with black
-    SolidBrush brush(Color::Black);
-    graphics->FillRectangle(&brush, 0, 0, width, height);
-
+    CProfileScope profile(CProfiler::Draw);
+    TOWERS_TRACE_SPAN("OnDraw");
 
     // automatic scaling
     mDrawWidth = width;
     mDrawHeight = height;
 
-    graphics->TranslateTransform(mXOffset, mYOffset);
-    graphics->ScaleTransform(mScale, mScale);
+    // The background and tiles come from the tile layer when the renderer has layers
+    if (!DrawTileLayer(graphics))
+    {
+        // Fill the background with black
+        graphics->FillRectangle(0, 0, width, height, CRenderer::Color(0, 0, 0));
 
+        graphics->SetTransform(mXOffset, mYOffset, mScale);
+        for (auto& item : mItems)
+        {
+            if (item->IsStatic())
+            {
+                item->Draw(graphics);
+            }
+        }
+    }
 
-    // Draw the score
-    
-    FontFamily fontFamily(L"Arial");
-    Gdiplus::Font stringFont(&fontFamily, 30);
-    Gdiplus::Font counterFont(&fontFamily, 40);
+    DrawDynamic(graphics, alpha);
+}
+
+/**
+ * Draw everything above the background and static tiles.
+ *
+ * This is what can change from frame to frame. Besides being
+ * part of OnDraw, a window can draw it through a CDirtyTracker
+ * to find which parts of the window need painting again.
+ * @param graphics The renderer to draw with
+ * @param alpha Fraction of a simulation step since the last update,
+ *        0 draws everything where the last update left it
+ */
+void CTowersGame::DrawDynamic(CRenderer* graphics, double alpha)
+{
+    mDrawAlpha = alpha;
+
+    graphics->SetTransform(mXOffset, mYOffset, mScale);
 
 
-    SolidBrush yellow(Color(255, 255, 0));
-    graphics->DrawString(L"Score", -1,
-        &stringFont, PointF(1090, 500), &yellow);
+    // Draw the score
+
+    CRenderer::Color yellow(255, 255, 0);
+    graphics->DrawString(L"Score", 1090, 500, 30, yellow);
 
     // Draw the entire collection of top-level items (not including entities)
 
     for (auto item : mItems)
     {
-        item->Draw(graphics);
+        if (!item->IsStatic())
+        {
+            item->Draw(graphics);
+        }
     }
 
     wstring scoreValue = to_wstring(mGameScore);
 
-    graphics->DrawString(scoreValue.c_str(), -1,
-        &counterFont, PointF(1125, 550), &yellow);
+    graphics->DrawString(scoreValue, 1125, 550, 40, yellow);
 
-    // Renders entities above the top-level items
-    for (auto item : mItems)
+    // Renders entities above the top-level items. Only the pass that
+    // draws to the screen is timed, not the one finding what changed.
     {
-        item->RenderEntities(graphics);
+        CProfileScope entitiesProfile(CProfiler::RenderEntities, graphics->IsDrawing());
+        for (auto item : mItems)
+        {
+            item->RenderEntities(graphics);
+        }
     }
 
     if (mDrawLevelLabel)
     {
         wstring levelName = L"Level " + to_wstring(mCurrentLevel) + L" Begin";
 
-        FontFamily fontFamily(L"Arial");
-        Gdiplus::Font font(&fontFamily, 56);
-
-        SolidBrush brown(Color(140, 70, 70));
-        graphics->DrawString(levelName.c_str(), -1,
-            &font, PointF(240, 456), &brown);
+        CRenderer::Color brown(140, 70, 70);
+        graphics->DrawString(levelName, 240, 456, 56, brown);
     }
     else if (mDrawEndLabel)
     {
         wstring levelComplete = L"Level Complete!";
 
-        FontFamily fontFamily(L"Arial");
-        Gdiplus::Font font(&fontFamily, 56);
+        CRenderer::Color brown(140, 70, 70);
+        graphics->DrawString(levelComplete, 240, 456, 56, brown);
+    }
+
+    if (CProfiler::Instance().IsEnabled())
+    {
+        CProfiler::Instance().DrawOverlay(graphics, ProfilerX, ProfilerY);
+    }
+}
+
+/**
+ * Draw the background and static tiles from the tile layer.
+ *
+ * Tiles do not change during a level, so they are drawn into an
+ * offscreen layer once and that is copied to the window each frame.
+ * The layer is drawn again when a level loads or the window size
+ * or scale changes.
+ * @param graphics The renderer to draw with
+ * @returns False if the renderer has no layers, so nothing was drawn
+ */
+bool CTowersGame::DrawTileLayer(CRenderer* graphics)
+{
+    if (mTileLayer == nullptr || mTileLayerWidth != mDrawWidth || mTileLayerHeight != mDrawHeight ||
+        mTileLayerScale != mScale || mTileLayerXOffset != mXOffset || mTileLayerYOffset != mYOffset)
+    {
+        TOWERS_TRACE_SPAN("DrawTileLayer");
+
+        mTileLayer = graphics->CreateLayer(mDrawWidth, mDrawHeight);
+        if (mTileLayer == nullptr)
+        {
+            return false;
+        }
+
+        mTileLayerWidth = mDrawWidth;
+        mTileLayerHeight = mDrawHeight;
+        mTileLayerScale = mScale;
+        mTileLayerXOffset = mXOffset;
+        mTileLayerYOffset = mYOffset;
 
-        SolidBrush brown(Color(140, 70, 70));
-        graphics->DrawString(levelComplete.c_str(), -1,
-            &font, PointF(240, 456), &brown);
+        auto layer = mTileLayer->GetRenderer();
+        layer->FillRectangle(0, 0, mDrawWidth, mDrawHeight, CRenderer::Color(0, 0, 0));
+        layer->SetTransform(mXOffset, mYOffset, mScale);
+        for (auto& item : mItems)
+        {
+            if (item->IsStatic())
+            {
+                item->Draw(layer);
+            }
+        }
     }
+
+    graphics->DrawLayer(mTileLayer.get());
+    return true;
+}
+
+/**
+ * Note that the static tiles changed, so the tile layer must be drawn again
+ */
+void CTowersGame::TilesChanged()
+{
+    mTileLayer = nullptr;
+    mTileChanges++;
 }
 
 /** 
@@ -176,6 +302,12 @@ void CTowersGame::OnDraw(Graphics* graphics, int width, int height)
  */
 void CTowersGame::Update(double elapsed)
 {
+    CProfileScope profile(CProfiler::Update);
+    TOWERS_TRACE_SPAN("Update");
+
+    mTick++;
+    mGameTime += elapsed;
+
     //
     // Automatic Scaling
     //
@@ -190,13 +322,26 @@ void CTowersGame::Update(double elapsed)
     mYOffset = (float)((mDrawHeight - Height * mScale) / 2);
 
 
+    // Towers test against where the balloons were at the start of this update.
+    // The hash keeps those locations, so roads moving balloons first does not matter.
+    BuildBalloonHash();
+
    // CFindBalloon baloonVisitor;
 
-    for (auto item : mItems)
     {
-        item->Update(elapsed);
-        //item->Accept(&baloonVisitor);
-        //baloonVisitor.FindBalloon(); // Iterate through a CTileRoad object's collection
+        CProfileScope itemsProfile(CProfiler::ItemUpdate);
+        for (auto item : mItems)
+        {
+            item->Update(elapsed);
+            //item->Accept(&baloonVisitor);
+            //baloonVisitor.FindBalloon(); // Iterate through a CTileRoad object's collection
+        }
+    }
+
+    // Balloons popped this update leave the road before the next one
+    if (mStartRoad != nullptr)
+    {
+        mStartRoad->RetireBalloons();
     }
 
     // Used to determine if a level is over
@@ -204,7 +349,7 @@ void CTowersGame::Update(double elapsed)
     if (mNumBalloons == 0 && !mDrawLevelLabel && !mDrawEndLabel)
     {
         LevelComplete();
-        mNumBalloons = 30;
+        mNumBalloons = mLevelBalloons;
     }
 
     if (mDrawLevelLabel || mDrawEndLabel)
@@ -232,8 +377,11 @@ void CTowersGame::Update(double elapsed)
  */
 void CTowersGame::SortTiles()
 {
-    // sort using a lambda expression 
-    sort(::begin(mItems), ::end(mItems),
+    TOWERS_TRACE_SPAN("SortTiles");
+
+    // sort using a lambda expression, items sharing a location
+    // keep their order so a tower stays above its tile
+    stable_sort(::begin(mItems), ::end(mItems),
         [](const shared_ptr<CItem>& a, const shared_ptr<CItem>& b) {
             if (a->GetY() < b->GetY())
                 return true;
@@ -273,27 +421,53 @@ shared_ptr<CItem> CTowersGame::GetAdjacent(CItem* item, int dx, int dy)
     int atX = (item->GetX() + 16) / GridSpacing + dx;
     int atY = (item->GetY() - 32) / GridSpacing + dy;
 
-    auto adj = mAdjacency.find(pair<int, int>(atX, atY));
-    if (adj != mAdjacency.end())
+    int index = mAdjacency.Find(atX, atY);
+    if (index != CTileGrid::NoTile)
     {
         // We found it
-        return adj->second;
+        return mGridTiles[index];
     }
 
-
     // If nothing found
     return nullptr; 
 }
 
+/**
+ *  Get any adjacent tile without sharing ownership of it.
+ *
+ * @param item Tile to test
+ * @param dx Left/right determination, -1=left, 1=right
+ * @param dy Up/Down determination, -1=up, 1=down
+ * @returns Adjacent tile or nullptr if none.
+ */
+CItem* CTowersGame::GetAdjacentTile(const CItem* item, int dx, int dy)
+{
+    int atX = (item->GetX() + 16) / GridSpacing + dx;
+    int atY = (item->GetY() - 32) / GridSpacing + dy;
+
+    int index = mAdjacency.Find(atX, atY);
+    return index != CTileGrid::NoTile ? mGridTiles[index].get() : nullptr;
+}
+
+/**  Load a level chosen by the player.
+ *
+ * @param filename The filename of the file to load the level from.
+ */
+void CTowersGame::Load(const wstring& filename)
+{
+    Record(CReplay::Type::Load, 0, 0, filename);
+    LoadLevel(filename);
+}
+
 /**  Load the city from a .city XML file.
  *
  * Opens the XML file and reads the nodes, creating items as appropriate.
  *
  * @param filename The filename of the file to load the city from.
  */
-void CTowersGame::Load(const wstring& filename)
+void CTowersGame::LoadLevel(const wstring& filename)
 {
-    mNumBalloons = 30; // 30 balloons at start of level
+    TOWERS_TRACE_SPAN("Load");
 
 
     // We surround with a try/catch to handle errors
@@ -305,6 +479,15 @@ void CTowersGame::Load(const wstring& filename)
         // Once we know it is open, clear the existing data
         Clear();
 
+        // The level size bounds the adjacency grid
+        mLevelWidth = root->GetAttributeIntValue(L"width", 0);
+        mLevelHeight = root->GetAttributeIntValue(L"height", 0);
+
+        // How many balloons the level sends and how quickly
+        mLevelBalloons = root->GetAttributeIntValue(L"balloons", DefaultLevelBalloons);
+        mBalloonInterval = root->GetAttributeDoubleValue(L"balloon-interval", DefaultBalloonInterval);
+        mNumBalloons = mLevelBalloons;
+
         //
         // Traverse the children of the root
         // node of the XML document in memory!!!!
@@ -312,7 +495,7 @@ void CTowersGame::Load(const wstring& filename)
         for (auto node : root->GetChildren())
         {
             // root -> (Declarations node)
-            if (node->GetType() == NODE_ELEMENT && node->GetName() == L"declarations")
+            if (node->GetType() == NodeType::Element && node->GetName() == L"declarations")
             {
                 for (auto node2 : node->GetChildren())
                 {
@@ -322,7 +505,7 @@ void CTowersGame::Load(const wstring& filename)
 
             }
             // root -> (Items node)
-            else if (node->GetType() == NODE_ELEMENT && node->GetName() == L"items")
+            else if (node->GetType() == NodeType::Element && node->GetName() == L"items")
             {
                 for (auto node2 : node->GetChildren())
                 {
@@ -337,17 +520,25 @@ void CTowersGame::Load(const wstring& filename)
         //
         SortTiles();
 
+        AddPalette();
+
     }
-    catch (CXmlNode::Exception ex)
+    catch (const CXmlNode::Exception& ex)
     {
-        AfxMessageBox(ex.Message().c_str());
+        ShowMessage(ex.Message());
     }
 
-    // file name as string
-    const std::string s(filename.begin(), filename.end());
-
-    mCurrentLevel = stoi(s.substr(12, 1)); // Get level num
-    mLevelStartTime = time(NULL); //gets current time
+    // The level number is the digit after "level" in the file name,
+    // files named anything else count as level 0
+    size_t slash = filename.find_last_of(L"/\\");
+    size_t level = filename.find(L"level", slash == wstring::npos ? 0 : slash + 1);
+    mCurrentLevel = 0;
+    if (level != wstring::npos && level + 5 < filename.size() &&
+        filename[level + 5] >= L'0' && filename[level + 5] <= L'9')
+    {
+        mCurrentLevel = filename[level + 5] - L'0';
+    }
+    mLevelStartTime = mGameTime;
     mDrawLevelLabel = true; // Draw Label on load
 }
 
@@ -358,6 +549,8 @@ void CTowersGame::Load(const wstring& filename)
  */
 void CTowersGame::XmlItem(const shared_ptr<CXmlNode>& node)
 {
+    TOWERS_TRACE_SPAN("XmlItem");
+
     // A pointer for the item we are loading
     shared_ptr<CItem> item;
 
@@ -380,6 +573,11 @@ void CTowersGame::XmlItem(const shared_ptr<CXmlNode>& node)
     {
         item = make_shared<CTileTrees>(this);
     }
+    else if (name == L"tower") // Towers placed by the level
+    {
+        XmlTower(node);
+        return;
+    }
 
     name = node->GetAttributeValue(L"id", L"");
 
@@ -397,6 +595,53 @@ void CTowersGame::XmlItem(const shared_ptr<CXmlNode>& node)
     }
 }
 
+/**
+ * Loads a tower the level places before the game starts.
+ *
+ * A tower node gives its type (tower8, bomb, rings or airship) and
+ * its tile location. Towers draw with their own images, so they
+ * need no declaration.
+ * @param node The tower node
+ */
+void CTowersGame::XmlTower(const shared_ptr<CXmlNode>& node)
+{
+    wstring type = node->GetAttributeValue(L"type", L"");
+
+    int key = 0;
+    if (type == L"tower8")
+    {
+        key = 1;
+    }
+    else if (type == L"bomb")
+    {
+        key = 2;
+    }
+    else if (type == L"rings")
+    {
+        key = 3;
+    }
+    else if (type == L"airship")
+    {
+        key = 4;
+    }
+
+    auto tower = CreateTower(key);
+    if (tower == nullptr)
+    {
+        return;
+    }
+
+    // Same conversion from tiles to virtual pixels as the tiles themselves
+    tower->SetLocation(node->GetAttributeIntValue(L"x", 0) * GridSpacing - 16,
+        node->GetAttributeIntValue(L"y", 0) * GridSpacing + 32);
+
+    CCanMoveVisitor visitor;
+    tower->Accept(&visitor);
+    visitor.PlaceTower();
+
+    Add(tower);
+}
+
 /**
  * Stores blueprints of individual objects specified by the
  * Declarations section of the xml document.
@@ -435,24 +680,17 @@ void CTowersGame::PressGoButton(shared_ptr<CItem> item)
  */
 void CTowersGame::StartLevel(int difficulty)
 {
-    CConfigureRoad roadVisitor;
-
     // Finds the start tile 
-
-    for (auto item : mItems)
+    auto road = mRegistry.GetStartRoad();
+    if (road != nullptr)
     {
-        item->Accept(&roadVisitor);
-        if (roadVisitor.IsStartTile() && roadVisitor.IsRoad())
-        {
-            mRoadStart = item;
-            if (roadVisitor.GetRoad() != nullptr) 
-            {
-                roadVisitor.SetStarterRoad();
-            }
-            
-            //roadVisitor.TestRoad();
-        }
+        mRoadStart = road;
+        mStartRoad = road.get();
+        mStartRoad->SetStarterRoad(true);
+        mStartRoad->SetBalloonsToGenerate(mLevelBalloons, mBalloonInterval);
     }
+
+    CompileRoadPath();
     
     if (difficulty == 0)
     {
@@ -460,6 +698,84 @@ void CTowersGame::StartLevel(int difficulty)
     }
 }
 
+/**
+ * Compile the road from the start tile into a single path.
+ *
+ * Walks the road tiles from the start tile, following each exit to
+ * the adjacent tile, until the road leaves the level or reaches a
+ * tile that does not connect back to it.
+ */
+void CTowersGame::CompileRoadPath()
+{
+    mRoadPath.Clear();
+
+    CTileRoad* road = mStartRoad;
+    bool reverse = road != nullptr && !road->IsStartForward();
+    unordered_set<CTileRoad*> visited;
+
+    while (road != nullptr && visited.insert(road).second)
+    {
+        road->AddToPath(&mRoadPath, reverse);
+
+        // Find the tile on the other side of the exit and the side we enter it by
+        int dx = 0, dy = 0;
+        CTileRoad::Side entry = CTileRoad::Side::None;
+        switch (road->GetExit(reverse))
+        {
+        case CTileRoad::Side::North:
+            dy = -1;
+            entry = CTileRoad::Side::South;
+            break;
+
+        case CTileRoad::Side::South:
+            dy = 1;
+            entry = CTileRoad::Side::North;
+            break;
+
+        case CTileRoad::Side::East:
+            dx = 1;
+            entry = CTileRoad::Side::West;
+            break;
+
+        case CTileRoad::Side::West:
+            dx = -1;
+            entry = CTileRoad::Side::East;
+            break;
+
+        default:
+            return;
+        }
+
+        CItem* next = GetAdjacentTile(road, dx, dy);
+        if (next == nullptr)
+        {
+            return;
+        }
+
+        CConfigureRoad visitor;
+        next->Accept(&visitor);
+        road = visitor.GetRoad();
+        if (road == nullptr)
+        {
+            return;
+        }
+
+        if (road->GetEntry(false) == entry)
+        {
+            reverse = false;
+        }
+        else if (road->GetEntry(true) == entry)
+        {
+            reverse = true;
+        }
+        else
+        {
+            // The road does not connect to this side of the tile
+            return;
+        }
+    }
+}
+
 /** 
  * Clear the item data.
  * Deletes all known items in the game. 
@@ -467,10 +783,332 @@ void CTowersGame::StartLevel(int difficulty)
 void CTowersGame::Clear()
 {
     mItems.clear();
+    mRegistry.Clear();
     mDeclarations.clear();
+    mGridTiles.clear();
+    mAdjacency.Clear();
+    mLevelWidth = 0;
+    mLevelHeight = 0;
+    mRoadPath.Clear();
+    TilesChanged();
+    mRoadStart = nullptr;
+    mStartRoad = nullptr;
+    mBalloonHash.Clear();
+    mHitCandidates.clear();
     mGameStarted = false;
     mDrawNewLevelItems = true;
     mBalloonsInGame = false;
+    mGrabbedItem = nullptr;
+}
+
+/**
+ * Tell the player something through the host running the game.
+ *
+ * Without a host the message is written to the error stream.
+ * @param message The message to show
+ */
+void CTowersGame::ShowMessage(const wstring& message)
+{
+    if (mHost != nullptr)
+    {
+        mHost->ShowMessage(message);
+    }
+    else
+    {
+        wcerr << message << endl;
+    }
+}
+
+/**
+ * Ask the player a yes or no question through the host
+ * @param question The question to ask
+ * @param title Title for the question
+ * @returns True if the answer is yes, false if there is no host
+ */
+bool CTowersGame::AskYesNo(const wstring& question, const wstring& title)
+{
+    bool answer = mHost != nullptr && mHost->AskYesNo(question, title);
+    Record(CReplay::Type::Answer, answer ? 1 : 0);
+    return answer;
+}
+
+/**
+ * The player pressed the mouse button on the game.
+ *
+ * Presses the go button if that was clicked, otherwise picks up
+ * a tower that is free to move. Taking a tower from the palette
+ * puts a new one in its place.
+ * @param x X location in virtual pixels
+ * @param y Y location in virtual pixels
+ * @returns True if the player is now holding a tower
+ */
+bool CTowersGame::Grab(double x, double y)
+{
+    Record(CReplay::Type::Grab, x, y);
+
+    mGrabbedItem = HitTest(x, y);
+    if (mGrabbedItem == nullptr)
+    {
+        return false;
+    }
+
+    CDiagVisitor gobuttonvisitor;
+    mGrabbedItem->Accept(&gobuttonvisitor);
+
+    if (mDrawLevelLabel)
+    {
+        mGrabbedItem = nullptr;
+    }
+    else if (gobuttonvisitor.GetFindGoButton() && !mGameStarted)
+    {
+        PressGoButton(mGrabbedItem);
+        mGrabbedItem = nullptr;
+    }
+    else if (mGameStarted)
+    {
+        mGrabbedItem = nullptr;
+    }
+    else
+    {
+        // Accept a visitor to identify what type of object we have
+        CCanMoveVisitor visitor;
+        mGrabbedItem->Accept(&visitor);
+
+        // Only move if item is tower
+        if (visitor.GetIsTower() && visitor.GetIsOpen())
+        {
+            // A tower taken from the palette is replaced
+            if (x >= PaletteEdge)
+            {
+                AddPaletteTower(visitor.GetKey());
+            }
+
+            visitor.LiftTower(); // Lifts the tower to disable attacks
+            MoveToFront(mGrabbedItem);
+        }
+        else
+        {
+            mGrabbedItem = nullptr;
+        }
+    }
+
+    return mGrabbedItem != nullptr;
+}
+
+/**
+ * Move the tower the player is holding.
+ *
+ * Only where the tower is dropped matters to the game, so
+ * moves are not recorded.
+ * @param x X location in virtual pixels
+ * @param y Y location in virtual pixels
+ */
+void CTowersGame::Drag(double x, double y)
+{
+    if (mGrabbedItem != nullptr)
+    {
+        mGrabbedItem->SetLocation(x, y);
+    }
+}
+
+/**
+ * The player released the mouse button while holding a tower.
+ *
+ * The tower replaces a tower or takes open ground under it,
+ * otherwise it is thrown away.
+ * @param x X location in virtual pixels
+ * @param y Y location in virtual pixels
+ */
+void CTowersGame::Drop(double x, double y)
+{
+    if (mGrabbedItem == nullptr)
+    {
+        return;
+    }
+
+    Record(CReplay::Type::Drop, x, y);
+
+    // The item under the cursor (not being dragged)
+    mGrabbedItem->SetLocation(0, 0);
+    shared_ptr<CItem> tempItem = HitTest(x, y);
+
+    CCanMoveVisitor visitor, visitorTower; // create new visitor to check if tower
+
+    if (tempItem != nullptr)
+    {
+        tempItem->Accept(&visitor);
+        mGrabbedItem->Accept(&visitorTower);
+
+        if (visitor.GetIsTower())
+        {
+            // Someone placed a tower on one in the palette
+            if (x > PaletteEdge)
+            {
+                // Just delete the dragged tower. Do not replace a palette object
+                DeleteItem(mGrabbedItem);
+            }
+            else
+            {
+                DeleteItem(tempItem); // delete the existing tower
+                mGrabbedItem->SetLocation(tempItem->GetX(), tempItem->GetY()); // add the new tower on top of it
+                visitorTower.PlaceTower(); // Places the tower to enable attacks
+            }
+        }
+        else if (visitor.GetIsOpen())
+        {
+            mGrabbedItem->SetLocation(tempItem->GetX(), tempItem->GetY()); // place the tower on open ground
+            visitorTower.PlaceTower(); // Places the tower to enable attacks
+        }
+        else
+        {
+            DeleteItem(mGrabbedItem);
+        }
+    }
+    else
+    {
+        DeleteItem(mGrabbedItem);
+    }
+
+    mGrabbedItem = nullptr;
+}
+
+/**
+ * The player let go of the tower without dropping it on the game.
+ *
+ * The tower stays where it was last dragged, still lifted.
+ */
+void CTowersGame::CancelGrab()
+{
+    if (mGrabbedItem != nullptr)
+    {
+        Record(CReplay::Type::Cancel, mGrabbedItem->GetX(), mGrabbedItem->GetY());
+        mGrabbedItem = nullptr;
+    }
+}
+
+/**
+ * Put one of each tower on the palette
+ */
+void CTowersGame::AddPalette()
+{
+    AddPaletteTower(1);
+    AddPaletteTower(2);
+    AddPaletteTower(2);
+    AddPaletteTower(3);
+    AddPaletteTower(4);
+}
+
+/**
+ * Put a new tower on the palette
+ * @param key Tower type as reported by CCanMoveVisitor::GetKey,
+ *        1 = Tower8, 2 = TowerBomb, 3 = TowerRings, 4 = TowerAirship
+ */
+void CTowersGame::AddPaletteTower(int key)
+{
+    double y = 0;
+
+    switch (key)
+    {
+    case 1:
+        y = PaletteYTower8;
+        break;
+
+    case 2:
+        y = PaletteYTowerBomb;
+        break;
+
+    case 3:
+        y = PaletteYTowerRings;
+        break;
+
+    case 4:
+        y = PaletteYTowerAirship;
+        break;
+
+    default:
+        return;
+    }
+
+    auto tower = CreateTower(key);
+    tower->SetLocation(PaletteX, y);
+    Add(tower);
+}
+
+/**
+ * Create a tower of one of the palette types
+ * @param key 1 for Tower8, 2 for Bomb, 3 for Rings, 4 for Airship
+ * @returns The new tower, nullptr for an unknown key
+ */
+shared_ptr<CItem> CTowersGame::CreateTower(int key)
+{
+    switch (key)
+    {
+    case 1:
+        return make_shared<CTower8>(this);
+
+    case 2:
+        return make_shared<CTowerBomb>(this);
+
+    case 3:
+        return make_shared<CTowerRings>(this);
+
+    case 4:
+        return make_shared<CTowerAirship>(this);
+
+    default:
+        return nullptr;
+    }
+}
+
+/**
+ * Restart the game's random numbers from a seed
+ * @param seed Seed
+ */
+void CTowersGame::SetSeed(unsigned int seed)
+{
+    mSeed = seed;
+    mRandom.seed(seed);
+}
+
+/**
+ * Get the next random number for the game.
+ *
+ * Computed directly from the generator's output so the same seed
+ * gives the same numbers with any compiler or library.
+ * @returns Random number from 0 to 1
+ */
+double CTowersGame::Random()
+{
+    return mRandom() / double(mRandom.max());
+}
+
+/**
+ * Record player input from now on.
+ *
+ * Recording must start before the first update so the replay
+ * begins from a new game.
+ * @param replay Replay to record to, cleared first
+ */
+void CTowersGame::StartRecording(CReplay* replay)
+{
+    replay->Clear();
+    replay->SetSeed(mSeed);
+    mRecording = replay;
+}
+
+/**
+ * Record an input if recording
+ * @param type Kind of input
+ * @param x X location or answer
+ * @param y Y location
+ * @param text Filename for a load
+ */
+void CTowersGame::Record(CReplay::Type type, double x, double y, const wstring& text)
+{
+    if (mRecording != nullptr)
+    {
+        mRecording->Add(mTick, type, x, y, text);
+    }
 }
 
 /** 
@@ -521,38 +1159,72 @@ void CTowersGame::DeleteItem(shared_ptr<CItem> item)
     auto it = find(mItems.begin(), mItems.end(), item);
     int index = distance(mItems.begin(), it);
     mItems.erase(mItems.begin() + index);
+    mRegistry.Remove(item.get());
+
+    if (item->IsStatic())
+    {
+        TilesChanged();
+    }
 }
 
 /**
  *  Build support for fast adjacency testing.
  *
- * This builds a map of the grid locations of every tile, so we can 
- * just look them up.
+ * This builds a grid of the locations of every tile, so we can 
+ * just look them up. The grid is the size of the level when one
+ * has been loaded, otherwise it is fit to the items we have.
  */
 void CTowersGame::BuildAdjacencies()
 {
-    double oX, oY;
-    mAdjacency.clear();
-    for (auto item : mItems)
+    mGridTiles = mItems;
+
+    vector<pair<int, int>> locations;
+    locations.reserve(mGridTiles.size());
+    for (auto& item : mGridTiles)
+    {
+        int oX = ((double)item->GetX() + 16) / GridSpacing;
+        int oY = ((double)item->GetY() - 32) / GridSpacing;
+        locations.push_back(pair<int, int>(oX, oY));
+    }
+
+    if (mLevelWidth > 0 && mLevelHeight > 0)
+    {
+        mAdjacency.Resize(0, 0, mLevelWidth, mLevelHeight);
+    }
+    else if (!locations.empty())
     {
-        oX = ((double)item->GetX()+16) / 64;
-        oY = ((double)item->GetY()-32) / 64;
-        mAdjacency[pair<int, int>(oX, oY)] = item;
-    } 
+        int minX = locations[0].first, maxX = minX;
+        int minY = locations[0].second, maxY = minY;
+        for (auto& location : locations)
+        {
+            minX = min(minX, location.first);
+            maxX = max(maxX, location.first);
+            minY = min(minY, location.second);
+            maxY = max(maxY, location.second);
+        }
+
+        mAdjacency.Resize(minX, minY, maxX - minX + 1, maxY - minY + 1);
+    }
+    else
+    {
+        mAdjacency.Clear();
+    }
+
+    // Later items win a shared location, as they are drawn on top
+    for (size_t i = 0; i < locations.size(); i++)
+    {
+        mAdjacency.Set(locations[i].first, locations[i].second, (int)i);
+    }
 }
 
 /**
- *  Gets time since current load level
+ *  Checks the simulated time since the level started or ended
  */
 void CTowersGame::GetLevelTime()
 {
-    time_t timer;
-
-    timer = time(NULL); //gets current time
-
     if (mDrawLevelLabel)
     {
-        if (difftime(timer, mLevelStartTime) >= 2)
+        if (mGameTime - mLevelStartTime >= 2)
         {
             mCreateNewButton = true;
             mDrawLevelLabel = false;
@@ -561,23 +1233,23 @@ void CTowersGame::GetLevelTime()
 
     if (mDrawEndLabel)
     {
-        if (difftime(timer, mLevelEndTime) >= 2)
+        if (mGameTime - mLevelEndTime >= 2)
         {
             mDrawEndLabel = false;
 
             if (mCurrentLevel < 3)
             {
                 wstring levelToLoad = L"levels/level" + to_wstring(mCurrentLevel + 1) + L".xml";
-                Load(levelToLoad);
+                LoadLevel(levelToLoad);
             }
             else if (mCurrentLevel == 3)
             {
                 // Message box to restart game
-                int restart = MessageBox(NULL, L"Would you like to restart?", L"Restart", MB_YESNO | MB_ICONQUESTION);
+                bool restart = AskYesNo(L"Would you like to restart?", L"Restart");
 
-                if (restart == IDYES)
+                if (restart)
                 {
-                    Load(L"levels/level1.xml");
+                    LoadLevel(L"levels/level1.xml");
                     mGameScore = 0;
                 }
                 else
@@ -597,7 +1269,7 @@ void CTowersGame::GetLevelTime()
 void CTowersGame::LevelComplete()
 {
     // Set end time to cur time
-    mLevelEndTime = time(NULL); //gets current time
+    mLevelEndTime = mGameTime;
 
     mDrawEndLabel = true;
 
@@ -612,35 +1284,84 @@ void CTowersGame::LevelComplete()
  */
 int CTowersGame::CollisionCheck(int x, int y, int towerRadius, bool dartTower)
 {
-    int hitsOccurred = 0;
+    CProfileScope profile(CProfiler::Collision);
+    TOWERS_TRACE_SPAN("CollisionCheck");
 
-    std::vector<CTileRoad*> Roads;
-    CRoadCollector visitor;
-    for (auto item : mItems) {
-        double dX = 0, dY = 0, distance = 0;
+    // No start road, no balloons
+    if (mStartRoad == nullptr)
+    {
+        return 0;
+    }
 
-        dX = (x - double(item->GetX()));
-        dY = (y - double(item->GetY()));
+    int hitsOccurred = 0;
 
-        distance = sqrt(dX * dX + dY * dY);
-        if (distance < 200) {
-            item->Accept(&visitor);
-        }
-    
+    // Only balloons in the cells around this tower are candidates
+    double reach = towerRadius + (dartTower ? CBalloon::DartHitTolerance : CBalloon::HitTolerance);
+
+    // The arrays only grow, so once they can hold every balloon
+    // in the hash gathering into them does not allocate
+    size_t capacity = mBalloonHash.GetCount();
+    if (mHitCandidates.size() < capacity)
+    {
+        mHitCandidates.resize(capacity);
+        mHitX.resize(capacity);
+        mHitY.resize(capacity);
     }
-    Roads = visitor.GetRoads();
-    
-    CConfigureRoad visitor2;
-    for (auto item : Roads)
+
+    size_t count = mBalloonHash.Gather(x, y, reach, mHitCandidates.data(), mHitX.data(), mHitY.data());
+    if (count == 0)
     {
-        item->Accept(&visitor2);
+        return 0;
+    }
 
+    // The candidates are tested together, with the
+    // set of kernels the road moves its balloons with
+    double sector = dartTower ? CBalloon::DartHitTolerance : 0;
+    CBalloonStore::HitTest(mHitX.data(), mHitY.data(), count, x, y, reach, sector,
+        mStartRoad->GetBalloonStore().GetSimdLevelInUse(), mHits);
 
-        if (visitor2.IsRoad())
+    for (size_t word = 0; word < mHits.size(); word++)
+    {
+        uint64_t bits = mHits[word];
+        for (size_t i = word * 64; bits != 0; i++, bits >>= 1)
         {
-                hitsOccurred += visitor2.HitTestRoad(x, y, towerRadius, dartTower);
+            if ((bits & 1) == 0)
+            {
+                continue;
+            }
+
+            // Balloons popped or gone since the hash was built cannot be hit again
+            auto balloon = mHitCandidates[i];
+            if (!balloon->GetRendering() || balloon->IsBeingDeleted())
+            {
+                continue;
+            }
+
+            mStartRoad->PopBalloon(balloon);
+            hitsOccurred++;
         }
     }
 
-  return hitsOccurred;
-}
\ No newline at end of file
+    return hitsOccurred;
+}
+
+/**
+ * Rebuild the spatial hash of balloons that can still be hit
+ */
+void CTowersGame::BuildBalloonHash()
+{
+    mBalloonHash.Clear();
+
+    if (mStartRoad == nullptr)
+    {
+        return;
+    }
+
+    for (auto& balloon : mStartRoad->GetBalloons())
+    {
+        if (balloon->GetRendering() && !balloon->IsBeingDeleted())
+        {
+            mBalloonHash.Insert(balloon.get());
+        }
+    }
+}
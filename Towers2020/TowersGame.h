@@ -13,10 +13,24 @@
 #include <vector>
 #include <map>
 #include <utility>
-#include <time.h>
+#include <random>
+#include <cstdint>
 
 #include "XmlNode.h"
 #include "Item.h"
+#include "TileGrid.h"
+#include "RoadPath.h"
+#include "SpatialHash.h"
+#include "Renderer.h"
+#include "GameHost.h"
+#include "Replay.h"
+#include "EntityPool.h"
+#include "Dart.h"
+#include "Airship.h"
+#include "ItemRegistry.h"
+
+class CTileRoad;
+class CBalloon;
 
  /**
   *  Implements the actual game
@@ -38,7 +52,9 @@ public:
 
 	void MoveToFront(std::shared_ptr<CItem> item);
 
-	void OnDraw(Gdiplus::Graphics* graphics, int width, int height);
+	void OnDraw(CRenderer* graphics, int width, int height, double alpha = 0);
+
+	void DrawDynamic(CRenderer* graphics, double alpha = 0);
 
 	void Update(double elapsed);
 
@@ -48,6 +64,8 @@ public:
 
 	std::shared_ptr<CItem> GetAdjacent(CItem* item, int dx, int dy);
 
+	CItem* GetAdjacentTile(const CItem* item, int dx, int dy);
+
 	// void Save(const std::wstring& filename); Save function not required
 
 	void Load(const std::wstring& filename);
@@ -84,6 +102,32 @@ public:
 	 */
 	bool GetNewLevelItems() const { return mDrawNewLevelItems;  }
 
+	/**
+	 * Fraction of a simulation step between the last update and
+	 * the frame being drawn, used to smooth motion.
+	 * \return Fraction from 0 to 1
+	 */
+	double GetDrawAlpha() const { return mDrawAlpha; }
+
+	/**
+	 * Has the current level finished?
+	 * \return True from when the last balloon is gone until the next level loads
+	 */
+	bool IsLevelComplete() const { return mDrawEndLabel; }
+
+	/**
+	 * Simulated time since the game was created
+	 * \return Time in seconds, the sum of every update's elapsed time
+	 */
+	double GetGameTime() const { return mGameTime; }
+
+	/**
+	 * Number of times the static tiles have changed, such as by loading a level.
+	 * When it changes the whole window must be drawn again.
+	 * \return Change count
+	 */
+	long long GetTileChanges() const { return mTileChanges; }
+
 	/** 
 	 * Getter used for determining level label status
 	 * \return A boolean indicating whether level status 
@@ -116,17 +160,108 @@ public:
 
 	void GetLevelTime();
 
-	void CTowersGame::StartLevel(int difficulty);
+	void StartLevel(int difficulty);
 
 	void LevelComplete();
 
+	/**
+	 * Set the host running the game, used for messages and questions
+	 * @param host The host or nullptr if there is none
+	 */
+	void SetHost(CGameHost* host) { mHost = host; }
+
+	void ShowMessage(const std::wstring& message);
+
+	bool Grab(double x, double y);
+
+	void Drag(double x, double y);
+
+	void Drop(double x, double y);
+
+	void CancelGrab();
+
+	/**
+	 * Is the player holding an item?
+	 * \return True between a successful Grab and the following Drop or CancelGrab
+	 */
+	bool IsGrabbing() const { return mGrabbedItem != nullptr; }
+
+	void AddPalette();
+
+	void AddPaletteTower(int key);
+
+	void SetSeed(unsigned int seed);
+
+	/**
+	 * Seed the game's random numbers were last started from
+	 * \return Seed
+	 */
+	unsigned int GetSeed() const { return mSeed; }
+
+	double Random();
+
+	/**
+	 * Number of updates since the game was created
+	 * \return Simulation tick count
+	 */
+	long long GetTick() const { return mTick; }
+
+	void StartRecording(CReplay* replay);
+
+	/**
+	 * Stop recording player input
+	 */
+	void StopRecording() { mRecording = nullptr; }
+
+	/**
+	 * Get the total game score shown to the player
+	 * \return Score
+	 */
+	int GetGameScore() const { return mGameScore; }
+
 	int CollisionCheck(int x, int y, int towerRadius, bool dartTower);
 
+	/**
+	 * Get the road of the current level compiled into a single path
+	 * \return The road path, empty before the level is started
+	 */
+	const CRoadPath& GetRoadPath() const { return mRoadPath; }
+
+	/**
+	 * Get the pool towers take their darts from
+	 * \return The dart pool
+	 */
+	CEntityPool<CDart>& GetDartPool() { return mDartPool; }
+
+	/**
+	 * Get the pool towers take their airships from
+	 * \return The airship pool
+	 */
+	CEntityPool<CAirship>& GetAirshipPool() { return mAirshipPool; }
+
+	/**
+	 * Get the game's items kept by type
+	 * \return The registry of roads, towers and go buttons
+	 */
+	const CItemRegistry& GetRegistry() const { return mRegistry; }
+
+	/**
+	 * Get the road tile the balloons start from
+	 * \return The start tile, nullptr before the level is started
+	 */
+	CTileRoad* GetStartRoad() const { return mStartRoad; }
+
 	/**
 	 * Called when balloon is hit or leaves screen
 	 */
 	void DecrementBalloonCount() { mNumBalloons += -1; }
 
+	/**
+	 * Number of balloons left before the level is complete
+	 * @returns Balloon count
+	 */
+	int GetBalloonCount() const { return mNumBalloons; }
+
 	/**
 	 * Called when balloon is hit to add score
 	 * @param scoreToAdd The score from the tower
@@ -183,12 +318,30 @@ public:
 
 private:
 
+	void LoadLevel(const std::wstring& filename);
+
 	void XmlItem(const std::shared_ptr<xmlnode::CXmlNode>& node);
 
 	void XmlDeclarations(const std::shared_ptr<xmlnode::CXmlNode>& node);
 
+	void XmlTower(const std::shared_ptr<xmlnode::CXmlNode>& node);
+
+	std::shared_ptr<CItem> CreateTower(int key);
+
 	void BuildAdjacencies();
 
+	void CompileRoadPath();
+
+	void BuildBalloonHash();
+
+	bool DrawTileLayer(CRenderer* graphics);
+
+	void TilesChanged();
+
+	bool AskYesNo(const std::wstring& question, const std::wstring& title);
+
+	void Record(CReplay::Type type, double x = 0, double y = 0, const std::wstring& text = L"");
+
 	/// Variable used for getting the scale
 	double mScale = 0; 
 
@@ -216,15 +369,30 @@ private:
 	/// Total score of the game
 	int mScore = 0;
 
-	/// Used to record the current time when the level began
-	time_t mLevelStartTime = 0;
+	/// Simulated time when the level began
+	double mLevelStartTime = 0;
+
+	/// Simulated time when the level ended
+	double mLevelEndTime = 0;
+
+	/// Simulated time since the game was created
+	double mGameTime = 0;
 
-	/// Used to record the current time when the level ends
-	time_t mLevelEndTime = 0;
+	/// Fraction of a step between the last update and the frame being drawn
+	double mDrawAlpha = 0;
+
+	/// Darts fired by towers, before mItems so it outlives the towers
+	CEntityPool<CDart> mDartPool{ this };
+
+	/// Airships launched by towers, before mItems so it outlives the towers
+	CEntityPool<CAirship> mAirshipPool{ this };
 
 	/// All of the items that make up our city
 	std::vector<std::shared_ptr<CItem> > mItems;
 
+	/// The items of mItems the game looks for, kept by type
+	CItemRegistry mRegistry;
+
 	/// Used to indicate when a new GO button needs to be drawn
 	bool mCreateNewButton = false;
 
@@ -242,19 +410,94 @@ private:
 	 */
 	std::vector<std::map<std::wstring, std::wstring>> mDeclarations;
 
-	/// Adjacency lookup support
-	std::map<std::pair<int, int>, std::shared_ptr<CItem> > mAdjacency;
+	/// Adjacency lookup support, indices into mGridTiles
+	CTileGrid mAdjacency;
+
+	/// The tiles in the adjacency grid as of the last BuildAdjacencies
+	std::vector<std::shared_ptr<CItem> > mGridTiles;
+
+	/// Level width in tiles from the level file, 0 if none loaded
+	int mLevelWidth = 0;
+
+	/// Level height in tiles from the level file, 0 if none loaded
+	int mLevelHeight = 0;
 
 	/// Pointer to the TileRoad which serves as the beginning of the path
 	std::shared_ptr<CItem> mRoadStart;
 
+	/// The start tile as a road, owner of every balloon in the level
+	CTileRoad* mStartRoad = nullptr;
+
+	/// The road from the start tile compiled into a single path
+	CRoadPath mRoadPath;
+
+	/// Live balloon locations, rebuilt once per update
+	CSpatialHash mBalloonHash = CSpatialHash(GridSpacing);
+	/// Room for every balloon a collision query can gather, kept to reuse its storage
+	/// Balloons gathered by the last collision query, kept to reuse its storage
+	std::vector<CBalloon*> mHitCandidates;
+
+	/// X locations of the hit candidates, for the hit test kernels
+	std::vector<double> mHitX;
+
+	/// Y locations of the hit candidates, for the hit test kernels
+	std::vector<double> mHitY;
+
+	/// Bit for each hit candidate from the last hit test
+	std::vector<uint64_t> mHits;
+
 	/// Number of balloons on screen
 	int mNumBalloons = 30;
 
+	/// Number of balloons the current level sends
+	int mLevelBalloons = 30;
+
+	/// Simulated seconds between balloons in the current level
+	double mBalloonInterval = 0.5;
+
 	/// Width of OnDraw function
-	int mDrawWidth;
+	int mDrawWidth = 0;
 
 	/// Height of OnDraw function
-	int mDrawHeight;
+	int mDrawHeight = 0;
+
+	/// The static tiles drawn once, nullptr until drawn or after they change
+	std::unique_ptr<CRenderer::CLayer> mTileLayer;
+
+	/// Window width the tile layer was drawn for
+	int mTileLayerWidth = 0;
+
+	/// Window height the tile layer was drawn for
+	int mTileLayerHeight = 0;
+
+	/// Scale the tile layer was drawn at
+	double mTileLayerScale = 0;
+
+	/// Horizontal offset the tile layer was drawn at
+	double mTileLayerXOffset = 0;
+
+	/// Vertical offset the tile layer was drawn at
+	double mTileLayerYOffset = 0;
+
+	/// Number of times the static tiles have changed
+	long long mTileChanges = 0;
+
+	/// The host running the game, nullptr if none
+	CGameHost* mHost = nullptr;
+
+	/// Source of every random number in the game, so a seed repeats a game exactly
+	std::mt19937 mRandom;
+
+	/// Seed mRandom was last started from
+	unsigned int mSeed = std::mt19937::default_seed;
+
+	/// Number of updates since the game was created
+	long long mTick = 0;
+
+	/// Item the player is holding, nullptr if none
+	std::shared_ptr<CItem> mGrabbedItem;
+
+	/// Replay player input is recorded to, nullptr if not recording
+	CReplay* mRecording = nullptr;
 };
 
@@ -0,0 +1,201 @@
+/**
+ * \file Trace.cpp
+ *
+ * \author Morgan Mundell
+ */
+
+#include "pch.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include "Trace.h"
+#include "FileUtils.h"
+
+using namespace std;
+
+/**
+ * Get the one trace recorder
+ * @returns The recorder
+ */
+CTrace& CTrace::Instance()
+{
+    static CTrace trace;
+    return trace;
+}
+
+/**
+ * Destructor, finishes any trace being recorded
+ */
+CTrace::~CTrace()
+{
+    Stop();
+}
+
+/**
+ * Start recording events to a file, replacing anything already in it
+ * @param filename File to write
+ * @returns False if the file could not be opened
+ */
+bool CTrace::Start(const wstring& filename)
+{
+    Stop();
+
+#ifdef _WIN32
+    mFile.open(filename.c_str(), ios::binary);
+#else
+    mFile.open(WideToUtf8(filename), ios::binary);
+#endif
+    if (!mFile)
+    {
+        return false;
+    }
+
+    mFile << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    mPending.clear();
+    mWroteEvent = false;
+    mStopping = false;
+    mStart = chrono::steady_clock::now();
+    mThread = thread(&CTrace::FlushThread, this);
+    mRecording = true;
+    return true;
+}
+
+/**
+ * Stop recording and finish the file
+ */
+void CTrace::Stop()
+{
+    if (!mRecording)
+    {
+        return;
+    }
+
+    mRecording = false;
+
+    {
+        lock_guard<mutex> lock(mMutex);
+        mStopping = true;
+    }
+    mWake.notify_one();
+    mThread.join();
+
+    mFile << "\n]}\n";
+    mFile.close();
+}
+
+/**
+ * Record a span
+ * @param name Name of the span, must be a string literal
+ * @param start Start of the span in microseconds
+ * @param end End of the span in microseconds
+ */
+void CTrace::Span(const char* name, double start, double end)
+{
+    Event event;
+    event.mName = name;
+    event.mPhase = 'X';
+    event.mThread = ThreadNumber();
+    event.mTime = start;
+    event.mDuration = end - start;
+    Record(event);
+}
+
+/**
+ * Record something that happened at a moment in time
+ * @param name Name of the event, must be a string literal
+ */
+void CTrace::Instant(const char* name)
+{
+    Event event;
+    event.mName = name;
+    event.mPhase = 'i';
+    event.mThread = ThreadNumber();
+    event.mTime = Now();
+    event.mDuration = 0;
+    Record(event);
+}
+
+/**
+ * Add an event to the buffer waiting to be written
+ * @param event Event to add
+ */
+void CTrace::Record(const Event& event)
+{
+    lock_guard<mutex> lock(mMutex);
+    mPending.push_back(event);
+}
+
+/**
+ * Body of the background thread, writes whatever has been
+ * recorded every FlushInterval until recording stops.
+ */
+void CTrace::FlushThread()
+{
+    vector<Event> events;
+    bool stopping = false;
+    while (!stopping)
+    {
+        {
+            unique_lock<mutex> lock(mMutex);
+            mWake.wait_for(lock, chrono::milliseconds(FlushInterval), [this]() { return mStopping; });
+            stopping = mStopping;
+
+            // Take the whole buffer, leaving an empty one of the same size
+            events.swap(mPending);
+            mPending.reserve(events.capacity());
+        }
+
+        Write(events);
+        events.clear();
+    }
+
+    mFile.flush();
+}
+
+/**
+ * Write events to the file as JSON.
+ *
+ * The events are formatted into one block of text that is
+ * written with a single call.
+ * @param events Events to write
+ */
+void CTrace::Write(const vector<Event>& events)
+{
+    string text;
+    char line[256];
+    for (auto& event : events)
+    {
+        int length;
+        if (event.mPhase == 'X')
+        {
+            length = snprintf(line, sizeof(line),
+                "%s{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}",
+                mWroteEvent ? ",\n" : "", event.mName, event.mThread, event.mTime, event.mDuration);
+        }
+        else
+        {
+            length = snprintf(line, sizeof(line),
+                "%s{\"name\":\"%s\",\"ph\":\"i\",\"s\":\"t\",\"pid\":1,\"tid\":%d,\"ts\":%.3f}",
+                mWroteEvent ? ",\n" : "", event.mName, event.mThread, event.mTime);
+        }
+
+        if (length > 0)
+        {
+            text.append(line, min(length, (int)sizeof(line) - 1));
+            mWroteEvent = true;
+        }
+    }
+
+    mFile.write(text.data(), text.size());
+}
+
+/**
+ * Small number that identifies the calling thread in the trace
+ * @returns Thread number, 1 for the first thread to record an event
+ */
+int CTrace::ThreadNumber()
+{
+    static atomic<int> next(1);
+    thread_local int number = next++;
+    return number;
+}
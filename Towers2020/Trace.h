@@ -0,0 +1,183 @@
+/**
+ * \file Trace.h
+ *
+ * \author Morgan Mundell
+ *
+ *  Trace Event Format recording for chrome://tracing and Perfetto
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * Records timed spans and instant events to a Trace Event Format JSON file.
+ *
+ * Recording an event only copies it into a memory buffer. A
+ * background thread takes the buffer every FlushInterval, formats
+ * it and writes it out, so the file work happens off the threads
+ * being measured.
+ *
+ * The game records through the TOWERS_TRACE_SPAN and
+ * TOWERS_TRACE_INSTANT macros, which compile to nothing unless
+ * TOWERS_TRACING is defined when building.
+ */
+class CTrace
+{
+public:
+    /// How often the background thread writes buffered events in milliseconds
+    static const int FlushInterval = 100;
+
+    static CTrace& Instance();
+
+    ~CTrace();
+
+    bool Start(const std::wstring& filename);
+
+    void Stop();
+
+    /**
+     * Are events being recorded?
+     * @returns True between Start and Stop
+     */
+    bool IsRecording() const { return mRecording.load(std::memory_order_relaxed); }
+
+    /**
+     * Microseconds since recording started
+     * @returns Timestamp for an event
+     */
+    double Now() const
+    {
+        return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - mStart).count();
+    }
+
+    void Span(const char* name, double start, double end);
+
+    void Instant(const char* name);
+
+private:
+    /// Constructor, use Instance
+    CTrace() {}
+
+    /// Copy constructor (disabled)
+    CTrace(const CTrace&) = delete;
+
+    /// One recorded event
+    struct Event
+    {
+        /// Name of the event, always a string literal
+        const char* mName;
+
+        /// 'X' for a span, 'i' for an instant
+        char mPhase;
+
+        /// Thread the event happened on
+        int mThread;
+
+        /// Start time in microseconds
+        double mTime;
+
+        /// Length of a span in microseconds
+        double mDuration;
+    };
+
+    void Record(const Event& event);
+
+    void FlushThread();
+
+    void Write(const std::vector<Event>& events);
+
+    static int ThreadNumber();
+
+    /// True between Start and Stop
+    std::atomic<bool> mRecording{ false };
+
+    /// When recording started
+    std::chrono::steady_clock::time_point mStart;
+
+    /// Events waiting to be written
+    std::vector<Event> mPending;
+
+    /// Protects mPending and mStopping
+    std::mutex mMutex;
+
+    /// Wakes the flushing thread to stop
+    std::condition_variable mWake;
+
+    /// True when the flushing thread should finish up
+    bool mStopping = false;
+
+    /// Thread writing the events
+    std::thread mThread;
+
+    /// File the events are written to
+    std::ofstream mFile;
+
+    /// True once an event has been written, so the next needs a comma
+    bool mWroteEvent = false;
+};
+
+/**
+ * Records a span covering the block of code it is declared in.
+ */
+class CTraceSpan
+{
+public:
+    /**
+     * Constructor, the span starts
+     * @param name Name of the span, must be a string literal
+     */
+    CTraceSpan(const char* name) : mName(name), mRecording(CTrace::Instance().IsRecording())
+    {
+        if (mRecording)
+        {
+            mStart = CTrace::Instance().Now();
+        }
+    }
+
+    /// Destructor, the span ends
+    ~CTraceSpan()
+    {
+        if (mRecording)
+        {
+            CTrace::Instance().Span(mName, mStart, CTrace::Instance().Now());
+        }
+    }
+
+    /// Copy constructor (disabled)
+    CTraceSpan(const CTraceSpan&) = delete;
+
+private:
+    /// Name of the span
+    const char* mName;
+
+    /// True if tracing was on when the span started
+    bool mRecording;
+
+    /// When the span started in microseconds
+    double mStart = 0;
+};
+
+#ifdef TOWERS_TRACING
+/// Join two tokens after expanding them
+#define TOWERS_TRACE_JOIN(a, b) TOWERS_TRACE_JOIN2(a, b)
+/// Join two tokens
+#define TOWERS_TRACE_JOIN2(a, b) a##b
+/// Record a span covering the rest of the enclosing block
+#define TOWERS_TRACE_SPAN(name) CTraceSpan TOWERS_TRACE_JOIN(traceSpan, __LINE__)(name)
+/// Record an instant event
+#define TOWERS_TRACE_INSTANT(name) \
+    do { if (CTrace::Instance().IsRecording()) CTrace::Instance().Instant(name); } while (false)
+#else
+/// Tracing is compiled out
+#define TOWERS_TRACE_SPAN(name)
+/// Tracing is compiled out
+#define TOWERS_TRACE_INSTANT(name) do {} while (false)
+#endif
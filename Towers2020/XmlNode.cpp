@@ -2,30 +2,391 @@
  * \file
  *
  * \author Charles B. Owen
- * @brief Class that implements a wrapper for msxml nodes
+ * @brief Class that implements a portable XML document node
  *
  * \version 1.01 07-16-2014
  * \version 1.02 07-17-2014
  * \version 1.03 07-17-2014
+ * \version 1.04 Standard C++ parser replaces MSXML
  */
 
 // Ensure the file version above matches the class version
 // in XmlNode.h
 
 #include "pch.h"
+#include <sstream>
 #include "XmlNode.h"
+#include "FileUtils.h"
 
 using namespace std;
 using namespace xmlnode;
 
-CXmlNode::CXmlNode()
+/**
+ * @brief Recursive descent parser for the subset of XML our files use.
+ *
+ * Handles elements, attributes, text, comments, CDATA sections and
+ * the predefined and numeric character entities. The prolog,
+ * processing instructions and any DOCTYPE are skipped.
+ */
+class CXmlNode::Parser
+{
+public:
+    /**
+     * @brief Constructor
+     * @param text The document text
+     */
+    Parser(const wstring &text) : mText(text) {}
+
+    /**
+     * @brief Parse the document
+     * @returns The root element
+     */
+    shared_ptr<CXmlNode> ParseDocument()
+    {
+        // Byte order mark
+        if (mPos < mText.size() && mText[mPos] == 0xfeff)
+        {
+            mPos++;
+        }
+
+        shared_ptr<CXmlNode> root;
+        for (;;)
+        {
+            SkipSpace();
+            if (mPos >= mText.size())
+            {
+                break;
+            }
+
+            if (Match(L"<?"))
+            {
+                SkipPast(L"?>");
+            }
+            else if (Match(L"<!--"))
+            {
+                SkipPast(L"-->");
+            }
+            else if (Match(L"<!"))
+            {
+                SkipDoctype();
+            }
+            else if (root == nullptr && mText[mPos] == L'<')
+            {
+                root = ParseElement();
+            }
+            else
+            {
+                Fail(L"unexpected content after the root element");
+            }
+        }
+
+        if (root == nullptr)
+        {
+            throw Exception(Exception::NoRoot, L"Unable to find a root element");
+        }
+
+        return root;
+    }
+
+private:
+    /**
+     * @brief Parse an element starting at its opening angle bracket
+     * @returns The element node
+     */
+    shared_ptr<CXmlNode> ParseElement()
+    {
+        mPos++;
+        shared_ptr<CXmlNode> element(new CXmlNode(NodeType::Element, ParseName()));
+
+        // Attributes
+        for (;;)
+        {
+            SkipSpace();
+            if (Match(L"/>"))
+            {
+                return element;
+            }
+
+            if (Match(L">"))
+            {
+                break;
+            }
+
+            wstring name = ParseName();
+            SkipSpace();
+            Expect(L'=');
+            SkipSpace();
+
+            wchar_t quote = mPos < mText.size() ? mText[mPos] : 0;
+            if (quote != L'"' && quote != L'\'')
+            {
+                Fail(L"attribute value must be quoted");
+            }
+            mPos++;
+
+            size_t end = mText.find(quote, mPos);
+            if (end == wstring::npos)
+            {
+                Fail(L"unterminated attribute value");
+            }
+
+            element->mAttributes.push_back(make_pair(name, Decode(mText.substr(mPos, end - mPos))));
+            mPos = end + 1;
+        }
+
+        // Content
+        for (;;)
+        {
+            if (mPos >= mText.size())
+            {
+                Fail(L"missing end tag for " + element->mName);
+            }
+
+            if (Match(L"</"))
+            {
+                if (ParseName() != element->mName)
+                {
+                    Fail(L"mismatched end tag for " + element->mName);
+                }
+                SkipSpace();
+                Expect(L'>');
+                return element;
+            }
+            else if (Match(L"<!--"))
+            {
+                size_t start = mPos;
+                SkipPast(L"-->");
+
+                shared_ptr<CXmlNode> comment(new CXmlNode(NodeType::Comment, L"#comment"));
+                comment->mValue = mText.substr(start, mPos - 3 - start);
+                element->mChildren.push_back(comment);
+            }
+            else if (Match(L"<![CDATA["))
+            {
+                size_t start = mPos;
+                SkipPast(L"]]>");
+
+                shared_ptr<CXmlNode> text(new CXmlNode(NodeType::Text, L"#text"));
+                text->mValue = mText.substr(start, mPos - 3 - start);
+                element->mChildren.push_back(text);
+            }
+            else if (Match(L"<?"))
+            {
+                SkipPast(L"?>");
+            }
+            else if (mText[mPos] == L'<')
+            {
+                element->mChildren.push_back(ParseElement());
+            }
+            else
+            {
+                size_t end = mText.find(L'<', mPos);
+                if (end == wstring::npos)
+                {
+                    end = mText.size();
+                }
+
+                wstring raw = mText.substr(mPos, end - mPos);
+                mPos = end;
+
+                // Whitespace between tags is formatting, not content
+                if (raw.find_first_not_of(L" \t\r\n") != wstring::npos)
+                {
+                    shared_ptr<CXmlNode> text(new CXmlNode(NodeType::Text, L"#text"));
+                    text->mValue = Decode(raw);
+                    element->mChildren.push_back(text);
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Parse a tag or attribute name
+     * @returns The name
+     */
+    wstring ParseName()
+    {
+        size_t start = mPos;
+        while (mPos < mText.size())
+        {
+            wchar_t c = mText[mPos];
+            if (c == L' ' || c == L'\t' || c == L'\r' || c == L'\n' ||
+                c == L'/' || c == L'>' || c == L'=' || c == L'<')
+            {
+                break;
+            }
+            mPos++;
+        }
+
+        if (mPos == start)
+        {
+            Fail(L"expected a name");
+        }
+
+        return mText.substr(start, mPos - start);
+    }
+
+    /**
+     * @brief Replace entity and character references in text
+     * @param raw Text as it appears in the document
+     * @returns Decoded text
+     */
+    wstring Decode(const wstring &raw)
+    {
+        if (raw.find(L'&') == wstring::npos)
+        {
+            return raw;
+        }
+
+        wstring decoded;
+        for (size_t i = 0; i < raw.size(); i++)
+        {
+            size_t semi = raw[i] == L'&' ? raw.find(L';', i) : wstring::npos;
+            if (semi == wstring::npos)
+            {
+                decoded += raw[i];
+                continue;
+            }
+
+            wstring entity = raw.substr(i + 1, semi - i - 1);
+            if (entity == L"lt") decoded += L'<';
+            else if (entity == L"gt") decoded += L'>';
+            else if (entity == L"amp") decoded += L'&';
+            else if (entity == L"quot") decoded += L'"';
+            else if (entity == L"apos") decoded += L'\'';
+            else if (entity.size() > 1 && entity[0] == L'#')
+            {
+                bool hex = entity[1] == L'x' || entity[1] == L'X';
+                unsigned long code = wcstoul(entity.c_str() + (hex ? 2 : 1), nullptr, hex ? 16 : 10);
+                decoded += wchar_t(code);
+            }
+            else
+            {
+                // Unknown entity, keep it as written
+                decoded += raw.substr(i, semi - i + 1);
+            }
+
+            i = semi;
+        }
+
+        return decoded;
+    }
+
+    /**
+     * @brief Skip a DOCTYPE or other declaration, including any internal subset
+     */
+    void SkipDoctype()
+    {
+        int depth = 0;
+        while (mPos < mText.size())
+        {
+            wchar_t c = mText[mPos++];
+            if (c == L'[') depth++;
+            else if (c == L']') depth--;
+            else if (c == L'>' && depth <= 0) return;
+        }
+    }
+
+    /**
+     * @brief Skip whitespace
+     */
+    void SkipSpace()
+    {
+        while (mPos < mText.size() &&
+            (mText[mPos] == L' ' || mText[mPos] == L'\t' || mText[mPos] == L'\r' || mText[mPos] == L'\n'))
+        {
+            mPos++;
+        }
+    }
+
+    /**
+     * @brief Skip to just past a terminator
+     * @param terminator Text that ends the construct being skipped
+     */
+    void SkipPast(const wchar_t *terminator)
+    {
+        size_t end = mText.find(terminator, mPos);
+        if (end == wstring::npos)
+        {
+            Fail(wstring(L"missing ") + terminator);
+        }
+        mPos = end + wcslen(terminator);
+    }
+
+    /**
+     * @brief Consume some text if it is next in the document
+     * @param text Text to look for
+     * @returns True if the text was found and consumed
+     */
+    bool Match(const wchar_t *text)
+    {
+        size_t len = wcslen(text);
+        if (mText.compare(mPos, len, text) != 0)
+        {
+            return false;
+        }
+
+        mPos += len;
+        return true;
+    }
+
+    /**
+     * @brief Consume a character that must be next in the document
+     * @param c Expected character
+     */
+    void Expect(wchar_t c)
+    {
+        if (mPos >= mText.size() || mText[mPos] != c)
+        {
+            Fail(wstring(L"expected ") + c);
+        }
+        mPos++;
+    }
+
+    /**
+     * @brief Report a syntax error
+     * @param message Description of the error
+     */
+    void Fail(const wstring &message)
+    {
+        wstringstream str;
+        str << L"Malformed XML at offset " << mPos << L": " << message;
+        throw Exception(Exception::UnableToOpen, str.str());
+    }
+
+    /// The document text
+    const wstring &mText;
+
+    /// Current position in the text
+    size_t mPos = 0;
+};
+
+/**
+ * @brief Escape text for use in a document
+ * @param text Text to escape
+ * @param quotes True to escape quotes as well
+ * @returns Escaped text
+ */
+static wstring Escape(const wstring &text, bool quotes)
 {
+    wstring escaped;
+    for (auto c : text)
+    {
+        switch (c)
+        {
+        case L'<': escaped += L"&lt;"; break;
+        case L'>': escaped += L"&gt;"; break;
+        case L'&': escaped += L"&amp;"; break;
+        case L'"': escaped += quotes ? L"&quot;" : L"\""; break;
+        default: escaped += c; break;
+        }
+    }
+
+    return escaped;
 }
 
-CXmlNode::CXmlNode(CXmlNode *parent, IXMLDOMNode *node)
+CXmlNode::CXmlNode()
 {
-    mDocument = parent->mDocument;
-    mNode = node;
 }
 
 CXmlNode::~CXmlNode()
@@ -41,11 +402,34 @@ std::shared_ptr<CXmlNode> CXmlNode::OpenDocument(const std::wstring &filename)
 
 void CXmlNode::Open(const std::wstring &filename)
 {
-    // Open the document
-    mDocument = make_shared<Document>();
-    mDocument->Open(filename);
+    string contents;
+    if (!ReadFileContents(filename, contents))
+    {
+        wstring err(L"Unable to open file: ");
+        err += filename;
+        throw Exception(Exception::UnableToOpen, err);
+    }
+
+    shared_ptr<CXmlNode> root;
+    try
+    {
+        root = ParseDocument(contents);
+    }
+    catch (Exception &ex)
+    {
+        wstring err(ex.Type() == Exception::NoRoot ?
+            L"Unable to find a root element in file: " : L"Unable to open file: ");
+        err += filename + L" (" + ex.Message() + L")";
+        throw Exception(ex.Type(), err);
+    }
+
+    *this = *root;
+}
 
-    mNode = mDocument->GetRoot();
+std::shared_ptr<CXmlNode> CXmlNode::ParseDocument(const std::string &xml)
+{
+    wstring text = Utf8ToWide(xml);
+    return Parser(text).ParseDocument();
 }
 
 std::shared_ptr<CXmlNode> CXmlNode::CreateDocument(const std::wstring &rootname)
@@ -57,44 +441,87 @@ std::shared_ptr<CXmlNode> CXmlNode::CreateDocument(const std::wstring &rootname)
 
 void CXmlNode::Create(const std::wstring &rootname)
 {
-    // Open the document
-    mDocument = make_shared<Document>();
-    mDocument->Create(rootname);
-
-    mNode = mDocument->GetRoot();
+    mType = NodeType::Element;
+    mName = rootname;
+    mValue.clear();
+    mAttributes.clear();
+    mChildren.clear();
 }
 
 void CXmlNode::Save(const std::wstring &filename)
 {
-    mDocument->Save(filename);
+    if (!WriteFileContents(filename, WideToUtf8(GetXML())))
+    {
+        wstring err(L"Unable to write file: ");
+        err += filename;
+        throw Exception(Exception::UnableToWrite, err);
+    }
 }
 
 std::wstring CXmlNode::GetXML()
 {
-    return mDocument->GetXML();
+    wstring xml(L"<?xml version=\"1.0\" encoding=\"UTF-8\"?>\r\n");
+    WriteXML(xml);
+    xml += L"\r\n";
+    return xml;
+}
+
+/**
+ * @brief Append the XML for this node and its children
+ * @param xml String to append to
+ */
+void CXmlNode::WriteXML(std::wstring &xml) const
+{
+    switch (mType)
+    {
+    case NodeType::Text:
+        xml += Escape(mValue, false);
+        return;
+
+    case NodeType::Comment:
+        xml += L"<!--" + mValue + L"-->";
+        return;
+
+    case NodeType::Element:
+        break;
+
+    default:
+        return;
+    }
+
+    xml += L"<" + mName;
+    for (auto &attribute : mAttributes)
+    {
+        xml += L" " + attribute.first + L"=\"" + Escape(attribute.second, true) + L"\"";
+    }
+
+    if (mChildren.empty())
+    {
+        xml += L"/>";
+        return;
+    }
+
+    xml += L">";
+    for (auto &child : mChildren)
+    {
+        child->WriteXML(xml);
+    }
+    xml += L"</" + mName + L">";
 }
 
 std::wstring CXmlNode::GetName() const
 {
-    CComBSTR name;
-    mNode->get_nodeName(&name);
-    return wstring(name);
+    return mName;
 }
 
-DOMNodeType CXmlNode::GetType() const
+NodeType CXmlNode::GetType() const
 {
-    DOMNodeType t;
-    mNode->get_nodeType(&t);
-    return t;
+    return mType;
 }
 
 std::wstring CXmlNode::GetValue() const
 {
-    CComVariant value;
-    mNode->get_nodeValue(&value);
-
-    value.ChangeType(VT_BSTR);
-    return wstring(value.bstrVal);
+    return mValue;
 }
 
 int CXmlNode::GetIntValue() const
@@ -109,16 +536,17 @@ double CXmlNode::GetDoubleValue() const
 
 std::shared_ptr<CXmlNode>  CXmlNode::GetAttribute(const wstring &name)
 {
-    CComPtr<IXMLDOMNamedNodeMap> attributes;
-    mNode->get_attributes(&attributes);
-
-    CComPtr<IXMLDOMNode> attrib;
-    attributes->getNamedItem(CComBSTR(name.c_str()), &attrib);
-    if (attrib == nullptr) {
-        return shared_ptr<CXmlNode>();
+    for (auto &attribute : mAttributes)
+    {
+        if (attribute.first == name)
+        {
+            shared_ptr<CXmlNode> node(new CXmlNode(NodeType::Attribute, name));
+            node->mValue = attribute.second;
+            return node;
+        }
     }
 
-    return shared_ptr<CXmlNode>(new CXmlNode(this, attrib));
+    return shared_ptr<CXmlNode>();
 }
 
 std::wstring CXmlNode::GetAttributeValue(const std::wstring &name, const std::wstring &def)
@@ -156,62 +584,56 @@ double CXmlNode::GetAttributeDoubleValue(const std::wstring &name, double def)
 
 void CXmlNode::SetAttribute(const std::wstring &name, const std::wstring &val)
 {
-    CComPtr<IXMLDOMElement> element;
-    if (mNode.QueryInterface(&element) == S_OK)
+    if (mType != NodeType::Element)
     {
-        element->setAttribute(CComBSTR(name.c_str()), CComVariant(val.c_str()));
+        return;
     }
+
+    for (auto &attribute : mAttributes)
+    {
+        if (attribute.first == name)
+        {
+            attribute.second = val;
+            return;
+        }
+    }
+
+    mAttributes.push_back(make_pair(name, val));
 }
 
 void CXmlNode::SetAttribute(const std::wstring &name, int val)
 {
-    CComPtr<IXMLDOMElement> element;
-    if (mNode.QueryInterface(&element) == S_OK)
-    {
-        element->setAttribute(CComBSTR(name.c_str()), CComVariant(val));
-    }
+    SetAttribute(name, to_wstring(val));
 }
 
 void CXmlNode::SetAttribute(const std::wstring &name, double val)
 {
-    CComPtr<IXMLDOMElement> element;
-    if (mNode.QueryInterface(&element) == S_OK)
-    {
-        element->setAttribute(CComBSTR(name.c_str()), CComVariant(val));
-    }
+    wstringstream str;
+    str.precision(15);
+    str << val;
+    SetAttribute(name, str.str());
 }
 
 std::shared_ptr<CXmlNode> CXmlNode::AddChild(const std::wstring &name)
 {
-    // Create an XML node for the item
-    CComPtr<IXMLDOMNode> node;
-    CComPtr<IXMLDOMElement> element;
-    mDocument->GetDoc()->createElement(CComBSTR(name.c_str()), &element);
-    mNode->appendChild(element, &node);
-
-    return shared_ptr<CXmlNode>(new CXmlNode(this, node));
+    shared_ptr<CXmlNode> node(new CXmlNode(NodeType::Element, name));
+    mChildren.push_back(node);
+    return node;
 }
 
 std::shared_ptr<CXmlNode> CXmlNode::GetChild(int n)
 {
-    CComPtr<IXMLDOMNodeList> children;
-    mNode->get_childNodes(&children);
-
-    CComPtr<IXMLDOMNode> child;
-    children->get_item(n, &child);
+    if (n < 0 || n >= (int)mChildren.size())
+    {
+        return shared_ptr<CXmlNode>();
+    }
 
-    return shared_ptr<CXmlNode>(new CXmlNode(this, child));
+    return mChildren[n];
 }
 
 int CXmlNode::GetNumChildren()
 {
-    CComPtr<IXMLDOMNodeList> children;
-    mNode->get_childNodes(&children);
-
-    long len;
-    children->get_length(&len);
-
-    return (int)len;
+    return (int)mChildren.size();
 }
 
 CXmlNode::Children CXmlNode::GetChildren()
@@ -226,111 +648,15 @@ CXmlNode::Iterator CXmlNode::Children::begin()
 
 CXmlNode::Iterator CXmlNode::Children::end()
 {
-    long len;
-    mChildren->get_length(&len);
-    return Iterator(this, (int)len);
+    return Iterator(this, (int)mNode->mChildren.size());
 }
 
 CXmlNode::Children::Children(CXmlNode *node)
 {
     mNode = node;
-    node->mNode->get_childNodes(&mChildren);
 }
 
 std::shared_ptr<CXmlNode>  CXmlNode::Iterator::operator* ()
 {
-    CComPtr<IXMLDOMNode> child;
-
-    mChildren->mChildren->get_item(mPos, &child);
-
-    return shared_ptr<CXmlNode>(new CXmlNode(mChildren->mNode, child));
+    return mChildren->mNode->mChildren[mPos];
 }
-
-CXmlNode::Document::Document()
-{
-    CoInitialize(NULL);
-}
-
-CXmlNode::Document::~Document()
-{
-    CoUninitialize();
-}
-
-void CXmlNode::Document::Open(const std::wstring &filename)
-{
-    //
-    // Create an XML document
-    //
-    HRESULT hr = CoCreateInstance(CLSID_DOMDocument, NULL, CLSCTX_INPROC_SERVER,
-        IID_IXMLDOMDocument, (void**)&mDoc);
-    if (hr != S_OK)
-    {
-        wstring err(L"Failed to create an XML document to use");
-        throw Exception(Exception::UnableToCreate, err);
-    }
-
-    // Open the XML document
-    VARIANT_BOOL ok;
-    hr = mDoc->load(CComVariant(filename.c_str()), &ok);
-    if (hr != S_OK || ok == VARIANT_FALSE)
-    {
-        wstring err(L"Unable to open file: ");
-        err += filename;
-        throw Exception(Exception::UnableToOpen, err);
-    }
-
-    //
-    // Get the document root node
-    //
-    CComPtr<IXMLDOMElement> rootElement;
-    if (mDoc->get_documentElement(&rootElement) != S_OK ||
-        rootElement.QueryInterface(&mRoot) != S_OK)
-    {
-        wstring err(L"Unable to find a root element in file: ");
-        err += filename;
-        throw Exception(Exception::NoRoot, err);
-    }
-
-}
-
-void CXmlNode::Document::Create(const std::wstring &rootname)
-{
-    HRESULT hr = CoCreateInstance(CLSID_DOMDocument, NULL,
-        CLSCTX_INPROC_SERVER, IID_IXMLDOMDocument, (void**)&mDoc);
-    if (hr != S_OK)
-    {
-        wstring err(L"Failed to create an XML document to use");
-        throw Exception(Exception::UnableToCreate, err);
-    }
-
-    // Create a processing instruction targeted for xml.
-    // This creates the line:  <?xml version='1.0'>
-    CComPtr<IXMLDOMProcessingInstruction> pi;
-    CComPtr<IXMLDOMNode> pinode;
-    mDoc->createProcessingInstruction(L"xml", L"version='1.0' encoding='UTF-8'", &pi);
-    mDoc->appendChild(pi, &pinode);
-
-    // Create the root element
-    CComPtr<IXMLDOMElement> pe;
-    mDoc->createElement(CComBSTR(rootname.c_str()), &pe);
-    mDoc->appendChild(pe, &mRoot);
-}
-
-void CXmlNode::Document::Save(const std::wstring &filename)
-{
-    HRESULT hr = mDoc->save(CComVariant(filename.c_str()));
-    if (hr != S_OK)
-    {
-        wstring err(L"Unable to write file: ");
-        err += filename;
-        throw Exception(Exception::UnableToWrite, err);
-    }
-}
-
-std::wstring CXmlNode::Document::GetXML()
-{
-    CComBSTR xml;
-    mDoc->get_xml(&xml);
-    return wstring(xml);
-}
-
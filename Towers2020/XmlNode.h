@@ -3,25 +3,41 @@
  *
  * \author Charles B. Owen
  *
- * @brief Class that implements a wrapper for msxml nodes. 
+ * @brief Class that implements a portable XML document node. 
  */
 #pragma once
 
-#include <MsXml6.h>
 #include <memory>
 #include <string>
+#include <vector>
+#include <utility>
 #include <exception>
 
 namespace xmlnode
 {
-
     /**
-     * @brief A wrapper for msxml nodes.
+     * @brief Types of node in an XML document
+     */
+    enum class NodeType
+    {
+        /// Not a valid node
+        Invalid,
+        /// An XML tag
+        Element,
+        /// An attribute of a tag
+        Attribute,
+        /// Text between tags
+        Text,
+        /// A comment
+        Comment
+    };
 
-     * MSXML was designed to be used by a variety of languages,
-     * including C++, C#, and Visual Basic. Consequently, it is
-     * a compromise that is very cumbersome to use. This class
-     * is designed to simplify the process considerably.
+    /**
+     * @brief A node of an XML document.
+     *
+     * Earlier versions wrapped MSXML, which tied every program that
+     * loads XML to Windows. This version parses and writes documents
+     * with standard C++ only, behind the same interface.
      *
      * All an XML document is a tree of nodes. This class
      * represents nodes in that tree and the root node represents
@@ -31,6 +47,7 @@ namespace xmlnode
      * \version 1.01 07-16-2014 Initial development 
      * \version 1.02 07-17-2014 Namespace, added GetXML, added tests
      * \version 1.03 07-17-2014 Exceptions
+     * \version 1.04 Standard C++ parser replaces MSXML
      */
     class CXmlNode
     {
@@ -71,9 +88,19 @@ namespace xmlnode
         /** 
         * @brief Open a file as an XML document.
         * @param filename Filename to open
+        * @throws CXmlNode::Exception If the file cannot be read or parsed
         */
         void Open(const std::wstring &filename);
 
+        /**
+        * @brief Parse XML text and return the document root node.
+        *
+        * @param xml UTF-8 XML text
+        * @returns Document root node
+        * @throws CXmlNode::Exception If the text cannot be parsed
+        */
+        static std::shared_ptr<CXmlNode> ParseDocument(const std::string &xml);
+
         /**
         * @brief Create an empty XML document in this node.
         * @param rootname The name for the root node.
@@ -106,28 +133,13 @@ namespace xmlnode
         /**
         * @brief The node type
         * 
-        * The possible node types are:
-        * - NODE_INVALID
-        * - NODE_ELEMENT
-        * - NODE_ATTRIBUTE
-        * - NODE_TEXT
-        * - NODE_CDATA_SECTION
-        * - NODE_ENTITY_REFERENCE
-        * - NODE_ENTITY
-        * - NODE_PROCESSING_INSTRUCTION
-        * - NODE_COMMENT
-        * - NODE_DOCUMENT
-        * - NODE_DOCUMENT_TYPE
-        * - NODE_DOCUMENT_FRAGMENT
-        * - NODE_NOTATION
-        *
         * The types that are usually important are:
-        * - NODE_ELEMENT the XML tags
-        * - NODE_TEXT text between tags
+        * - NodeType::Element the XML tags
+        * - NodeType::Text text between tags
         * 
         * @returns The node type
         */
-        DOMNodeType GetType() const;
+        NodeType GetType() const;
 
         /**
         * @brief Get the node value
@@ -169,8 +181,8 @@ namespace xmlnode
          * This returns a CXmlNode object that is the attribute.
          * You an then use the GetValue function to get the value of the attribute.
          * 
-         * Calls to this function create a CXmlNode object as a wrapper for
-         * the underlying attribute. Subsequent calls for the same attribute
+         * Calls to this function create a CXmlNode object holding a copy of
+         * the attribute. Subsequent calls for the same attribute
          * will return a different object.
          *
          * @param name Attribute name
@@ -325,9 +337,6 @@ namespace xmlnode
 
             /// Node we are children of
             CXmlNode *mNode;       
-
-            /// Node list of children
-            CComPtr<IXMLDOMNodeList> mChildren; 
         };
 
         /**
@@ -366,7 +375,7 @@ namespace xmlnode
              * @param other Object to copy 
              * @returns Reference to this object
              */
-            Exception& operator= (const Exception &other) { mMsg = other.mMsg; mType = other.mType; }
+            Exception& operator= (const Exception &other) { mMsg = other.mMsg; mType = other.mType; return *this; }
             
             /** 
              * @brief Constructor
@@ -394,13 +403,13 @@ namespace xmlnode
              * @brief Exception message
              * @returns Exception message 
              */
-            std::wstring Message() { return mMsg; }
+            std::wstring Message() const { return mMsg; }
 
             /** 
              * @brief Exception type
              * @returns Exception type of type CXmlNode::Exception::Types 
              */
-            Types Type() { return mType; }
+            Types Type() const { return mType; }
 
         private:
             /// Exception type
@@ -445,82 +454,31 @@ namespace xmlnode
         std::shared_ptr<CXmlNode> AddChild(const std::wstring &name);
 
     private:
-        /** 
+        /**
          * @brief Constructor (private, used internally only)
-         * @param parent The parent of this node
-         * @param node The underlying msxml node
+         * @param type The node type
+         * @param name The node name
          */
-        CXmlNode(CXmlNode *parent, IXMLDOMNode *node);
+        CXmlNode(NodeType type, const std::wstring &name) : mType(type), mName(name) {}
 
-        /// @brief Nested class for an object that describes one XML document
-        class Document
-        {
-        public:
-            /**
-             * @brief Constructor
-             */
-            Document();
+        class Parser;
 
-            /**
-             * @brief Destructor
-             */
-            ~Document();
+        void WriteXML(std::wstring &xml) const;
 
+        /// The node type
+        NodeType mType = NodeType::Invalid;
 
-            /** 
-             * @brief Open the document
-             * @param filename File to open
-             * @throws CXmlNode::Exception If there are errors loading document
-             */
-            void Open(const std::wstring &filename);
-
-            /** 
-             * @brief Create a new, empty document.
-             * @param rootname The name for the document root node.
-             * @throws CXmlNode::Exception If there are errors creating the document
-             */
-            void Create(const std::wstring &rootname);
-
-            /**
-             * @brief Save the document to a file.
-             * @param filename Filename to save as.
-             * @throws CXmlNode::Exception If there are errors in saving
-             */
-            void Save(const std::wstring &filename);
-
-            /**
-             * @brief Returns the document as a string.
-             * @returns XML data as a string
-             */
-            std::wstring GetXML();
-
-            /** 
-             * @brief Get pointer to the root node
-             * @returns Pointer to root node 
-             */
-            IXMLDOMNode *GetRoot() { return mRoot; }
-
-            /** 
-             * @brief Get pointer to underlying document
-             * @returns Pointer to underlying document 
-             */
-            IXMLDOMDocument *GetDoc() { return mDoc; }
-
-        private:
-            /// Underlying msxml document
-            CComPtr<IXMLDOMDocument>  mDoc; 
-
-            /// Document root node
-            CComPtr<IXMLDOMNode> mRoot;     
-        };
+        /// Node name, #text or #comment for text and comment nodes
+        std::wstring mName;
 
-        // The open document
+        /// Node value for text, comment and attribute nodes
+        std::wstring mValue;
 
-        /// Reference to the document
-        std::shared_ptr<Document> mDocument;    
+        /// Attribute names and values in document order
+        std::vector<std::pair<std::wstring, std::wstring>> mAttributes;
 
-        /// msxml node
-        CComPtr<IXMLDOMNode> mNode;             
+        /// Child nodes in document order
+        std::vector<std::shared_ptr<CXmlNode>> mChildren;
     };
 
 }
@@ -8,7 +8,14 @@
 #define PCH_H
 
 // add headers that you want to pre-compile here
+#ifdef _WIN32
 #include "framework.h"
 #include <gdiplus.h>
 #pragma comment(lib, "gdiplus.lib")
+#else
+// The game core builds without Windows on other platforms
+#include <memory>
+#include <string>
+#include <vector>
+#endif
 #endif //PCH_H
@@ -22,13 +22,18 @@
 #define ID_HOWTOUSETOWER_AIRSHIPTOWER   32781
 #define ID_HOWTO_HOWTOPLAY32782         32782
 #define ID_HOWTOUSETOWER_TOWER9         32783
+#define ID_SPEED_NORMAL                 32784
+#define ID_SPEED_2X                     32785
+#define ID_SPEED_10X                    32786
+#define ID_SPEED_MAX                    32787
+#define ID_VIEW_PROFILER                32788
 
 // Next default values for new objects
 // 
 #ifdef APSTUDIO_INVOKED
 #ifndef APSTUDIO_READONLY_SYMBOLS
 #define _APS_NEXT_RESOURCE_VALUE        310
-#define _APS_NEXT_COMMAND_VALUE         32784
+#define _APS_NEXT_COMMAND_VALUE         32789
 #define _APS_NEXT_CONTROL_VALUE         1000
 #define _APS_NEXT_SYMED_VALUE           310
 #endif